@@ -25,6 +25,7 @@
 #include "clang/AST/RawCommentList.h"
 #include "clang/AST/TemplateName.h"
 #include "clang/AST/Type.h"
+#include "clang/AST/TypeOrdering.h"
 #include "clang/Basic/AddressSpaces.h"
 #include "clang/Basic/IdentifierTable.h"
 #include "clang/Basic/LangOptions.h"
@@ -35,6 +36,7 @@
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/Support/Allocator.h"
 #include <memory>
@@ -90,12 +92,20 @@ class ASTContext : public RefCountedBase<ASTContext> {
 
   mutable SmallVector<Type *, 0> Types;
   mutable llvm::FoldingSet<ExtQuals> ExtQualNodes;
-  mutable llvm::FoldingSet<ComplexType> ComplexTypes;
-  mutable llvm::FoldingSet<PointerType> PointerTypes;
-  mutable llvm::FoldingSet<AdjustedType> AdjustedTypes;
-  mutable llvm::FoldingSet<BlockPointerType> BlockPointerTypes;
-  mutable llvm::FoldingSet<LValueReferenceType> LValueReferenceTypes;
-  mutable llvm::FoldingSet<RValueReferenceType> RValueReferenceTypes;
+
+  // Types that are fully determined by one or two other types are uniqued
+  // through tables keyed on those types, which is much cheaper than building
+  // a FoldingSetNodeID for every lookup.
+  mutable llvm::DenseMap<QualType, ComplexType *> ComplexTypes;
+  mutable llvm::DenseMap<QualType, PointerType *> PointerTypes;
+  mutable llvm::DenseMap<std::pair<QualType, QualType>, AdjustedType *>
+    AdjustedTypes;
+  mutable llvm::DenseMap<QualType, BlockPointerType *> BlockPointerTypes;
+  /// \brief LValue reference types, indexed by whether they were spelled as
+  /// lvalue references.
+  mutable llvm::DenseMap<QualType, LValueReferenceType *>
+    LValueReferenceTypes[2];
+  mutable llvm::DenseMap<QualType, RValueReferenceType *> RValueReferenceTypes;
   mutable llvm::FoldingSet<MemberPointerType> MemberPointerTypes;
   mutable llvm::FoldingSet<ConstantArrayType> ConstantArrayTypes;
   mutable llvm::FoldingSet<IncompleteArrayType> IncompleteArrayTypes;
@@ -116,7 +126,7 @@ class ASTContext : public RefCountedBase<ASTContext> {
     SubstTemplateTypeParmPackTypes;
   mutable llvm::ContextualFoldingSet<TemplateSpecializationType, ASTContext&>
     TemplateSpecializationTypes;
-  mutable llvm::FoldingSet<ParenType> ParenTypes;
+  mutable llvm::DenseMap<QualType, ParenType *> ParenTypes;
   mutable llvm::FoldingSet<ElaboratedType> ElaboratedTypes;
   mutable llvm::FoldingSet<DependentNameType> DependentNameTypes;
   mutable llvm::ContextualFoldingSet<DependentTemplateSpecializationType,
@@ -126,7 +136,7 @@ class ASTContext : public RefCountedBase<ASTContext> {
   mutable llvm::FoldingSet<ObjCObjectTypeImpl> ObjCObjectTypes;
   mutable llvm::FoldingSet<ObjCObjectPointerType> ObjCObjectPointerTypes;
   mutable llvm::FoldingSet<AutoType> AutoTypes;
-  mutable llvm::FoldingSet<AtomicType> AtomicTypes;
+  mutable llvm::DenseMap<QualType, AtomicType *> AtomicTypes;
   llvm::FoldingSet<AttributedType> AttributedTypes;
 
   mutable llvm::FoldingSet<QualifiedTemplateName> QualifiedTemplateNames;
@@ -179,6 +189,30 @@ class ASTContext : public RefCountedBase<ASTContext> {
   llvm::DenseMap<const MaterializeTemporaryExpr*, APValue>
     MaterializedTemporaryValues;
 
+  /// \brief Results of constexpr function calls memoized by the constant
+  /// evaluator, keyed by an encoding of the callee and its argument values.
+  llvm::StringMap<APValue> ConstexprCallResults;
+
+  /// \brief The number of constexpr calls whose result was found in
+  /// ConstexprCallResults.
+  unsigned NumConstexprCallResultHits;
+
+  /// \brief The number of bytes allocated for declarations, including their
+  /// trailing storage.
+  mutable size_t DeclAllocatedBytes;
+
+  /// \brief Memory of statements released by discardFunctionBody, kept as
+  /// singly-linked free lists keyed by the size of the nodes, for reuse by
+  /// AllocateStmt.
+  mutable llvm::DenseMap<size_t, void *> RecycledStmts;
+
+  /// \brief Statistics about discardFunctionBody and the reuse of the
+  /// statements it released.
+  unsigned NumDiscardedFunctionBodies;
+  unsigned NumRecycledStmts;
+  size_t RecycledStmtBytes;
+  mutable unsigned NumReusedStmts;
+
   /// \brief Representation of a "canonical" template template parameter that
   /// is used in canonical template names.
   class CanonicalTemplateTemplateParm : public llvm::FoldingSetNode {
@@ -416,6 +450,7 @@ private:
   friend class ASTReader;
   friend class ASTWriter;
   friend class CXXRecordDecl;
+  friend class Decl;
 
   const TargetInfo *Target;
   clang::PrintingPolicy PrintingPolicy;
@@ -428,6 +463,10 @@ public:
   IntrusiveRefCntPtr<ExternalASTSource> ExternalSource;
   ASTMutationListener *Listener;
 
+  /// \brief The source of the function bodies whose parsing was deferred,
+  /// if any. Not owned.
+  LazyFunctionBodySource *LazyBodySource;
+
   /// \brief Contains parents of a node.
   typedef llvm::SmallVector<ast_type_traits::DynTypedNode, 2> ParentVector;
 
@@ -486,12 +525,38 @@ public:
     return BumpAlloc.Allocate(Size, Align);
   }
   void Deallocate(void *Ptr) const { }
+
+  /// \brief Allocate memory for a statement, reusing the memory of a
+  /// statement released by discardFunctionBody when one of the same size is
+  /// available.
+  void *AllocateStmt(size_t Size, unsigned Align = 8) const;
+
+  /// \brief Replace the body of \p FD with an empty compound statement and
+  /// make the memory of its statements available to later statements.
+  ///
+  /// The caller guarantees that nothing needs the body any more; in
+  /// particular, it has been emitted and will not be inlined, evaluated as a
+  /// constant or instantiated. Returns false, leaving the body alone, if it
+  /// contains nodes that can be referenced from outside it: lambdas, blocks,
+  /// local classes, temporaries with static storage duration and variably
+  /// modified types.
+  bool discardFunctionBody(FunctionDecl *FD);
   
   /// Return the total amount of physical memory allocated for representing
   /// AST nodes and type information.
   size_t getASTAllocatedMemory() const {
     return BumpAlloc.getTotalMemory();
   }
+  /// Return the number of bytes handed out for AST nodes and type
+  /// information, excluding allocator slack.
+  size_t getASTAllocatedBytes() const {
+    return BumpAlloc.getBytesAllocated();
+  }
+  /// Return the number of bytes handed out for declarations.
+  size_t getDeclAllocatedBytes() const { return DeclAllocatedBytes; }
+  /// Return the number of bytes handed out for types, not counting any
+  /// storage allocated after the type node itself.
+  size_t getTypeAllocatedBytes() const;
   /// Return the total memory used for various side tables.
   size_t getSideTableAllocatedMemory() const;
   
@@ -827,6 +892,16 @@ public:
     return ExternalSource.get();
   }
 
+  /// \brief Attach the source of the function bodies whose parsing was
+  /// deferred, which FunctionDecl::getBody uses to parse them.
+  void setLazyFunctionBodySource(LazyFunctionBodySource *Source) {
+    LazyBodySource = Source;
+  }
+
+  LazyFunctionBodySource *getLazyFunctionBodySource() const {
+    return LazyBodySource;
+  }
+
   /// \brief Attach an AST mutation listener to the AST context.
   ///
   /// The AST mutation listener provides the ability to track modifications to
@@ -2204,6 +2279,11 @@ public:
   APValue *getMaterializedTemporaryValue(const MaterializeTemporaryExpr *E,
                                          bool MayCreate);
 
+  /// \brief Get the storage for the memoized result of the constexpr call
+  /// identified by \p Key, or null if there is no such result and
+  /// \p MayCreate is false.
+  APValue *getConstexprCallResult(StringRef Key, bool MayCreate);
+
   //===--------------------------------------------------------------------===//
   //                    Statistics
   //===--------------------------------------------------------------------===//
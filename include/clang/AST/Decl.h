@@ -1469,6 +1469,10 @@ private:
   /// skipped.
   unsigned HasSkippedBody : 1;
 
+  /// \brief Indicates if the body of the function is still to be parsed by
+  /// the ASTContext's LazyFunctionBodySource.
+  unsigned HasLazyBody : 1;
+
   /// \brief End part of this FunctionDecl's source range.
   ///
   /// We could compute the full range in getSourceRange(). However, when we're
@@ -1554,7 +1558,7 @@ protected:
       IsDefaulted(false), IsExplicitlyDefaulted(false),
       HasImplicitReturnZero(false), IsLateTemplateParsed(false),
       IsConstexpr(isConstexprSpecified), HasSkippedBody(false),
-      EndRangeLoc(NameInfo.getEndLoc()),
+      HasLazyBody(false), EndRangeLoc(NameInfo.getEndLoc()),
       TemplateOrSpecialization(),
       DNLoc(NameInfo.getInfo()) {}
 
@@ -1663,14 +1667,14 @@ public:
   /// that this returns false for a defaulted function unless that function
   /// has been implicitly defined (possibly as deleted).
   bool isThisDeclarationADefinition() const {
-    return IsDeleted || Body || IsLateTemplateParsed;
+    return IsDeleted || Body || IsLateTemplateParsed || HasLazyBody;
   }
 
   /// doesThisDeclarationHaveABody - Returns whether this specific
   /// declaration of the function has a body - that is, if it is a non-
   /// deleted definition.
   bool doesThisDeclarationHaveABody() const {
-    return Body || IsLateTemplateParsed;
+    return Body || IsLateTemplateParsed || HasLazyBody;
   }
 
   void setBody(Stmt *B);
@@ -1828,6 +1832,11 @@ public:
   bool hasSkippedBody() const { return HasSkippedBody; }
   void setHasSkippedBody(bool Skipped = true) { HasSkippedBody = Skipped; }
 
+  /// \brief True if the body of this definition is still to be parsed, which
+  /// getBody does through the ASTContext's LazyFunctionBodySource.
+  bool hasLazyBody() const { return HasLazyBody; }
+  void setHasLazyBody(bool Lazy = true) { HasLazyBody = Lazy; }
+
   void setPreviousDeclaration(FunctionDecl * PrevDecl);
 
   virtual const FunctionDecl *getCanonicalDecl() const;
@@ -25,6 +25,7 @@ class CXXBaseSpecifier;
 class DeclarationName;
 class ExternalSemaSource; // layering violation required for downcasting
 class FieldDecl;
+class FunctionDecl;
 class Module;
 class NamedDecl;
 class RecordDecl;
@@ -301,6 +302,23 @@ protected:
   uint32_t incrementGeneration(ASTContext &C);
 };
 
+/// \brief Abstract interface for a source of function bodies whose parsing
+/// was deferred until they are needed.
+///
+/// A function whose body is held by such a source (see
+/// FunctionDecl::hasLazyBody) is defined and has a body; the body is parsed
+/// by the first call to FunctionDecl::getBody.
+class LazyFunctionBodySource {
+public:
+  virtual ~LazyFunctionBodySource();
+
+  /// \brief Parse the body of the given function and attach it to the
+  /// function.
+  ///
+  /// \returns the body, or null if it could not be parsed.
+  virtual Stmt *ParseFunctionBody(FunctionDecl *FD) = 0;
+};
+
 /// \brief A lazy pointer to an AST node (of base type T) that resides
 /// within an external AST source.
 ///
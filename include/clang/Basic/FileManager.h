@@ -235,15 +235,23 @@ public:
   /// \brief Retrieve a file entry for a "virtual" file that acts as
   /// if there were a file with the given name on disk.
   ///
-  /// The file itself is not accessed.
+  /// The file itself is not accessed. Unless \p StatFile is false, the file
+  /// is looked up on disk so that the virtual file shares its entry with the
+  /// real file of the same name.
   const FileEntry *getVirtualFile(StringRef Filename, off_t Size,
-                                  time_t ModificationTime);
+                                  time_t ModificationTime,
+                                  bool StatFile = true);
 
   /// \brief Open the specified file as a MemoryBuffer, returning a new
   /// MemoryBuffer if successful, otherwise returning null.
+  ///
+  /// If \p RequiresNullTerminator is false, the buffer is not guaranteed to
+  /// be null-terminated, which allows it to be memory-mapped regardless of
+  /// the file size.
   std::unique_ptr<llvm::MemoryBuffer>
   getBufferForFile(const FileEntry *Entry, std::string *ErrorStr = nullptr,
-                   bool isVolatile = false, bool ShouldCloseOpenFile = true);
+                   bool isVolatile = false, bool ShouldCloseOpenFile = true,
+                   bool RequiresNullTerminator = true);
   std::unique_ptr<llvm::MemoryBuffer>
   getBufferForFile(StringRef Filename, std::string *ErrorStr = nullptr);
 
@@ -0,0 +1,128 @@
+//===--- TimeTrace.h - Chrome trace of a compilation ------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Defines the TimeTraceProfiler, which records where the wall time of
+/// a compilation goes, in the Chrome trace event format (-ftime-trace).
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_BASIC_TIMETRACE_H
+#define LLVM_CLANG_BASIC_TIMETRACE_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/DataTypes.h"
+#include "llvm/Support/TimeValue.h"
+#include <string>
+#include <vector>
+
+namespace clang {
+
+/// \brief Records the nested phases of a compilation and the source files
+/// entered by the preprocessor, and writes them as a Chrome trace, which can
+/// be viewed in chrome://tracing.
+///
+/// The phases are recorded on the main thread only; those which take less
+/// than the granularity of the profiler are dropped.
+class TimeTraceProfiler {
+public:
+  /// \param Granularity The minimum duration, in microseconds, of the
+  /// recorded events.
+  explicit TimeTraceProfiler(unsigned Granularity);
+
+  /// \brief Note the start of the phase \p Name of the compilation.
+  ///
+  /// \param Detail What the phase works on, e.g. the name of a declaration.
+  void begin(StringRef Name, StringRef Detail = StringRef());
+
+  /// \brief Note the end of the most recently started phase.
+  void end();
+
+  /// \brief Set what the most recently started phase works on.
+  void setDetail(StringRef Detail);
+
+  /// \brief Note that the preprocessor entered the source file \p FileName.
+  ///
+  /// The source files are recorded apart from the phases, since their
+  /// inclusion does not nest with the parsing of the declarations.
+  void enterFile(StringRef FileName);
+
+  /// \brief Note that the preprocessor left the most recently entered
+  /// source file.
+  void exitFile();
+
+  /// \brief End the phases and the source files still in progress, and write
+  /// the trace to \p OS.
+  void write(raw_ostream &OS);
+
+  /// \brief Retrieve the profiler of the current compilation, or null if the
+  /// compilation is not traced.
+  static TimeTraceProfiler *getCurrent() { return Current; }
+
+  /// \brief Set the profiler of the current compilation.
+  static void setCurrent(TimeTraceProfiler *Profiler) { Current = Profiler; }
+
+private:
+  struct Event {
+    std::string Name;
+    std::string Detail;
+    uint64_t Start;
+    uint64_t Duration;
+    /// \brief The row of the trace the event is shown in.
+    unsigned Lane;
+  };
+
+  uint64_t getElapsedMicroseconds() const;
+  void finish(SmallVectorImpl<Event> &Stack);
+
+  static TimeTraceProfiler *Current;
+
+  llvm::sys::TimeValue StartTime;
+  unsigned Granularity;
+  SmallVector<Event, 16> Phases;
+  SmallVector<Event, 16> Files;
+  std::vector<Event> Events;
+};
+
+/// \brief RAII object recording a phase of the compilation in the current
+/// TimeTraceProfiler, if any.
+class TimeTraceScope {
+  TimeTraceProfiler *Profiler;
+
+  TimeTraceScope(const TimeTraceScope &) LLVM_DELETED_FUNCTION;
+  void operator=(const TimeTraceScope &) LLVM_DELETED_FUNCTION;
+
+public:
+  explicit TimeTraceScope(StringRef Name, StringRef Detail = StringRef())
+      : Profiler(TimeTraceProfiler::getCurrent()) {
+    if (Profiler)
+      Profiler->begin(Name, Detail);
+  }
+
+  ~TimeTraceScope() {
+    if (Profiler)
+      Profiler->end();
+  }
+
+  /// \brief Whether the phase is recorded. Callers test this before
+  /// computing an expensive detail.
+  bool isEnabled() const { return Profiler != nullptr; }
+
+  void setDetail(StringRef Detail) {
+    if (Profiler)
+      Profiler->setDetail(Detail);
+  }
+};
+
+} // end namespace clang
+
+#endif
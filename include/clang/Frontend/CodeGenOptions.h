@@ -122,6 +122,10 @@ public:
   /// The name of the bitcode file to link before optzns.
   std::string LinkBitcodeFile;
 
+  /// The linker used for the relocatable link of the objects of parallel code
+  /// generation, or empty to look for 'ld' in the path.
+  std::string ParallelCodeGenLinker;
+
   /// The user provided name for the "main file", if non-empty. This is useful
   /// in situations where the input file name does not match the original input
   /// file, for example with -save-temps.
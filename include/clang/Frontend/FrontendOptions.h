@@ -126,6 +126,11 @@ public:
                                            /// metrics and statistics.
   unsigned ShowTimers : 1;                 ///< Show timers for individual
                                            /// actions.
+  unsigned ShowTemplateInstantiationProfile : 1; ///< Show the time and
+                                           /// memory spent instantiating each
+                                           /// template.
+  unsigned ShowMemoryReport : 1;           ///< Show the memory used by each
+                                           /// part of the frontend.
   unsigned ShowVersion : 1;                ///< Show the -version text.
   unsigned FixWhatYouCan : 1;              ///< Apply fixes even if there are
                                            /// unfixable errors.
@@ -138,6 +143,9 @@ public:
                                            /// speed up parsing in cases you do
                                            /// not need them (e.g. with code
                                            /// completion).
+  unsigned LazyFunctionBodies : 1;         ///< Keep the tokens of skipped
+                                           /// function bodies so that they
+                                           /// can be parsed on demand.
   unsigned UseGlobalModuleIndex : 1;       ///< Whether we can use the
                                            ///< global module index if available.
   unsigned GenerateGlobalModuleIndex : 1;  ///< Whether we can generate the
@@ -240,17 +248,28 @@ public:
   /// \brief File name of the file that will provide record layouts
   /// (in the format produced by -fdump-record-layouts).
   std::string OverrideRecordLayoutsFile;
-  
+
+  /// \brief File to write the Chrome trace of the compilation to
+  /// (-ftime-trace), or empty if the compilation is not traced.
+  std::string TimeTraceFile;
+
+  /// \brief The minimum duration, in microseconds, of the events written to
+  /// TimeTraceFile.
+  unsigned TimeTraceGranularity;
+
 public:
   FrontendOptions() :
     DisableFree(false), RelocatablePCH(false), ShowHelp(false),
-    ShowStats(false), ShowTimers(false), ShowVersion(false),
+    ShowStats(false), ShowTimers(false),
+    ShowTemplateInstantiationProfile(false), ShowMemoryReport(false),
+    ShowVersion(false),
     FixWhatYouCan(false), FixOnlyWarnings(false), FixAndRecompile(false),
     FixToTemporaries(false), ARCMTMigrateEmitARCErrors(false),
-    SkipFunctionBodies(false), UseGlobalModuleIndex(true),
+    SkipFunctionBodies(false), LazyFunctionBodies(false),
+    UseGlobalModuleIndex(true),
     GenerateGlobalModuleIndex(true), ASTDumpDecls(false), ASTDumpLookups(false),
     ARCMTAction(ARCMT_None), ObjCMTAction(ObjCMT_None),
-    ProgramAction(frontend::ParseSyntaxOnly)
+    ProgramAction(frontend::ParseSyntaxOnly), TimeTraceGranularity(500)
   {}
 
   /// getInputKindForExtension - Return the appropriate input kind for a file
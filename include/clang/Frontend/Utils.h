@@ -159,6 +159,10 @@ void AttachHeaderIncludeGen(Preprocessor &PP, bool ShowAllHeaders = false,
                             StringRef OutputPath = "",
                             bool ShowDepth = true, bool MSStyle = false);
 
+/// AttachTimeTraceCallbacks - Record the time spent in each source file
+/// entered by the given preprocessor in the current TimeTraceProfiler.
+void AttachTimeTraceCallbacks(Preprocessor &PP);
+
 /// CacheTokens - Cache tokens for use with PCH. Note that this requires
 /// a seekable stream.
 void CacheTokens(Preprocessor &PP, llvm::raw_fd_ostream* OS);
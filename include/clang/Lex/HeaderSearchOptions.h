@@ -119,6 +119,15 @@ public:
   /// regenerated often.
   unsigned ModuleCachePruneAfter;
 
+  /// \brief The maximum total size (in bytes) of the module files in the
+  /// module cache, or zero if the size is unlimited.
+  ///
+  /// Independently of the pruning interval, whenever the module files exceed
+  /// this size, the least recently used module files are removed until the
+  /// cache fits within the limit again. To make this possible, the access time
+  /// of each module file is refreshed whenever it is loaded.
+  uint64_t ModuleCacheSizeLimit;
+
   /// \brief The time in seconds when the build session started.
   ///
   /// This time is used by other optimizations in header search and module
@@ -158,17 +167,26 @@ public:
   /// \brief Whether to validate system input files when a module is loaded.
   unsigned ModulesValidateSystemHeaders : 1;
 
+  /// \brief Whether to embed the contents of every input file in the module
+  /// files we build.
+  ///
+  /// The embedded contents are authoritative: when such a module file is
+  /// loaded, its input files are neither validated against nor read from the
+  /// file system.
+  unsigned ModulesEmbedAllFiles : 1;
+
 public:
   HeaderSearchOptions(StringRef _Sysroot = "/")
     : Sysroot(_Sysroot), DisableModuleHash(0), ModuleMaps(0),
       ModuleCachePruneInterval(7*24*60*60),
       ModuleCachePruneAfter(31*24*60*60),
+      ModuleCacheSizeLimit(0),
       BuildSessionTimestamp(0),
       UseBuiltinIncludes(true),
       UseStandardSystemIncludes(true), UseStandardCXXIncludes(true),
       UseLibcxx(false), Verbose(false),
       ModulesValidateOncePerBuildSession(false),
-      ModulesValidateSystemHeaders(false) {}
+      ModulesValidateSystemHeaders(false), ModulesEmbedAllFiles(false) {}
 
   /// AddPath - Add the \p Path path to the specified \p Group list.
   void AddPath(StringRef Path, frontend::IncludeDirGroup Group,
@@ -61,6 +61,11 @@ public:
   /// \brief Headers that will be converted to chained PCHs in memory.
   std::vector<std::string> ChainedIncludes;
 
+  /// \brief Directory in which the PCHs built for \c ChainedIncludes are
+  /// cached, so that translation units sharing the same include prefix can
+  /// reuse them instead of parsing the headers again.
+  std::string ChainedIncludesCachePath;
+
   /// \brief When true, disables most of the normal validation performed on
   /// precompiled headers.
   bool DisablePCHValidation;
@@ -68,6 +73,11 @@ public:
   /// \brief When true, a PCH with compiler errors will not be rejected.
   bool AllowPCHWithCompilerErrors;
 
+  /// \brief When true, the contents of buffers embedded in a PCH or module
+  /// file are stored compressed, and only decompressed when the buffer is
+  /// first needed.
+  bool CompressASTFileBuffers;
+
   /// \brief Dump declarations that are deserialized from PCH, for testing.
   bool DumpDeserializedPCHDecls;
 
@@ -143,6 +153,7 @@ public:
   PreprocessorOptions() : UsePredefines(true), DetailedRecord(false),
                           DisablePCHValidation(false),
                           AllowPCHWithCompilerErrors(false),
+                          CompressASTFileBuffers(false),
                           DumpDeserializedPCHDecls(false),
                           PrecompiledPreambleBytes(0, true),
                           RemappedFilesKeepOriginalName(true),
@@ -174,6 +185,7 @@ public:
     Includes.clear();
     MacroIncludes.clear();
     ChainedIncludes.clear();
+    ChainedIncludesCachePath.clear();
     DumpDeserializedPCHDecls = false;
     ImplicitPCHInclude.clear();
     ImplicitPTHInclude.clear();
@@ -41,8 +41,13 @@ namespace clang {
 
   /// \brief Parse the main file known to the preprocessor, producing an 
   /// abstract syntax tree.
+  ///
+  /// \param LazyFunctionBodies If given along with \p SkipFunctionBodies,
+  /// the tokens of skipped bodies are kept so that the consumer can parse
+  /// them on demand with Sema::ParseLazyFunctionBody.
   void ParseAST(Sema &S, bool PrintStats = false,
-                bool SkipFunctionBodies = false);
+                bool SkipFunctionBodies = false,
+                bool LazyFunctionBodies = false);
   
 }  // end namespace clang
 
@@ -234,10 +234,20 @@ class Parser : public CodeCompletionHandler {
 
   bool SkipFunctionBodies;
 
+  /// \brief Whether skipped function bodies should be kept as tokens, so
+  /// that they can be parsed on demand.
+  bool LazyFunctionBodies;
+
 public:
-  Parser(Preprocessor &PP, Sema &Actions, bool SkipFunctionBodies);
+  Parser(Preprocessor &PP, Sema &Actions, bool SkipFunctionBodies,
+         bool LazyFunctionBodies = false);
   ~Parser();
 
+  /// \brief Destroy a parser that Sema kept, with
+  /// Sema::TakeLazyFunctionBodyParser, to parse lazily-skipped function
+  /// bodies after the end of the translation unit.
+  static void DeleteLazyFunctionBodyParser(void *P);
+
   const LangOptions &getLangOpts() const { return PP.getLangOpts(); }
   const TargetInfo &getTargetInfo() const { return PP.getTargetInfo(); }
   Preprocessor &getPreprocessor() const { return PP; }
@@ -1163,6 +1173,10 @@ private:
 
   static void LateTemplateParserCallback(void *P, LateParsedTemplate &LPT);
 
+  void ParseLazyFunctionBody(LateParsedTemplate &LPT);
+  static void LazyFunctionBodyParserCallback(void *P,
+                                             LateParsedTemplate &LPT);
+
   Sema::ParsingClassState
   PushParsingClass(Decl *TagOrTemplate, bool TopLevelClass, bool IsInterface);
   void DeallocateParsedClasses(ParsingClass *Class);
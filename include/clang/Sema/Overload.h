@@ -693,6 +693,62 @@ namespace clang {
     }
   };
 
+  /// \brief A pool of allocators for the conversion sequences of overload
+  /// candidate sets that outgrow their inline storage.
+  ///
+  /// Candidate sets are short-lived, so instead of each of them allocating
+  /// and freeing slabs of its own, they borrow an allocator owned by Sema and
+  /// hand it back, reset, when they are done with it. A reset allocator keeps
+  /// its first slab, so the next set that borrows it does not allocate.
+  class OverloadCandidateAllocatorPool {
+    SmallVector<llvm::BumpPtrAllocator *, 4> FreeAllocators;
+
+    /// \brief The number of allocators created by this pool.
+    unsigned NumAllocatorsCreated;
+
+    /// \brief The number of times an allocator was borrowed.
+    unsigned NumAllocatorsBorrowed;
+
+    /// \brief The number of overload resolutions performed.
+    unsigned NumResolutions;
+
+    /// \brief The number of candidates considered by overload resolution.
+    unsigned NumCandidates;
+
+    OverloadCandidateAllocatorPool(const OverloadCandidateAllocatorPool &)
+        LLVM_DELETED_FUNCTION;
+    void operator=(const OverloadCandidateAllocatorPool &)
+        LLVM_DELETED_FUNCTION;
+
+  public:
+    OverloadCandidateAllocatorPool()
+      : NumAllocatorsCreated(0), NumAllocatorsBorrowed(0), NumResolutions(0),
+        NumCandidates(0) {}
+    ~OverloadCandidateAllocatorPool();
+
+    /// \brief Borrow an allocator from the pool.
+    llvm::BumpPtrAllocator *borrow();
+
+    /// \brief Reset \p Allocator and return it to the pool.
+    void giveBack(llvm::BumpPtrAllocator *Allocator) {
+      Allocator->Reset();
+      FreeAllocators.push_back(Allocator);
+    }
+
+    /// \brief Note that overload resolution picked among \p Candidates
+    /// candidates.
+    void noteResolution(unsigned Candidates) {
+      ++NumResolutions;
+      NumCandidates += Candidates;
+    }
+
+    /// \brief Return the amount of memory held by the allocators currently
+    /// in the pool.
+    size_t getTotalMemory() const;
+
+    void PrintStats() const;
+  };
+
   /// OverloadCandidateSet - A set of overload candidates, used in C++
   /// overload resolution (C++ 13.3).
   class OverloadCandidateSet {
@@ -711,9 +767,11 @@ namespace clang {
     SmallVector<OverloadCandidate, 16> Candidates;
     llvm::SmallPtrSet<Decl *, 16> Functions;
 
-    // Allocator for OverloadCandidate::Conversions. We store the first few
-    // elements inline to avoid allocation for small sets.
-    llvm::BumpPtrAllocator ConversionSequenceAllocator;
+    // Allocator for OverloadCandidate::Conversions, borrowed from Sema's
+    // pool when first needed. We store the first few elements inline to avoid
+    // allocation for small sets.
+    OverloadCandidateAllocatorPool *AllocatorPool;
+    llvm::BumpPtrAllocator *ConversionSequenceAllocator;
 
     SourceLocation Loc;
     CandidateSetKind Kind;
@@ -728,9 +786,12 @@ namespace clang {
     void destroyCandidates();
 
   public:
-    OverloadCandidateSet(SourceLocation Loc, CandidateSetKind CSK)
-        : Loc(Loc), Kind(CSK), NumInlineSequences(0) {}
-    ~OverloadCandidateSet() { destroyCandidates(); }
+    OverloadCandidateSet(Sema &S, SourceLocation Loc, CandidateSetKind CSK);
+    ~OverloadCandidateSet() {
+      destroyCandidates();
+      if (ConversionSequenceAllocator)
+        AllocatorPool->giveBack(ConversionSequenceAllocator);
+    }
 
     SourceLocation getLocation() const { return Loc; }
     CandidateSetKind getKind() const { return Kind; }
@@ -765,9 +826,13 @@ namespace clang {
         C.Conversions = &I[NumInlineSequences];
         NumInlineSequences += NumConversions;
       } else {
-        // Otherwise get memory from the allocator.
-        C.Conversions = ConversionSequenceAllocator
-                          .Allocate<ImplicitConversionSequence>(NumConversions);
+        // Otherwise get memory from the allocator, borrowing one first if
+        // necessary.
+        if (!ConversionSequenceAllocator)
+          ConversionSequenceAllocator = AllocatorPool->borrow();
+        C.Conversions =
+            ConversionSequenceAllocator->Allocate<ImplicitConversionSequence>(
+                NumConversions);
       }
 
       // Construct the new objects.
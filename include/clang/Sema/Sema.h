@@ -144,6 +144,7 @@ namespace clang {
   class ObjCProtocolDecl;
   class OMPThreadPrivateDecl;
   class OMPClause;
+  class OverloadCandidateAllocatorPool;
   class OverloadCandidateSet;
   class OverloadExpr;
   class ParenListExpr;
@@ -196,6 +197,7 @@ namespace sema {
   class LambdaScopeInfo;
   class PossiblyUnreachableDiag;
   class TemplateDeductionInfo;
+  class TemplateInstantiationProfiler;
 }
 
 // FIXME: No way to easily map from TemplateTypeParmTypes to
@@ -488,6 +490,37 @@ public:
     OpaqueParser = P;
   }
 
+  /// \brief The tokens of function bodies that were skipped in lazy-body
+  /// mode, which can be parsed on demand by ParseLazyFunctionBody.
+  LateParsedTemplateMapT LazyFunctionBodies;
+
+  /// \brief Callback to the parser to parse lazily-skipped function bodies.
+  LateTemplateParserCB *LazyFunctionBodyParser;
+  void *OpaqueLazyFunctionBodyParser;
+
+  /// \brief Callback that destroys OpaqueLazyFunctionBodyParser, if Sema
+  /// took ownership of the parser with TakeLazyFunctionBodyParser.
+  typedef void LazyFunctionBodyParserDeleterCB(void *P);
+  LazyFunctionBodyParserDeleterCB *LazyFunctionBodyParserDeleter;
+
+  /// \brief The source through which FunctionDecl::getBody parses the
+  /// lazily-skipped function bodies; registered with the ASTContext while
+  /// the parser is available.
+  std::unique_ptr<LazyFunctionBodySource> LazyBodySource;
+
+  /// \brief Whether the end-of-translation-unit diagnostics about unused
+  /// declarations wait for the remaining lazily-skipped function bodies.
+  bool DeferredUnusedDeclDiagnostics;
+
+  void SetLazyFunctionBodyParser(LateTemplateParserCB *LBP, void *P);
+
+  /// \brief Keep the parser registered with SetLazyFunctionBodyParser alive
+  /// until Sema is destroyed, so that the remaining lazily-skipped function
+  /// bodies can still be parsed once parsing is over.
+  void TakeLazyFunctionBodyParser(LazyFunctionBodyParserDeleterCB *Deleter) {
+    LazyFunctionBodyParserDeleter = Deleter;
+  }
+
   class DelayedDiagnostics;
 
   class DelayedDiagnosticsState {
@@ -865,6 +898,10 @@ public:
   /// \brief The number of SFINAE diagnostics that have been trapped.
   unsigned NumSFINAEErrors;
 
+  /// \brief The allocators lent to overload candidate sets for their
+  /// conversion sequences.
+  std::unique_ptr<OverloadCandidateAllocatorPool> OverloadCandidateAllocators;
+
   typedef llvm::DenseMap<ParmVarDecl *, llvm::TinyPtrVector<ParmVarDecl *>>
     UnparsedDefaultArgInstantiationsMap;
 
@@ -980,6 +1017,10 @@ public:
 
   void PrintStats() const;
 
+  /// \brief Return the amount of memory used by Sema's own allocators and
+  /// indices.
+  size_t getTotalMemory() const;
+
   /// \brief Helper class that creates diagnostics with optional
   /// template instantiation stacks.
   ///
@@ -1056,6 +1097,10 @@ public:
 
   void ActOnEndOfTranslationUnit();
 
+  /// \brief Emit the end-of-translation-unit warnings about unused
+  /// declarations, once no lazily-skipped function body can use them anymore.
+  void DiagnoseUnusedDeclsAtEndOfTranslationUnit();
+
   void CheckDelegatingCtorCycles();
 
   Scope *getScopeForContext(DeclContext *Ctx);
@@ -1703,6 +1748,29 @@ public:
   Decl *ActOnFinishFunctionBody(Decl *Decl, Stmt *Body);
   Decl *ActOnFinishFunctionBody(Decl *Decl, Stmt *Body, bool IsInstantiation);
   Decl *ActOnSkippedFunctionBody(Decl *Decl);
+
+  /// \brief Determine whether the body of the given function can be skipped
+  /// and kept as tokens to be parsed later, on demand.
+  bool canParseFunctionBodyLazily(Decl *D);
+
+  /// \brief Skip the body of the given function, keeping its tokens \p Toks
+  /// so that ParseLazyFunctionBody can parse it later.
+  Decl *ActOnLazyFunctionBody(Decl *D, CachedTokens &Toks);
+
+  /// \brief Parse the body of a function that was skipped in lazy-body mode.
+  ///
+  /// This is normally reached through FunctionDecl::getBody. It cannot be
+  /// used in the middle of parsing something else. Once the end of the
+  /// translation unit has been reached, the work it did for the other bodies
+  /// (instantiations, vtables, unused declarations) is done for this one too.
+  ///
+  /// \returns true if the body was parsed.
+  bool ParseLazyFunctionBody(FunctionDecl *FD);
+
+  /// \brief Re-enter the scope of a function whose body was skipped in
+  /// lazy-body mode, to parse that body. Unlike ActOnStartOfFunctionDef, it
+  /// does not check the definition again.
+  Decl *ActOnReenterLazyFunctionBody(Scope *FnBodyScope, Decl *D);
   void ActOnFinishInlineMethodDef(CXXMethodDecl *D);
 
   /// ActOnFinishDelayedAttribute - Invoked when we have finished parsing an
@@ -6258,6 +6326,10 @@ public:
   SmallVector<ActiveTemplateInstantiation, 16>
     ActiveTemplateInstantiations;
 
+  /// \brief Records the time and memory spent in each template
+  /// instantiation, if a template instantiation profile was requested.
+  std::unique_ptr<sema::TemplateInstantiationProfiler> InstantiationProfiler;
+
   /// \brief Extra modules inspected when performing a lookup during a template
   /// instantiation. Computed lazily.
   SmallVector<Module*, 16> ActiveTemplateInstantiationLookupModules;
@@ -6542,6 +6614,9 @@ public:
   /// \brief The number of typos corrected by CorrectTypo.
   unsigned TyposCorrected;
 
+  /// \brief The identifiers considered by unqualified typo correction.
+  TypoCorrectionNameIndex TypoCorrectionNames;
+
   typedef llvm::DenseMap<IdentifierInfo *, TypoCorrection>
     UnqualifiedTyposCorrectedMap;
 
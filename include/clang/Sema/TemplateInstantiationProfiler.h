@@ -0,0 +1,104 @@
+//===--- TemplateInstantiationProfiler.h - Instantiation costs --*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines TemplateInstantiationProfiler, a worker object used by
+// Sema that attributes the time and AST memory spent instantiating templates
+// to the entities being instantiated.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CLANG_SEMA_TEMPLATEINSTANTIATIONPROFILER_H
+#define LLVM_CLANG_SEMA_TEMPLATEINSTANTIATIONPROFILER_H
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/DataTypes.h"
+#include "llvm/Support/TimeValue.h"
+
+namespace clang {
+
+class ASTContext;
+class Decl;
+
+namespace sema {
+
+/// \brief Records the cost of each template instantiation performed by Sema.
+///
+/// Every instantiation of a class, function, variable or enumeration is
+/// charged with the wall time and the \c ASTContext bytes allocated between
+/// its start and its end, including the cost of the instantiations it
+/// triggers. The report additionally aggregates these costs over the
+/// template each entity was instantiated from.
+class TemplateInstantiationProfiler {
+public:
+  /// \brief The accumulated cost of instantiating a single entity.
+  struct Cost {
+    Cost()
+      : Instantiations(0), NestedInstantiations(0), Seconds(0.0),
+        SelfSeconds(0.0), Bytes(0), SelfBytes(0) {}
+
+    /// \brief The number of times the entity was instantiated.
+    unsigned Instantiations;
+
+    /// \brief The number of instantiations triggered while instantiating the
+    /// entity.
+    unsigned NestedInstantiations;
+
+    /// \brief Wall time spent instantiating the entity, including nested
+    /// instantiations.
+    double Seconds;
+
+    /// \brief Wall time spent instantiating the entity, excluding nested
+    /// instantiations.
+    double SelfSeconds;
+
+    /// \brief \c ASTContext bytes allocated while instantiating the entity,
+    /// including nested instantiations.
+    uint64_t Bytes;
+
+    /// \brief \c ASTContext bytes allocated while instantiating the entity,
+    /// excluding nested instantiations.
+    uint64_t SelfBytes;
+  };
+
+  explicit TemplateInstantiationProfiler(ASTContext &Context)
+    : Context(Context), NumInstantiations(0) {}
+
+  /// \brief Note that Sema started instantiating \p Entity.
+  void startInstantiation(const Decl *Entity);
+
+  /// \brief Note that Sema finished the most recently started instantiation.
+  void finishInstantiation();
+
+  /// \brief Print the recorded costs, most expensive first.
+  ///
+  /// \param MaxEntries The maximum number of entities to print in each
+  /// section of the report, or zero to print all of them.
+  void printReport(raw_ostream &OS, unsigned MaxEntries = 50) const;
+
+private:
+  struct ActiveInstantiation {
+    const Decl *Entity;
+    llvm::sys::TimeValue Start;
+    double NestedSeconds;
+    uint64_t StartBytes;
+    uint64_t NestedBytes;
+    unsigned StartInstantiations;
+  };
+
+  ASTContext &Context;
+  SmallVector<ActiveInstantiation, 16> Stack;
+  llvm::DenseMap<const Decl *, Cost> Costs;
+  unsigned NumInstantiations;
+};
+
+} // end namespace sema
+} // end namespace clang
+
+#endif
@@ -18,6 +18,8 @@
 #include "clang/AST/DeclCXX.h"
 #include "clang/Sema/DeclSpec.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Allocator.h"
+#include <vector>
 
 namespace clang {
 
@@ -336,6 +338,51 @@ public:
   }
 };
 
+/// \brief Index of the identifiers that unqualified typo correction
+/// considers as candidates, bucketed by length.
+///
+/// A name is only an acceptable correction if its length is within about a
+/// third of the typo's length, so the buckets let typo correction skip most
+/// identifiers of a large translation unit. The identifiers of the external
+/// source are enumerated once per generation of that source instead of once
+/// per typo, and the local identifiers are only indexed again when the
+/// identifier table grew.
+class TypoCorrectionNameIndex {
+public:
+  TypoCorrectionNameIndex()
+    : NumLocalIdentifiers(0), ExternalGeneration(0),
+      HasExternalNames(false) {}
+
+  /// \brief Bring the index up to date with \p Idents and with the
+  /// identifiers of its external lookup, whose contents are identified by
+  /// \p Generation.
+  void update(IdentifierTable &Idents, uint32_t Generation);
+
+  /// \brief Retrieve the indexed names whose length is \p Length.
+  ///
+  /// Names known both locally and externally may be returned twice.
+  void getNames(unsigned Length, SmallVectorImpl<ArrayRef<StringRef> > &Names)
+      const;
+
+  /// \brief Return the amount of memory used by the index.
+  size_t getTotalMemory() const;
+
+private:
+  typedef SmallVector<std::vector<StringRef>, 32> NameBuckets;
+
+  static void addName(NameBuckets &Buckets, StringRef Name);
+
+  NameBuckets LocalNames;
+  NameBuckets ExternalNames;
+  unsigned NumLocalIdentifiers;
+  uint32_t ExternalGeneration;
+  bool HasExternalNames;
+
+  /// \brief Storage for the external names, which the external identifier
+  /// iterator does not guarantee to keep alive.
+  llvm::BumpPtrAllocator ExternalNameStorage;
+};
+
 }
 
 #endif
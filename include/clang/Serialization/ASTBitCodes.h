@@ -295,7 +295,10 @@ namespace clang {
     /// inside the control block.
     enum InputFileRecordTypes {
       /// \brief An input file.
-      INPUT_FILE = 1
+      INPUT_FILE = 1,
+      /// \brief The contents of the input file described by the INPUT_FILE
+      /// record that directly precedes it, embedded in the AST file.
+      INPUT_FILE_CONTENTS = 2
     };
 
     /// \brief Record types that occur within the AST block itself.
@@ -566,7 +569,11 @@ namespace clang {
       SM_SLOC_BUFFER_BLOB = 3,
       /// \brief Describes a source location entry (SLocEntry) for a
       /// macro expansion.
-      SM_SLOC_EXPANSION_ENTRY = 4
+      SM_SLOC_EXPANSION_ENTRY = 4,
+      /// \brief Describes a zlib-compressed blob that contains the data for
+      /// a buffer entry, along with its uncompressed size. This record can
+      /// appear anywhere a SM_SLOC_BUFFER_BLOB record can.
+      SM_SLOC_BUFFER_BLOB_COMPRESSED = 5
     };
 
     /// \brief Record types used within a preprocessor block.
@@ -1095,6 +1095,10 @@ private:
   InputFileInfo readInputFileInfo(ModuleFile &F, unsigned ID);
   /// \brief A convenience method to read the filename from an input file.
   std::string getInputFileName(ModuleFile &F, unsigned ID);
+  /// \brief Reads the contents of an input file that were embedded in the
+  /// AST file, or returns null if they were not embedded.
+  std::unique_ptr<llvm::MemoryBuffer>
+  readInputFileContents(ModuleFile &F, unsigned ID, StringRef Name);
 
   /// \brief Retrieve the file entry and 'overridden' bit for an input
   /// file in the given module file.
@@ -1130,6 +1134,9 @@ private:
   ASTReadResult ReadASTBlock(ModuleFile &F, unsigned ClientLoadCapabilities);
   bool ParseLineTable(ModuleFile &F, SmallVectorImpl<uint64_t> &Record);
   bool ReadSourceManagerBlock(ModuleFile &F);
+  std::unique_ptr<llvm::MemoryBuffer>
+  ReadSLocBufferBlob(llvm::BitstreamCursor &SLocEntryCursor, StringRef Name,
+                     bool Copy = false);
   llvm::BitstreamCursor &SLocCursorForID(int ID);
   SourceLocation getImportLocation(ModuleFile *F);
   ASTReadResult ReadModuleMapFileBlock(RecordData &Record, ModuleFile &F,
@@ -8,9 +8,10 @@
 //===----------------------------------------------------------------------===//
 //
 // This file defines the GlobalModuleIndex class, which manages a global index
-// containing all of the identifiers known to the various modules within a given
-// subdirectory of the module cache. It is used to improve the performance of
-// queries such as "do any modules know about this identifier?"
+// containing all of the identifiers, selectors and declaration names known to
+// the various modules within a given subdirectory of the module cache. It is
+// used to improve the performance of queries such as "do any modules know
+// about this identifier?"
 //
 //===----------------------------------------------------------------------===//
 #ifndef LLVM_CLANG_SERIALIZATION_GLOBALMODULEINDEX_H
@@ -31,10 +32,12 @@ class MemoryBuffer;
 
 namespace clang {
 
+class DeclarationName;
 class DirectoryEntry;
 class FileEntry;
 class FileManager;
 class IdentifierIterator;
+class Selector;
 
 namespace serialization {
   class ModuleFile;
@@ -68,6 +71,18 @@ class GlobalModuleIndex {
   /// GlobalModuleIndex.
   void *IdentifierIndex;
 
+  /// \brief The selector hash table.
+  ///
+  /// This pointer actually points to a HashIndexTable object, but that
+  /// type is only accessible within the implementation of GlobalModuleIndex.
+  void *SelectorIndex;
+
+  /// \brief The hash table of the names in declaration context lookup tables.
+  ///
+  /// This pointer actually points to a HashIndexTable object, but that type
+  /// is only accessible within the implementation of GlobalModuleIndex.
+  void *DeclNameIndex;
+
   /// \brief Information about a given module file.
   struct ModuleInfo {
     ModuleInfo() : File(), Size(), ModTime() { }
@@ -113,6 +128,35 @@ class GlobalModuleIndex {
   /// \brief The number of identifier lookup hits, where we recognize the
   /// identifier.
   unsigned NumIdentifierLookupHits;
+
+  /// \brief The number of selector lookups we performed.
+  unsigned NumSelectorLookups;
+
+  /// \brief The number of selector lookup hits, where we recognize the
+  /// selector.
+  unsigned NumSelectorLookupHits;
+
+  /// \brief The number of times a loaded module file was left out of the
+  /// hits of a selector lookup.
+  unsigned NumSelectorModuleFilesSkipped;
+
+  /// \brief The number of declaration name lookups we performed.
+  unsigned NumDeclNameLookups;
+
+  /// \brief The number of declaration name lookup hits, where we recognize
+  /// the name.
+  unsigned NumDeclNameLookupHits;
+
+  /// \brief The number of times a loaded module file was left out of the
+  /// hits of a declaration name lookup.
+  unsigned NumDeclNameModuleFilesSkipped;
+
+  /// \brief Look for \p Hash in the hash-keyed index \p Index, populating
+  /// \p Hits with the loaded module files it maps to.
+  ///
+  /// \returns true if the hash is in the index.
+  bool lookupHash(void *Index, unsigned Hash,
+                  llvm::SmallPtrSetImpl<ModuleFile *> &Hits);
   
   /// \brief Internal constructor. Use \c readIndex() to read an index.
   explicit GlobalModuleIndex(std::unique_ptr<llvm::MemoryBuffer> Buffer,
@@ -177,6 +221,36 @@ public:
   /// \returns true if the identifier is known to the index, false otherwise.
   bool lookupIdentifier(StringRef Name, HitSet &Hits);
 
+  /// \brief Look for all of the module files with methods in their global
+  /// method pool for the given selector.
+  ///
+  /// The selector index is keyed on the selector's hash, so the resulting set
+  /// may contain module files that merely have a selector with the same hash;
+  /// it never omits a module file that knows about \p Sel.
+  ///
+  /// \param Sel The selector to look for.
+  ///
+  /// \param Hits Will be populated with the set of module files that have
+  /// information about this selector.
+  ///
+  /// \returns true if the selector is known to the index, false otherwise.
+  bool lookupSelector(Selector Sel, HitSet &Hits);
+
+  /// \brief Look for all of the module files with a declaration context
+  /// lookup table that contains the given name.
+  ///
+  /// Like the selector index, the name index is keyed on a hash of the
+  /// spelling of the name, so the resulting set may contain module files that
+  /// merely have a name with the same hash.
+  ///
+  /// \param Name The declaration name to look for.
+  ///
+  /// \param Hits Will be populated with the set of module files that may
+  /// have declarations with this name.
+  ///
+  /// \returns true if the name index was available, false otherwise.
+  bool lookupDeclName(DeclarationName Name, HitSet &Hits);
+
   /// \brief Note that the given module file has been loaded.
   ///
   /// \returns false if the global module index has information about this
@@ -729,7 +729,9 @@ ASTContext::ASTContext(LangOptions& LOpts, SourceManager &SM,
     TemplateSpecializationTypes(this_()),
     DependentTemplateSpecializationTypes(this_()),
     SubstTemplateTemplateParmPacks(this_()),
-    GlobalNestedNameSpecifier(nullptr),
+    GlobalNestedNameSpecifier(nullptr), NumConstexprCallResultHits(0),
+    DeclAllocatedBytes(0), NumDiscardedFunctionBodies(0),
+    NumRecycledStmts(0), RecycledStmtBytes(0), NumReusedStmts(0),
     Int128Decl(nullptr), UInt128Decl(nullptr), Float128StubDecl(nullptr),
     BuiltinVaListDecl(nullptr),
     ObjCIdDecl(nullptr), ObjCSelDecl(nullptr), ObjCClassDecl(nullptr),
@@ -746,7 +748,7 @@ ASTContext::ASTContext(LangOptions& LOpts, SourceManager &SM,
     Idents(idents), Selectors(sels),
     BuiltinInfo(builtins),
     DeclarationNames(*this),
-    ExternalSource(nullptr), Listener(nullptr),
+    ExternalSource(nullptr), Listener(nullptr), LazyBodySource(nullptr),
     Comments(SM), CommentsLoaded(false),
     CommentCommandTraits(BumpAlloc, LOpts.CommentOpts),
     LastSDM(nullptr, 0)
@@ -862,6 +864,15 @@ void ASTContext::PrintStats() const {
   llvm::errs() << NumImplicitDestructorsDeclared << "/"
                << NumImplicitDestructors
                << " implicit destructors created\n";
+  if (getLangOpts().CPlusPlus11)
+    llvm::errs() << ConstexprCallResults.size()
+                 << " memoized constexpr call results, "
+                 << NumConstexprCallResultHits << " reused\n";
+  if (NumDiscardedFunctionBodies)
+    llvm::errs() << NumDiscardedFunctionBodies
+                 << " function bodies discarded, " << NumRecycledStmts
+                 << " statements (" << RecycledStmtBytes << " bytes) recycled, "
+                 << NumReusedStmts << " reused\n";
 
   if (ExternalSource) {
     llvm::errs() << "\n";
@@ -871,6 +882,176 @@ void ASTContext::PrintStats() const {
   BumpAlloc.PrintStats();
 }
 
+size_t ASTContext::getTypeAllocatedBytes() const {
+  size_t Bytes = 0;
+  for (unsigned I = 0, N = Types.size(); I != N; ++I) {
+    switch (Types[I]->getTypeClass()) {
+#define TYPE(Name, Parent) \
+    case Type::Name: Bytes += sizeof(Name##Type); break;
+#define ABSTRACT_TYPE(Name, Parent)
+#include "clang/AST/TypeNodes.def"
+    }
+  }
+  return Bytes;
+}
+
+void *ASTContext::AllocateStmt(size_t Size, unsigned Align) const {
+  if (!RecycledStmts.empty()) {
+    llvm::DenseMap<size_t, void *>::iterator Known = RecycledStmts.find(Size);
+    if (Known != RecycledStmts.end() && Known->second &&
+        reinterpret_cast<uintptr_t>(Known->second) % Align == 0) {
+      void *Mem = Known->second;
+      Known->second = *static_cast<void **>(Mem);
+      ++NumReusedStmts;
+      return Mem;
+    }
+  }
+  return Allocate(Size, Align);
+}
+
+/// \brief Return the number of bytes occupied by \p S if they can be reused
+/// for another statement, or 0 if they cannot.
+///
+/// Only classes that are allocated without trailing storage, or whose
+/// trailing storage is known from the node itself, are reused. These make up
+/// the bulk of a typical function body.
+static size_t getRecyclableStmtSize(const Stmt *S) {
+  switch (S->getStmtClass()) {
+#define RECYCLABLE(CLASS) case Stmt::CLASS##Class: return sizeof(CLASS);
+  RECYCLABLE(ArraySubscriptExpr)
+  RECYCLABLE(BinaryOperator)
+  RECYCLABLE(BreakStmt)
+  RECYCLABLE(CXXBoolLiteralExpr)
+  RECYCLABLE(CXXMemberCallExpr)
+  RECYCLABLE(CXXOperatorCallExpr)
+  RECYCLABLE(CallExpr)
+  RECYCLABLE(CaseStmt)
+  RECYCLABLE(CharacterLiteral)
+  RECYCLABLE(CompoundAssignOperator)
+  RECYCLABLE(CompoundStmt)
+  RECYCLABLE(ConditionalOperator)
+  RECYCLABLE(ContinueStmt)
+  RECYCLABLE(DeclStmt)
+  RECYCLABLE(DefaultStmt)
+  RECYCLABLE(DoStmt)
+  RECYCLABLE(FloatingLiteral)
+  RECYCLABLE(ForStmt)
+  RECYCLABLE(GotoStmt)
+  RECYCLABLE(IfStmt)
+  RECYCLABLE(IntegerLiteral)
+  RECYCLABLE(LabelStmt)
+  RECYCLABLE(NullStmt)
+  RECYCLABLE(ParenExpr)
+  RECYCLABLE(ReturnStmt)
+  RECYCLABLE(SwitchStmt)
+  RECYCLABLE(UnaryExprOrTypeTraitExpr)
+  RECYCLABLE(UnaryOperator)
+  RECYCLABLE(WhileStmt)
+#undef RECYCLABLE
+  case Stmt::ImplicitCastExprClass:
+    return sizeof(ImplicitCastExpr) +
+           cast<ImplicitCastExpr>(S)->path_size() * sizeof(CXXBaseSpecifier *);
+  case Stmt::CStyleCastExprClass:
+    return sizeof(CStyleCastExpr) +
+           cast<CStyleCastExpr>(S)->path_size() * sizeof(CXXBaseSpecifier *);
+  default:
+    return 0;
+  }
+}
+
+/// \brief Determine whether \p S may be referenced from outside the function
+/// body that contains it, or may share memory with something that is.
+static bool mayEscapeFunctionBody(const Stmt *S) {
+  if (isa<LambdaExpr>(S) || isa<BlockExpr>(S))
+    return true;
+
+  // Lifetime-extended temporaries of static locals are emitted as globals
+  // and their values are cached by address.
+  if (const MaterializeTemporaryExpr *MTE =
+          dyn_cast<MaterializeTemporaryExpr>(S))
+    return MTE->getStorageDuration() == SD_Static;
+
+  // The size expressions of variable length arrays are owned by their types.
+  if (const UnaryExprOrTypeTraitExpr *UE =
+          dyn_cast<UnaryExprOrTypeTraitExpr>(S))
+    if (UE->isArgumentType() &&
+        UE->getArgumentType()->isVariablyModifiedType())
+      return true;
+  if (const Expr *E = dyn_cast<Expr>(S))
+    return E->getType()->isVariablyModifiedType();
+  if (const DeclStmt *DS = dyn_cast<DeclStmt>(S)) {
+    for (DeclStmt::const_decl_iterator I = DS->decl_begin(),
+                                       E = DS->decl_end(); I != E; ++I) {
+      if (const ValueDecl *VD = dyn_cast<ValueDecl>(*I))
+        if (VD->getType()->isVariablyModifiedType())
+          return true;
+      if (const TypedefNameDecl *TD = dyn_cast<TypedefNameDecl>(*I))
+        if (TD->getUnderlyingType()->isVariablyModifiedType())
+          return true;
+    }
+  }
+  return false;
+}
+
+bool ASTContext::discardFunctionBody(FunctionDecl *FD) {
+  if (FD->isFromASTFile() || !FD->doesThisDeclarationHaveABody())
+    return false;
+  Stmt *Body = FD->getBody();
+  if (!Body)
+    return false;
+
+  // Members of local classes can be emitted after the function and refer to
+  // its static locals, whose initializers are dropped below.
+  for (DeclContext::decl_iterator I = FD->decls_begin(), E = FD->decls_end();
+       I != E; ++I)
+    if (isa<TagDecl>(*I))
+      return false;
+
+  // Collect the nodes first; the syntactic and semantic forms of some
+  // expressions share their subexpressions, so a node can be reached twice.
+  llvm::SmallPtrSet<Stmt *, 64> Visited;
+  SmallVector<Stmt *, 64> Nodes;
+  SmallVector<Stmt *, 16> Worklist;
+  Worklist.push_back(Body);
+  while (!Worklist.empty()) {
+    Stmt *S = Worklist.pop_back_val();
+    if (!Visited.insert(S))
+      continue;
+    if (mayEscapeFunctionBody(S))
+      return false;
+    Nodes.push_back(S);
+    for (Stmt::child_range C = S->children(); C; ++C)
+      if (*C)
+        Worklist.push_back(*C);
+  }
+
+  // The local declarations outlive the body, so they must not point into it.
+  // Default arguments are not part of the body.
+  for (DeclContext::decl_iterator I = FD->decls_begin(), E = FD->decls_end();
+       I != E; ++I) {
+    VarDecl *VD = dyn_cast<VarDecl>(*I);
+    if (VD && !isa<ParmVarDecl>(VD))
+      VD->setInit(nullptr);
+    else if (LabelDecl *LD = dyn_cast<LabelDecl>(*I))
+      LD->setStmt(nullptr);
+  }
+
+  FD->setBody(new (*this) CompoundStmt(Body->getLocStart()));
+
+  for (unsigned I = 0, N = Nodes.size(); I != N; ++I) {
+    size_t Size = getRecyclableStmtSize(Nodes[I]);
+    if (!Size)
+      continue;
+    void *&Head = RecycledStmts[Size];
+    *reinterpret_cast<void **>(Nodes[I]) = Head;
+    Head = Nodes[I];
+    ++NumRecycledStmts;
+    RecycledStmtBytes += Size;
+  }
+  ++NumDiscardedFunctionBodies;
+  return true;
+}
+
 RecordDecl *ASTContext::buildImplicitRecord(StringRef Name,
                                             RecordDecl::TagKind TK) const {
   SourceLocation Loc;
@@ -2123,26 +2304,19 @@ void ASTContext::adjustDeducedFunctionResultType(FunctionDecl *FD,
 QualType ASTContext::getComplexType(QualType T) const {
   // Unique pointers, to guarantee there is only one pointer of a particular
   // structure.
-  llvm::FoldingSetNodeID ID;
-  ComplexType::Profile(ID, T);
-
-  void *InsertPos = nullptr;
-  if (ComplexType *CT = ComplexTypes.FindNodeOrInsertPos(ID, InsertPos))
-    return QualType(CT, 0);
+  auto Known = ComplexTypes.find(T);
+  if (Known != ComplexTypes.end())
+    return QualType(Known->second, 0);
 
   // If the pointee type isn't canonical, this won't be a canonical type either,
   // so fill in the canonical type field.
   QualType Canonical;
-  if (!T.isCanonical()) {
+  if (!T.isCanonical())
     Canonical = getComplexType(getCanonicalType(T));
 
-    // Get the new insert position for the node we care about.
-    ComplexType *NewIP = ComplexTypes.FindNodeOrInsertPos(ID, InsertPos);
-    assert(!NewIP && "Shouldn't be in the map!"); (void)NewIP;
-  }
   ComplexType *New = new (*this, TypeAlignment) ComplexType(T, Canonical);
   Types.push_back(New);
-  ComplexTypes.InsertNode(New, InsertPos);
+  ComplexTypes[T] = New;
   return QualType(New, 0);
 }
 
@@ -2151,47 +2325,31 @@ QualType ASTContext::getComplexType(QualType T) const {
 QualType ASTContext::getPointerType(QualType T) const {
   // Unique pointers, to guarantee there is only one pointer of a particular
   // structure.
-  llvm::FoldingSetNodeID ID;
-  PointerType::Profile(ID, T);
-
-  void *InsertPos = nullptr;
-  if (PointerType *PT = PointerTypes.FindNodeOrInsertPos(ID, InsertPos))
-    return QualType(PT, 0);
+  auto Known = PointerTypes.find(T);
+  if (Known != PointerTypes.end())
+    return QualType(Known->second, 0);
 
   // If the pointee type isn't canonical, this won't be a canonical type either,
   // so fill in the canonical type field.
   QualType Canonical;
-  if (!T.isCanonical()) {
+  if (!T.isCanonical())
     Canonical = getPointerType(getCanonicalType(T));
 
-    // Get the new insert position for the node we care about.
-    PointerType *NewIP = PointerTypes.FindNodeOrInsertPos(ID, InsertPos);
-    assert(!NewIP && "Shouldn't be in the map!"); (void)NewIP;
-  }
   PointerType *New = new (*this, TypeAlignment) PointerType(T, Canonical);
   Types.push_back(New);
-  PointerTypes.InsertNode(New, InsertPos);
+  PointerTypes[T] = New;
   return QualType(New, 0);
 }
 
 QualType ASTContext::getAdjustedType(QualType Orig, QualType New) const {
-  llvm::FoldingSetNodeID ID;
-  AdjustedType::Profile(ID, Orig, New);
-  void *InsertPos = nullptr;
-  AdjustedType *AT = AdjustedTypes.FindNodeOrInsertPos(ID, InsertPos);
+  AdjustedType *&AT = AdjustedTypes[std::make_pair(Orig, New)];
   if (AT)
     return QualType(AT, 0);
 
   QualType Canonical = getCanonicalType(New);
-
-  // Get the new insert position for the node we care about.
-  AT = AdjustedTypes.FindNodeOrInsertPos(ID, InsertPos);
-  assert(!AT && "Shouldn't be in the map!");
-
   AT = new (*this, TypeAlignment)
       AdjustedType(Type::Adjusted, Orig, New, Canonical);
   Types.push_back(AT);
-  AdjustedTypes.InsertNode(AT, InsertPos);
   return QualType(AT, 0);
 }
 
@@ -2215,22 +2373,13 @@ QualType ASTContext::getDecayedType(QualType T) const {
   if (T->isFunctionType())
     Decayed = getPointerType(T);
 
-  llvm::FoldingSetNodeID ID;
-  AdjustedType::Profile(ID, T, Decayed);
-  void *InsertPos = nullptr;
-  AdjustedType *AT = AdjustedTypes.FindNodeOrInsertPos(ID, InsertPos);
+  AdjustedType *&AT = AdjustedTypes[std::make_pair(T, Decayed)];
   if (AT)
     return QualType(AT, 0);
 
   QualType Canonical = getCanonicalType(Decayed);
-
-  // Get the new insert position for the node we care about.
-  AT = AdjustedTypes.FindNodeOrInsertPos(ID, InsertPos);
-  assert(!AT && "Shouldn't be in the map!");
-
   AT = new (*this, TypeAlignment) DecayedType(T, Decayed, Canonical);
   Types.push_back(AT);
-  AdjustedTypes.InsertNode(AT, InsertPos);
   return QualType(AT, 0);
 }
 
@@ -2240,29 +2389,20 @@ QualType ASTContext::getBlockPointerType(QualType T) const {
   assert(T->isFunctionType() && "block of function types only");
   // Unique pointers, to guarantee there is only one block of a particular
   // structure.
-  llvm::FoldingSetNodeID ID;
-  BlockPointerType::Profile(ID, T);
-
-  void *InsertPos = nullptr;
-  if (BlockPointerType *PT =
-        BlockPointerTypes.FindNodeOrInsertPos(ID, InsertPos))
-    return QualType(PT, 0);
+  auto Known = BlockPointerTypes.find(T);
+  if (Known != BlockPointerTypes.end())
+    return QualType(Known->second, 0);
 
   // If the block pointee type isn't canonical, this won't be a canonical
   // type either so fill in the canonical type field.
   QualType Canonical;
-  if (!T.isCanonical()) {
+  if (!T.isCanonical())
     Canonical = getBlockPointerType(getCanonicalType(T));
 
-    // Get the new insert position for the node we care about.
-    BlockPointerType *NewIP =
-      BlockPointerTypes.FindNodeOrInsertPos(ID, InsertPos);
-    assert(!NewIP && "Shouldn't be in the map!"); (void)NewIP;
-  }
   BlockPointerType *New
     = new (*this, TypeAlignment) BlockPointerType(T, Canonical);
   Types.push_back(New);
-  BlockPointerTypes.InsertNode(New, InsertPos);
+  BlockPointerTypes[T] = New;
   return QualType(New, 0);
 }
 
@@ -2275,13 +2415,11 @@ ASTContext::getLValueReferenceType(QualType T, bool SpelledAsLValue) const {
   
   // Unique pointers, to guarantee there is only one pointer of a particular
   // structure.
-  llvm::FoldingSetNodeID ID;
-  ReferenceType::Profile(ID, T, SpelledAsLValue);
-
-  void *InsertPos = nullptr;
-  if (LValueReferenceType *RT =
-        LValueReferenceTypes.FindNodeOrInsertPos(ID, InsertPos))
-    return QualType(RT, 0);
+  llvm::DenseMap<QualType, LValueReferenceType *> &Table =
+      LValueReferenceTypes[SpelledAsLValue];
+  auto Known = Table.find(T);
+  if (Known != Table.end())
+    return QualType(Known->second, 0);
 
   const ReferenceType *InnerRef = T->getAs<ReferenceType>();
 
@@ -2291,18 +2429,13 @@ ASTContext::getLValueReferenceType(QualType T, bool SpelledAsLValue) const {
   if (!SpelledAsLValue || InnerRef || !T.isCanonical()) {
     QualType PointeeType = (InnerRef ? InnerRef->getPointeeType() : T);
     Canonical = getLValueReferenceType(getCanonicalType(PointeeType));
-
-    // Get the new insert position for the node we care about.
-    LValueReferenceType *NewIP =
-      LValueReferenceTypes.FindNodeOrInsertPos(ID, InsertPos);
-    assert(!NewIP && "Shouldn't be in the map!"); (void)NewIP;
   }
 
   LValueReferenceType *New
     = new (*this, TypeAlignment) LValueReferenceType(T, Canonical,
                                                      SpelledAsLValue);
   Types.push_back(New);
-  LValueReferenceTypes.InsertNode(New, InsertPos);
+  Table[T] = New;
 
   return QualType(New, 0);
 }
@@ -2312,13 +2445,9 @@ ASTContext::getLValueReferenceType(QualType T, bool SpelledAsLValue) const {
 QualType ASTContext::getRValueReferenceType(QualType T) const {
   // Unique pointers, to guarantee there is only one pointer of a particular
   // structure.
-  llvm::FoldingSetNodeID ID;
-  ReferenceType::Profile(ID, T, false);
-
-  void *InsertPos = nullptr;
-  if (RValueReferenceType *RT =
-        RValueReferenceTypes.FindNodeOrInsertPos(ID, InsertPos))
-    return QualType(RT, 0);
+  auto Known = RValueReferenceTypes.find(T);
+  if (Known != RValueReferenceTypes.end())
+    return QualType(Known->second, 0);
 
   const ReferenceType *InnerRef = T->getAs<ReferenceType>();
 
@@ -2328,17 +2457,12 @@ QualType ASTContext::getRValueReferenceType(QualType T) const {
   if (InnerRef || !T.isCanonical()) {
     QualType PointeeType = (InnerRef ? InnerRef->getPointeeType() : T);
     Canonical = getRValueReferenceType(getCanonicalType(PointeeType));
-
-    // Get the new insert position for the node we care about.
-    RValueReferenceType *NewIP =
-      RValueReferenceTypes.FindNodeOrInsertPos(ID, InsertPos);
-    assert(!NewIP && "Shouldn't be in the map!"); (void)NewIP;
   }
 
   RValueReferenceType *New
     = new (*this, TypeAlignment) RValueReferenceType(T, Canonical);
   Types.push_back(New);
-  RValueReferenceTypes.InsertNode(New, InsertPos);
+  RValueReferenceTypes[T] = New;
   return QualType(New, 0);
 }
 
@@ -3294,25 +3418,16 @@ ASTContext::getElaboratedType(ElaboratedTypeKeyword Keyword,
 
 QualType
 ASTContext::getParenType(QualType InnerType) const {
-  llvm::FoldingSetNodeID ID;
-  ParenType::Profile(ID, InnerType);
-
-  void *InsertPos = nullptr;
-  ParenType *T = ParenTypes.FindNodeOrInsertPos(ID, InsertPos);
+  ParenType *&T = ParenTypes[InnerType];
   if (T)
     return QualType(T, 0);
 
   QualType Canon = InnerType;
-  if (!Canon.isCanonical()) {
+  if (!Canon.isCanonical())
     Canon = getCanonicalType(InnerType);
-    ParenType *CheckT = ParenTypes.FindNodeOrInsertPos(ID, InsertPos);
-    assert(!CheckT && "Paren canonical type broken");
-    (void)CheckT;
-  }
 
   T = new (*this) ParenType(InnerType, Canon);
   Types.push_back(T);
-  ParenTypes.InsertNode(T, InsertPos);
   return QualType(T, 0);
 }
 
@@ -3776,26 +3891,19 @@ QualType ASTContext::getAutoType(QualType DeducedType, bool IsDecltypeAuto,
 QualType ASTContext::getAtomicType(QualType T) const {
   // Unique pointers, to guarantee there is only one pointer of a particular
   // structure.
-  llvm::FoldingSetNodeID ID;
-  AtomicType::Profile(ID, T);
-
-  void *InsertPos = nullptr;
-  if (AtomicType *AT = AtomicTypes.FindNodeOrInsertPos(ID, InsertPos))
-    return QualType(AT, 0);
+  auto Known = AtomicTypes.find(T);
+  if (Known != AtomicTypes.end())
+    return QualType(Known->second, 0);
 
   // If the atomic value type isn't canonical, this won't be a canonical type
   // either, so fill in the canonical type field.
   QualType Canonical;
-  if (!T.isCanonical()) {
+  if (!T.isCanonical())
     Canonical = getAtomicType(getCanonicalType(T));
 
-    // Get the new insert position for the node we care about.
-    AtomicType *NewIP = AtomicTypes.FindNodeOrInsertPos(ID, InsertPos);
-    assert(!NewIP && "Shouldn't be in the map!"); (void)NewIP;
-  }
   AtomicType *New = new (*this, TypeAlignment) AtomicType(T, Canonical);
   Types.push_back(New);
-  AtomicTypes.InsertNode(New, InsertPos);
+  AtomicTypes[T] = New;
   return QualType(New, 0);
 }
 
@@ -8037,6 +8145,15 @@ size_t ASTContext::getSideTableAllocatedMemory() const {
          llvm::capacity_in_bytes(InstantiatedFromUnnamedFieldDecl) +
          llvm::capacity_in_bytes(OverriddenMethods) +
          llvm::capacity_in_bytes(Types) +
+         llvm::capacity_in_bytes(ComplexTypes) +
+         llvm::capacity_in_bytes(PointerTypes) +
+         llvm::capacity_in_bytes(AdjustedTypes) +
+         llvm::capacity_in_bytes(BlockPointerTypes) +
+         llvm::capacity_in_bytes(LValueReferenceTypes[0]) +
+         llvm::capacity_in_bytes(LValueReferenceTypes[1]) +
+         llvm::capacity_in_bytes(RValueReferenceTypes) +
+         llvm::capacity_in_bytes(ParenTypes) +
+         llvm::capacity_in_bytes(AtomicTypes) +
          llvm::capacity_in_bytes(VariableArrayTypes) +
          llvm::capacity_in_bytes(ClassScopeSpecializationPattern);
 }
@@ -8132,6 +8249,17 @@ ASTContext::getMaterializedTemporaryValue(const MaterializeTemporaryExpr *E,
   return I == MaterializedTemporaryValues.end() ? nullptr : &I->second;
 }
 
+APValue *ASTContext::getConstexprCallResult(StringRef Key, bool MayCreate) {
+  if (MayCreate)
+    return &ConstexprCallResults[Key];
+
+  llvm::StringMap<APValue>::iterator I = ConstexprCallResults.find(Key);
+  if (I == ConstexprCallResults.end())
+    return nullptr;
+  ++NumConstexprCallResultHits;
+  return &I->second;
+}
+
 bool ASTContext::AtomicUsesUnsupportedLibcall(const AtomicExpr *E) const {
   const llvm::Triple &T = getTargetInfo().getTriple();
   if (!T.isOSDarwin())
@@ -2280,7 +2280,7 @@ bool FunctionDecl::isVariadic() const {
 
 bool FunctionDecl::hasBody(const FunctionDecl *&Definition) const {
   for (auto I : redecls()) {
-    if (I->Body || I->IsLateTemplateParsed) {
+    if (I->Body || I->IsLateTemplateParsed || I->HasLazyBody) {
       Definition = I;
       return true;
     }
@@ -2306,7 +2306,7 @@ bool FunctionDecl::hasTrivialBody() const
 bool FunctionDecl::isDefined(const FunctionDecl *&Definition) const {
   for (auto I : redecls()) {
     if (I->IsDeleted || I->IsDefaulted || I->Body || I->IsLateTemplateParsed ||
-        I->hasAttr<AliasAttr>()) {
+        I->HasLazyBody || I->hasAttr<AliasAttr>()) {
       Definition = I->IsDeleted ? I->getCanonicalDecl() : I;
       return true;
     }
@@ -2319,6 +2319,14 @@ Stmt *FunctionDecl::getBody(const FunctionDecl *&Definition) const {
   if (!hasBody(Definition))
     return nullptr;
 
+  if (Definition->HasLazyBody) {
+    LazyFunctionBodySource *Source =
+        getASTContext().getLazyFunctionBodySource();
+    return Source ? Source->ParseFunctionBody(
+                        const_cast<FunctionDecl *>(Definition))
+                  : nullptr;
+  }
+
   if (Definition->Body)
     return Definition->Body.get(getASTContext().getExternalSource());
 
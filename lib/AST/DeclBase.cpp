@@ -41,6 +41,22 @@ using namespace clang;
 #define ABSTRACT_DECL(DECL)
 #include "clang/AST/DeclNodes.inc"
 
+namespace {
+enum {
+  NumDeclKinds =
+#define DECL(DERIVED, BASE) 1 +
+#define ABSTRACT_DECL(DECL)
+#include "clang/AST/DeclNodes.inc"
+  0
+};
+}
+
+/// \brief Name lookup statistics, indexed by the kind of the primary
+/// DeclContext being searched.
+static unsigned NumLookups[NumDeclKinds];
+static unsigned NumLookupTableBuilds[NumDeclKinds];
+static unsigned NumLookupTableNames[NumDeclKinds];
+
 void Decl::updateOutOfDate(IdentifierInfo &II) const {
   getASTContext().getExternalSource()->updateOutOfDateIdentifier(II);
 }
@@ -51,6 +67,7 @@ void *Decl::operator new(std::size_t Size, const ASTContext &Context,
   // resulting pointer will still be 8-byte aligned. 
   void *Start = Context.Allocate(Size + Extra + 8);
   void *Result = (char*)Start + 8;
+  Context.DeclAllocatedBytes += Size + Extra + 8;
 
   unsigned *PrefixPtr = (unsigned *)Result - 2;
 
@@ -66,6 +83,7 @@ void *Decl::operator new(std::size_t Size, const ASTContext &Context,
 void *Decl::operator new(std::size_t Size, const ASTContext &Ctx,
                          DeclContext *Parent, std::size_t Extra) {
   assert(!Parent || &Parent->getParentASTContext() == &Ctx);
+  Ctx.DeclAllocatedBytes += Size + Extra;
   return ::operator new(Size + Extra, Ctx);
 }
 
@@ -130,6 +148,16 @@ void Decl::PrintStats() {
 #include "clang/AST/DeclNodes.inc"
 
   llvm::errs() << "Total bytes = " << totalBytes << "\n";
+
+  llvm::errs() << "\n*** DeclContext Lookup Stats:\n";
+#define DECL(DERIVED, BASE)                                             \
+  if (NumLookups[DERIVED] > 0 || NumLookupTableBuilds[DERIVED] > 0)     \
+    llvm::errs() << "    " << NumLookups[DERIVED] << " " #DERIVED       \
+                 << " lookups, " << NumLookupTableBuilds[DERIVED]       \
+                 << " lookup table builds ("                            \
+                 << NumLookupTableNames[DERIVED] << " names)\n";
+#define ABSTRACT_DECL(DECL)
+#include "clang/AST/DeclNodes.inc"
 }
 
 void Decl::add(Kind k) {
@@ -1243,13 +1271,35 @@ StoredDeclsMap *DeclContext::buildLookup() {
 
   SmallVector<DeclContext *, 2> Contexts;
   collectAllContexts(Contexts);
+
+  // Size the table for all of the declarations up front, so that building the
+  // lookup for a large namespace or class doesn't repeatedly rehash it.
+  unsigned NumNamedDecls = 0;
+  for (unsigned I = 0, N = Contexts.size(); I != N; ++I)
+    for (decl_iterator D = Contexts[I]->decls_begin(),
+                       DEnd = Contexts[I]->decls_end(); D != DEnd; ++D)
+      if (isa<NamedDecl>(*D) && !D->isFromASTFile())
+        ++NumNamedDecls;
+  if (NumNamedDecls > 4) {
+    StoredDeclsMap *Map = LookupPtr.getPointer();
+    if (!Map)
+      Map = CreateStoredDeclsMap(getParentASTContext());
+    Map->resize(NumNamedDecls * 4 / 3 + 1);
+  }
+
   for (unsigned I = 0, N = Contexts.size(); I != N; ++I)
     buildLookupImpl<&DeclContext::decls_begin,
                     &DeclContext::decls_end>(Contexts[I]);
 
   // We no longer have any lazy decls.
   LookupPtr.setInt(false);
-  return LookupPtr.getPointer();
+
+  StoredDeclsMap *Map = LookupPtr.getPointer();
+  if (Decl::StatisticsEnabled) {
+    ++NumLookupTableBuilds[getDeclKind()];
+    NumLookupTableNames[getDeclKind()] += Map ? Map->size() : 0;
+  }
+  return Map;
 }
 
 /// buildLookupImpl - Build part of the lookup data structure for the
@@ -1296,6 +1346,9 @@ DeclContext::lookup(DeclarationName Name) {
   if (PrimaryContext != this)
     return PrimaryContext->lookup(Name);
 
+  if (Decl::StatisticsEnabled)
+    ++NumLookups[getDeclKind()];
+
   // If this is a namespace, ensure that any later redeclarations of it have
   // been loaded, since they may add names to the result of this lookup.
   if (auto *ND = dyn_cast<NamespaceDecl>(this))
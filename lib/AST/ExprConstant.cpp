@@ -454,6 +454,10 @@ namespace {
     /// notes attached to it will also be stored, otherwise they will not be.
     bool HasActiveDiagnostic;
 
+    /// UsedEvaluatingDeclValue - Have we accessed the in-flight value of
+    /// EvaluatingDecl? Calls which do so can't be memoized.
+    bool UsedEvaluatingDeclValue;
+
     enum EvaluationMode {
       /// Evaluate as a constant expression. Stop if we find that the expression
       /// is not a constant expression.
@@ -507,6 +511,22 @@ namespace {
     // in such constructs, not just overflow.
     bool checkingForOverflow() { return EvalMode == EM_EvaluateForOverflow; }
 
+    /// Can we use a memoized result instead of evaluating a constexpr call?
+    bool canReuseCallResults() {
+      return !checkingPotentialConstantExpression() && !checkingForOverflow();
+    }
+
+    /// Would the result of a constexpr call evaluated from this point be a
+    /// valid result for a later evaluation of the same call? This is the
+    /// case if we are evaluating a constant expression, collecting notes,
+    /// and nothing has gone wrong so far.
+    bool canMemoizeCallResults() {
+      if (EvalMode != EM_ConstantExpression && EvalMode != EM_ConstantFold)
+        return false;
+      return EvalStatus.Diag && EvalStatus.Diag->empty() &&
+             !EvalStatus.HasSideEffects;
+    }
+
     EvalInfo(const ASTContext &C, Expr::EvalStatus &S, EvaluationMode Mode)
       : Ctx(const_cast<ASTContext &>(C)), EvalStatus(S), CurrentCall(nullptr),
         CallStackDepth(0), NextCallIndex(1),
@@ -514,7 +534,7 @@ namespace {
         BottomFrame(*this, SourceLocation(), nullptr, nullptr, nullptr),
         EvaluatingDecl((const ValueDecl *)nullptr),
         EvaluatingDeclValue(nullptr), HasActiveDiagnostic(false),
-        EvalMode(Mode) {}
+        UsedEvaluatingDeclValue(false), EvalMode(Mode) {}
 
     void setEvaluatingDecl(APValue::LValueBase Base, APValue &Value) {
       EvaluatingDecl = Base;
@@ -1967,6 +1987,7 @@ static bool evaluateVarDeclInit(EvalInfo &Info, const Expr *E,
   // If we're currently evaluating the initializer of this declaration, use that
   // in-flight value.
   if (Info.EvaluatingDecl.dyn_cast<const ValueDecl*>() == VD) {
+    Info.UsedEvaluatingDeclValue = true;
     Result = Info.EvaluatingDeclValue;
     return true;
   }
@@ -2568,6 +2589,8 @@ CompleteObject findCompleteObject(EvalInfo &Info, const Expr *E, AccessKinds AK,
           Info.Note(MTE->getExprLoc(), diag::note_constexpr_temporary_here);
           return CompleteObject();
         }
+        if (VD && VD->getCanonicalDecl() == ED->getCanonicalDecl())
+          Info.UsedEvaluatingDeclValue = true;
 
         BaseVal = Info.Ctx.getMaterializedTemporaryValue(MTE, false);
         assert(BaseVal && "got reference to unevaluated temporary");
@@ -3591,6 +3614,30 @@ static bool CheckConstexprFunction(EvalInfo &Info, SourceLocation CallLoc,
 
 namespace {
 typedef SmallVector<APValue, 8> ArgVector;
+
+/// Compute the key under which the result of a call to \p Callee with the
+/// given arguments is memoized. Returns false if the call's arguments are not
+/// all integers or floating-point values.
+static bool getConstexprCallKey(const FunctionDecl *Callee,
+                                ArrayRef<APValue> Args,
+                                SmallVectorImpl<char> &Key) {
+  // The parameter types are fixed by the callee, so the bits of each argument
+  // are enough to identify it.
+  Key.append(reinterpret_cast<const char *>(&Callee),
+             reinterpret_cast<const char *>(&Callee + 1));
+  for (unsigned I = 0, N = Args.size(); I != N; ++I) {
+    APInt Bits;
+    if (Args[I].isInt())
+      Bits = Args[I].getInt();
+    else if (Args[I].isFloat())
+      Bits = Args[I].getFloat().bitcastToAPInt();
+    else
+      return false;
+    const char *Data = reinterpret_cast<const char *>(Bits.getRawData());
+    Key.append(Data, Data + Bits.getNumWords() * sizeof(uint64_t));
+  }
+  return true;
+}
 }
 
 /// EvaluateArgs - Evaluate the arguments to a function call.
@@ -3619,6 +3666,21 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
   if (!EvaluateArgs(Args, ArgValues, Info))
     return false;
 
+  // A call to a function with scalar arguments and no 'this' can only depend
+  // on its arguments and on constants, so once it has been evaluated
+  // successfully, its value can be reused for the rest of the translation
+  // unit.
+  SmallString<64> MemoKey;
+  bool Memoize = !This && Info.canReuseCallResults() &&
+                 getConstexprCallKey(Callee, ArgValues, MemoKey);
+  if (Memoize) {
+    if (APValue *Memoized = Info.Ctx.getConstexprCallResult(MemoKey, false)) {
+      Result = *Memoized;
+      return true;
+    }
+    Memoize = Info.canMemoizeCallResults();
+  }
+
   if (!Info.CheckCallLimit(CallLoc))
     return false;
 
@@ -3644,7 +3706,16 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
     return true;
   }
 
+  bool OldUsedEvaluatingDeclValue = Info.UsedEvaluatingDeclValue;
+  Info.UsedEvaluatingDeclValue = false;
+
   EvalStmtResult ESR = EvaluateStmt(Result, Info, Body);
+
+  if (ESR == ESR_Returned && Memoize && Info.canMemoizeCallResults() &&
+      !Info.UsedEvaluatingDeclValue && (Result.isInt() || Result.isFloat()))
+    *Info.Ctx.getConstexprCallResult(MemoKey, true) = Result;
+  Info.UsedEvaluatingDeclValue |= OldUsedEvaluatingDeclValue;
+
   if (ESR == ESR_Succeeded) {
     if (Callee->getReturnType()->isVoidType())
       return true;
@@ -22,6 +22,8 @@ using namespace clang;
 
 ExternalASTSource::~ExternalASTSource() { }
 
+LazyFunctionBodySource::~LazyFunctionBodySource() { }
+
 void ExternalASTSource::FindFileRegionDecls(FileID File, unsigned Offset,
                                             unsigned Length,
                                             SmallVectorImpl<Decl *> &Decls) {}
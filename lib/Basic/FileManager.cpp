@@ -307,7 +307,7 @@ const FileEntry *FileManager::getFile(StringRef Filename, bool openFile,
 
 const FileEntry *
 FileManager::getVirtualFile(StringRef Filename, off_t Size,
-                            time_t ModificationTime) {
+                            time_t ModificationTime, bool StatFile) {
   ++NumFileLookups;
 
   // See if there is already an entry in the map.
@@ -337,7 +337,7 @@ FileManager::getVirtualFile(StringRef Filename, off_t Size,
   // Check to see if the file exists. If so, drop the virtual file
   FileData Data;
   const char *InterndFileName = NamedFileEnt.getKeyData();
-  if (getStatValue(InterndFileName, Data, true, nullptr) == 0) {
+  if (StatFile && getStatValue(InterndFileName, Data, true, nullptr) == 0) {
     Data.Size = Size;
     Data.ModTime = ModificationTime;
     UFE = &UniqueRealFiles[Data.UniqueID];
@@ -388,7 +388,8 @@ void FileManager::FixupRelativePath(SmallVectorImpl<char> &path) const {
 
 std::unique_ptr<llvm::MemoryBuffer>
 FileManager::getBufferForFile(const FileEntry *Entry, std::string *ErrorStr,
-                              bool isVolatile, bool ShouldCloseOpenFile) {
+                              bool isVolatile, bool ShouldCloseOpenFile,
+                              bool RequiresNullTerminator) {
   std::unique_ptr<llvm::MemoryBuffer> Result;
   std::error_code ec;
 
@@ -402,7 +403,7 @@ FileManager::getBufferForFile(const FileEntry *Entry, std::string *ErrorStr,
   // If the file is already open, use the open file descriptor.
   if (Entry->File) {
     ec = Entry->File->getBuffer(Filename, Result, FileSize,
-                                /*RequiresNullTerminator=*/true, isVolatile);
+                                RequiresNullTerminator, isVolatile);
     if (ErrorStr)
       *ErrorStr = ec.message();
     // FIXME: we need a set of APIs that can make guarantees about whether a
@@ -416,7 +417,7 @@ FileManager::getBufferForFile(const FileEntry *Entry, std::string *ErrorStr,
 
   if (FileSystemOpts.WorkingDir.empty()) {
     ec = FS->getBufferForFile(Filename, Result, FileSize,
-                              /*RequiresNullTerminator=*/true, isVolatile);
+                              RequiresNullTerminator, isVolatile);
     if (ec && ErrorStr)
       *ErrorStr = ec.message();
     return Result;
@@ -425,7 +426,7 @@ FileManager::getBufferForFile(const FileEntry *Entry, std::string *ErrorStr,
   SmallString<128> FilePath(Entry->getName());
   FixupRelativePath(FilePath);
   ec = FS->getBufferForFile(FilePath.str(), Result, FileSize,
-                            /*RequiresNullTerminator=*/true, isVolatile);
+                            RequiresNullTerminator, isVolatile);
   if (ec && ErrorStr)
     *ErrorStr = ec.message();
   return Result;
@@ -0,0 +1,124 @@
+//===--- TimeTrace.cpp - Chrome trace of a compilation --------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the TimeTraceProfiler.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/TimeTrace.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace clang;
+
+TimeTraceProfiler *TimeTraceProfiler::Current = nullptr;
+
+/// \brief The rows of the trace.
+enum {
+  PhaseLane = 0,
+  FileLane = 1
+};
+
+TimeTraceProfiler::TimeTraceProfiler(unsigned Granularity)
+    : StartTime(llvm::sys::TimeValue::now()), Granularity(Granularity) {}
+
+uint64_t TimeTraceProfiler::getElapsedMicroseconds() const {
+  return (llvm::sys::TimeValue::now() - StartTime).usec();
+}
+
+void TimeTraceProfiler::begin(StringRef Name, StringRef Detail) {
+  Event E;
+  E.Name = Name;
+  E.Detail = Detail;
+  E.Start = getElapsedMicroseconds();
+  E.Duration = 0;
+  E.Lane = PhaseLane;
+  Phases.push_back(E);
+}
+
+void TimeTraceProfiler::end() {
+  if (!Phases.empty())
+    finish(Phases);
+}
+
+void TimeTraceProfiler::setDetail(StringRef Detail) {
+  if (!Phases.empty())
+    Phases.back().Detail = Detail;
+}
+
+void TimeTraceProfiler::enterFile(StringRef FileName) {
+  Event E;
+  E.Name = "Source";
+  E.Detail = FileName;
+  E.Start = getElapsedMicroseconds();
+  E.Duration = 0;
+  E.Lane = FileLane;
+  Files.push_back(E);
+}
+
+void TimeTraceProfiler::exitFile() {
+  if (!Files.empty())
+    finish(Files);
+}
+
+void TimeTraceProfiler::finish(SmallVectorImpl<Event> &Stack) {
+  Event E = Stack.pop_back_val();
+  E.Duration = getElapsedMicroseconds() - E.Start;
+  if (E.Duration >= Granularity)
+    Events.push_back(E);
+}
+
+static void writeString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  for (char C : Str) {
+    switch (C) {
+    case '"':  OS << "\\\""; break;
+    case '\\': OS << "\\\\"; break;
+    case '\n': OS << "\\n"; break;
+    case '\t': OS << "\\t"; break;
+    default:
+      if (static_cast<unsigned char>(C) < 0x20)
+        OS << llvm::format("\\u%04x", static_cast<unsigned>(C));
+      else
+        OS << C;
+    }
+  }
+  OS << '"';
+}
+
+static void writeLaneName(raw_ostream &OS, unsigned Lane, StringRef Name) {
+  OS << "{\"pid\":1,\"tid\":" << Lane
+     << ",\"ph\":\"M\",\"name\":\"thread_name\",\"args\":{\"name\":";
+  writeString(OS, Name);
+  OS << "}}";
+}
+
+void TimeTraceProfiler::write(raw_ostream &OS) {
+  while (!Phases.empty())
+    finish(Phases);
+  while (!Files.empty())
+    finish(Files);
+
+  OS << "{\"traceEvents\":[\n";
+  for (const Event &E : Events) {
+    OS << "{\"pid\":1,\"tid\":" << E.Lane << ",\"ph\":\"X\",\"ts\":" << E.Start
+       << ",\"dur\":" << E.Duration << ",\"name\":";
+    writeString(OS, E.Name);
+    if (!E.Detail.empty()) {
+      OS << ",\"args\":{\"detail\":";
+      writeString(OS, E.Detail);
+      OS << '}';
+    }
+    OS << "},\n";
+  }
+  writeLaneName(OS, PhaseLane, "Compilation");
+  OS << ",\n";
+  writeLaneName(OS, FileLane, "Source files");
+  OS << "\n]}\n";
+}
@@ -11,23 +11,37 @@
 #include "clang/Basic/Diagnostic.h"
 #include "clang/Basic/LangOptions.h"
 #include "clang/Basic/TargetOptions.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Frontend/CodeGenOptions.h"
 #include "clang/Frontend/FrontendDiagnostic.h"
 #include "clang/Frontend/Utils.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Bitcode/BitcodeWriterPass.h"
+#include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/CodeGen/RegAllocRegistry.h"
 #include "llvm/CodeGen/SchedulerRegistry.h"
 #include "llvm/IR/DataLayout.h"
+#include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/IRPrintingPasses.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/IRReader/IRReader.h"
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/PassManager.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormattedStream.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/MutexGuard.h"
 #include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetLibraryInfo.h"
@@ -39,12 +53,30 @@
 #include "llvm/Transforms/Instrumentation.h"
 #include "llvm/Transforms/ObjCARC.h"
 #include "llvm/Transforms/Scalar.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include <algorithm>
 #include <memory>
+#include <thread>
 using namespace clang;
 using namespace llvm;
 
 namespace {
 
+/// \brief One of the pieces of a module whose code is generated on a thread
+/// of its own by -fparallel-codegen.
+struct CodeGenPartition {
+  /// \brief The bitcode of the piece of the module.
+  SmallString<0> Bitcode;
+  /// \brief The target machine which generates the code of the piece.
+  std::unique_ptr<TargetMachine> TM;
+  /// \brief The generated object file.
+  SmallString<0> Object;
+  /// \brief True if the code generator could not be set up.
+  bool Failed;
+
+  CodeGenPartition() : Failed(false) {}
+};
+
 class EmitAssemblyHelper {
   DiagnosticsEngine &Diags;
   const CodeGenOptions &CodeGenOpts;
@@ -106,6 +138,27 @@ private:
   /// \return True on success.
   bool AddEmitPasses(BackendAction Action, formatted_raw_ostream &OS);
 
+  /// \brief Returns true if the code of the pieces of the module is generated
+  /// on multiple threads, as requested by -fparallel-codegen.
+  bool shouldEmitInParallel(BackendAction Action) const;
+
+  /// EmitObjectInParallel - Split the optimized module by function, generate
+  /// the object files of the pieces on CodeGenOpts.ParallelCodeGen threads,
+  /// and write their relocatable link to \p OS.
+  void EmitObjectInParallel(formatted_raw_ostream &OS);
+
+  /// EmitPartition - Generate the object file of \p Part in an LLVMContext
+  /// of its own, forwarding the diagnostics to \p MainContext. \p Suffix is
+  /// appended to the names of the \p Shared symbols.
+  void EmitPartition(CodeGenPartition &Part, LLVMContext &MainContext,
+                     ArrayRef<std::string> Shared, StringRef Suffix) const;
+
+  /// LinkPartitions - Combine the object files of \p Parts with a
+  /// relocatable link and write the result to \p OS.
+  ///
+  /// \return True on success.
+  bool LinkPartitions(ArrayRef<CodeGenPartition> Parts, raw_ostream &OS);
+
 public:
   EmitAssemblyHelper(DiagnosticsEngine &_Diags,
                      const CodeGenOptions &CGOpts,
@@ -532,6 +585,445 @@ bool EmitAssemblyHelper::AddEmitPasses(BackendAction Action,
   return true;
 }
 
+bool EmitAssemblyHelper::shouldEmitInParallel(BackendAction Action) const {
+  if (CodeGenOpts.ParallelCodeGen < 2 || Action != Backend_EmitObj)
+    return false;
+
+  // The object files of the pieces are combined with a relocatable link,
+  // which the COFF tools do not provide.
+  if (llvm::Triple(TheModule->getTargetTriple()).isOSBinFormatCOFF())
+    return false;
+
+  // -ftime-report times the code generation of the whole module.
+  return llvm_is_multithreaded() && !llvm::TimePassesIsEnabled;
+}
+
+/// \brief Maps each function definition to the piece of the module in which
+/// its code is generated.
+typedef DenseMap<const Function *, unsigned> PartitionMap;
+
+/// \brief Returns the piece of the module in which \p F is defined. Global
+/// variables, aliases and everything not in the map live in piece 0.
+static unsigned getPartition(const Function *F,
+                             const PartitionMap &Partitions) {
+  PartitionMap::const_iterator I = Partitions.find(F);
+  return I == Partitions.end() ? 0 : I->second;
+}
+
+static unsigned getInstructionCount(const Function &F) {
+  unsigned Count = 0;
+  for (Function::const_iterator I = F.begin(), E = F.end(); I != E; ++I)
+    Count += I->size();
+  return Count;
+}
+
+/// \brief Assigns the function definitions of \p M to at most
+/// \p NumPartitions pieces of roughly the same number of instructions.
+///
+/// \returns The number of pieces which were used.
+static unsigned partitionModule(Module &M, unsigned NumPartitions,
+                                PartitionMap &Partitions) {
+  // Aliases and global variables live in piece 0, together with the
+  // functions they alias and the other members of their comdats. So do the
+  // functions whose blocks have their address taken and the functions which
+  // use these addresses.
+  SmallPtrSet<const Function *, 8> Pinned;
+  SmallPtrSet<const Comdat *, 8> PinnedComdats;
+  for (Module::global_iterator I = M.global_begin(), E = M.global_end();
+       I != E; ++I)
+    if (const Comdat *C = I->getComdat())
+      PinnedComdats.insert(C);
+  for (Module::alias_iterator I = M.alias_begin(), E = M.alias_end(); I != E;
+       ++I)
+    if (const Function *F =
+            dyn_cast<Function>(I->getAliasee()->stripPointerCasts()))
+      Pinned.insert(F);
+  for (Module::iterator F = M.begin(), FE = M.end(); F != FE; ++F)
+    for (Function::iterator BB = F->begin(), BE = F->end(); BB != BE; ++BB) {
+      if (!BB->hasAddressTaken())
+        continue;
+      Pinned.insert(F);
+      for (const User *U : BlockAddress::get(BB)->users())
+        if (const Instruction *I = dyn_cast<Instruction>(U))
+          Pinned.insert(I->getParent()->getParent());
+    }
+  for (const Function *F : Pinned)
+    if (const Comdat *C = F->getComdat())
+      PinnedComdats.insert(C);
+
+  std::vector<unsigned> Sizes(NumPartitions, 0);
+  DenseMap<const Comdat *, unsigned> ComdatPartitions;
+  unsigned NumUsed = 1;
+  for (Module::iterator F = M.begin(), E = M.end(); F != E; ++F) {
+    if (F->isDeclaration() || F->hasAvailableExternallyLinkage())
+      continue;
+
+    unsigned P;
+    const Comdat *C = F->getComdat();
+    DenseMap<const Comdat *, unsigned>::iterator CI =
+        C ? ComdatPartitions.find(C) : ComdatPartitions.end();
+    if (Pinned.count(F) || (C && PinnedComdats.count(C)))
+      P = 0;
+    else if (CI != ComdatPartitions.end())
+      P = CI->second;
+    else
+      P = std::min_element(Sizes.begin(), Sizes.end()) - Sizes.begin();
+
+    if (C)
+      ComdatPartitions.insert(std::make_pair(C, P));
+    Partitions[F] = P;
+    Sizes[P] += getInstructionCount(*F);
+    NumUsed = std::max(NumUsed, P + 1);
+  }
+  return NumUsed;
+}
+
+/// \brief Returns true if \p V is used by a function or a global value which
+/// does not live in piece \p P.
+static bool isUsedOutsidePartition(const Value *V, unsigned P,
+                                   const PartitionMap &Partitions) {
+  for (const User *U : V->users()) {
+    if (const Instruction *I = dyn_cast<Instruction>(U)) {
+      if (getPartition(I->getParent()->getParent(), Partitions) != P)
+        return true;
+    } else if (isa<GlobalValue>(U)) {
+      if (P != 0)
+        return true;
+    } else if (isa<Constant>(U) && isUsedOutsidePartition(U, P, Partitions)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void externalizeIfShared(GlobalValue &GV, unsigned P,
+                                const PartitionMap &Partitions,
+                                std::vector<std::string> &Shared) {
+  if (!GV.hasLocalLinkage() || !isUsedOutsidePartition(&GV, P, Partitions))
+    return;
+  GV.setName(Twine(GV.getName()) + ".pcg");
+  GV.setLinkage(GlobalValue::ExternalLinkage);
+  GV.setVisibility(GlobalValue::HiddenVisibility);
+  Shared.push_back(GV.getName().str());
+}
+
+/// \brief Gives external linkage to the local symbols of \p M which are used
+/// by more than one piece, and appends their new names to \p Shared.
+///
+/// Hidden symbols still clash with those of the other object files linked
+/// into the same image, so each piece later appends a suffix unique to the
+/// object file to these names; see getUniqueSuffix.
+static void externalizeLocals(Module &M, const PartitionMap &Partitions,
+                              std::vector<std::string> &Shared) {
+  for (Module::iterator I = M.begin(), E = M.end(); I != E; ++I)
+    externalizeIfShared(*I, getPartition(I, Partitions), Partitions, Shared);
+  for (Module::global_iterator I = M.global_begin(), E = M.global_end();
+       I != E; ++I)
+    externalizeIfShared(*I, 0, Partitions, Shared);
+  for (Module::alias_iterator I = M.alias_begin(), E = M.alias_end(); I != E;
+       ++I)
+    externalizeIfShared(*I, 0, Partitions, Shared);
+}
+
+/// \brief Returns the suffix given to the local symbols shared by the pieces
+/// of \p M, whose bitcode is in \p Parts.
+///
+/// It only depends on the module identifier and on the contents of the
+/// module, so the object file does not depend on where it is built, while
+/// objects compiled from the same file with different options still get
+/// different suffixes.
+static std::string getUniqueSuffix(const Module &M,
+                                   ArrayRef<CodeGenPartition> Parts) {
+  MD5 Hash;
+  Hash.update(M.getModuleIdentifier());
+  for (const CodeGenPartition &Part : Parts)
+    Hash.update(Part.Bitcode);
+
+  MD5::MD5Result Result;
+  Hash.final(Result);
+  SmallString<32> Digest;
+  MD5::stringifyResult(Result, Digest);
+  return (Twine(".") + Digest).str();
+}
+
+/// \brief Returns a copy of \p M in which only the definitions of piece
+/// \p P are kept, the others being turned into declarations.
+static Module *extractPartition(const Module &M, unsigned P,
+                                const PartitionMap &Partitions) {
+  ValueToValueMapTy VMap;
+  Module *Part = CloneModule(&M, VMap);
+  SmallVector<GlobalValue *, 16> Declared;
+
+  if (P != 0) {
+    for (Module::alias_iterator I = Part->alias_begin(),
+                                E = Part->alias_end();
+         I != E;) {
+      GlobalAlias *GA = I++;
+      GlobalValue *Decl;
+      PointerType *Ty = GA->getType();
+      if (FunctionType *FTy = dyn_cast<FunctionType>(Ty->getElementType()))
+        Decl = Function::Create(FTy, GlobalValue::ExternalLinkage, "", Part);
+      else
+        Decl = new GlobalVariable(*Part, Ty->getElementType(),
+                                  /*isConstant=*/false,
+                                  GlobalValue::ExternalLinkage, nullptr, "",
+                                  nullptr, GlobalVariable::NotThreadLocal,
+                                  Ty->getAddressSpace());
+      Decl->takeName(GA);
+      Decl->setVisibility(GA->getVisibility());
+      GA->replaceAllUsesWith(Decl);
+      GA->eraseFromParent();
+      Declared.push_back(Decl);
+    }
+
+    for (Module::global_iterator I = Part->global_begin(),
+                                 E = Part->global_end();
+         I != E;) {
+      GlobalVariable *GV = I++;
+      if (GV->hasAppendingLinkage())
+        GV->eraseFromParent();
+    }
+
+    // Module-level inline assembly is emitted once, with piece 0.
+    Part->setModuleInlineAsm("");
+  }
+
+  for (Module::const_iterator I = M.begin(), E = M.end(); I != E; ++I) {
+    if (I->isDeclaration() || getPartition(I, Partitions) == P)
+      continue;
+    Function *F = cast<Function>(VMap[I]);
+    F->deleteBody();
+    F->setComdat(nullptr);
+    Declared.push_back(F);
+  }
+
+  if (P != 0) {
+    for (Module::global_iterator I = Part->global_begin(),
+                                 E = Part->global_end();
+         I != E; ++I) {
+      if (I->isDeclaration())
+        continue;
+      I->setInitializer(nullptr);
+      I->setLinkage(GlobalValue::ExternalLinkage);
+      I->setComdat(nullptr);
+      Declared.push_back(I);
+    }
+  }
+
+  // Drop the declarations which are no longer used, so that the debug
+  // information of the piece does not refer to them.
+  for (GlobalValue *GV : Declared) {
+    GV->removeDeadConstantUsers();
+    if (GV->use_empty())
+      GV->eraseFromParent();
+  }
+  return Part;
+}
+
+static TargetMachine *cloneTargetMachine(const TargetMachine &TM) {
+  return TM.getTarget().createTargetMachine(
+      TM.getTargetTriple(), TM.getTargetCPU(), TM.getTargetFeatureString(),
+      TM.Options, TM.getRelocationModel(), TM.getCodeModel(),
+      TM.getOptLevel());
+}
+
+/// \brief Serializes the diagnostics which the pieces forward to the
+/// context of the module.
+static ManagedStatic<sys::Mutex> DiagnosticForwardingLock;
+
+static void forwardDiagnostic(const DiagnosticInfo &DI, void *Context) {
+  MutexGuard Lock(*DiagnosticForwardingLock);
+  static_cast<LLVMContext *>(Context)->diagnose(DI);
+}
+
+static void forwardInlineAsmDiagnostic(const SMDiagnostic &D, void *Context,
+                                       unsigned LocCookie) {
+  MutexGuard Lock(*DiagnosticForwardingLock);
+  LLVMContext *MainContext = static_cast<LLVMContext *>(Context);
+  if (LLVMContext::InlineAsmDiagHandlerTy Handler =
+          MainContext->getInlineAsmDiagnosticHandler())
+    Handler(D, MainContext->getInlineAsmDiagnosticContext(), LocCookie);
+  else
+    D.print(nullptr, errs());
+}
+
+void EmitAssemblyHelper::EmitPartition(CodeGenPartition &Part,
+                                       LLVMContext &MainContext,
+                                       ArrayRef<std::string> Shared,
+                                       StringRef Suffix) const {
+  // The pieces do not share any IR with each other, so each one is read back
+  // into a context of its own.
+  LLVMContext Context;
+  Context.setDiagnosticHandler(forwardDiagnostic, &MainContext);
+  Context.setInlineAsmDiagnosticHandler(forwardInlineAsmDiagnostic,
+                                        &MainContext);
+
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M =
+      parseIR(MemoryBufferRef(Part.Bitcode.str(), "<parallel-codegen>"), Err,
+              Context);
+  if (!M) {
+    Part.Failed = true;
+    return;
+  }
+
+  for (const std::string &Name : Shared)
+    if (GlobalValue *GV = M->getNamedValue(Name))
+      GV->setName(Name + Suffix);
+
+  PassManager PM;
+  PM.add(new DataLayoutPass(M.get()));
+  llvm::Triple TargetTriple(M->getTargetTriple());
+  PM.add(createTLI(TargetTriple, CodeGenOpts));
+  Part.TM->addAnalysisPasses(PM);
+  if (LangOpts.ObjCAutoRefCount && CodeGenOpts.OptimizationLevel > 0)
+    PM.add(createObjCARCContractPass());
+
+  raw_svector_ostream OS(Part.Object);
+  formatted_raw_ostream FOS(OS);
+  if (Part.TM->addPassesToEmitFile(
+          PM, FOS, TargetMachine::CGFT_ObjectFile,
+          /*DisableVerify=*/!CodeGenOpts.VerifyModule)) {
+    Part.Failed = true;
+    return;
+  }
+  PM.run(*M);
+}
+
+/// \brief Writes the object files of \p Parts to temporary files, whose names
+/// are appended to \p TempFiles, and combines them with a relocatable link
+/// by \p Linker into a file whose contents are written to \p OS.
+///
+/// \returns An empty string on success, or the reason of the failure.
+static std::string linkObjects(const std::string &Linker,
+                               ArrayRef<CodeGenPartition> Parts,
+                               raw_ostream &OS,
+                               std::vector<std::string> &TempFiles) {
+  for (const CodeGenPartition &Part : Parts) {
+    SmallString<128> Path;
+    int FD;
+    if (std::error_code EC =
+            sys::fs::createTemporaryFile("parallel-codegen", "o", FD, Path))
+      return EC.message();
+    TempFiles.push_back(Path.str());
+
+    raw_fd_ostream File(FD, /*shouldClose=*/true);
+    File << Part.Object;
+    File.close();
+    if (File.has_error()) {
+      File.clear_error();
+      return "cannot write '" + TempFiles.back() + "'";
+    }
+  }
+
+  SmallString<128> Output;
+  int FD;
+  if (std::error_code EC =
+          sys::fs::createTemporaryFile("parallel-codegen", "o", FD, Output))
+    return EC.message();
+  raw_fd_ostream(FD, /*shouldClose=*/true).close();
+  TempFiles.push_back(Output.str());
+
+  std::vector<const char *> Args;
+  Args.push_back(Linker.c_str());
+  Args.push_back("-r");
+  Args.push_back("-o");
+  Args.push_back(TempFiles.back().c_str());
+  for (unsigned I = 0, E = Parts.size(); I != E; ++I)
+    Args.push_back(TempFiles[I].c_str());
+  Args.push_back(nullptr);
+
+  std::string ErrMsg;
+  if (sys::ExecuteAndWait(Linker, Args.data(), nullptr, nullptr, 0, 0,
+                          &ErrMsg) != 0)
+    return ErrMsg.empty() ? "'" + Linker + "' failed" : ErrMsg;
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> Buffer =
+      MemoryBuffer::getFile(TempFiles.back());
+  if (std::error_code EC = Buffer.getError())
+    return EC.message();
+  OS << (*Buffer)->getBuffer();
+  return std::string();
+}
+
+bool EmitAssemblyHelper::LinkPartitions(ArrayRef<CodeGenPartition> Parts,
+                                        raw_ostream &OS) {
+  std::string Linker = CodeGenOpts.ParallelCodeGenLinker;
+  if (Linker.empty())
+    Linker = sys::FindProgramByName("ld");
+  if (Linker.empty()) {
+    Diags.Report(diag::err_fe_parallel_codegen_link)
+        << "cannot find the linker";
+    return false;
+  }
+
+  std::vector<std::string> TempFiles;
+  std::string Error = linkObjects(Linker, Parts, OS, TempFiles);
+  for (const std::string &File : TempFiles)
+    sys::fs::remove(File);
+
+  if (!Error.empty()) {
+    Diags.Report(diag::err_fe_parallel_codegen_link) << Error;
+    return false;
+  }
+  return true;
+}
+
+void EmitAssemblyHelper::EmitObjectInParallel(formatted_raw_ostream &OS) {
+  PartitionMap Partitions;
+  unsigned NumPartitions =
+      partitionModule(*TheModule, CodeGenOpts.ParallelCodeGen, Partitions);
+
+  // There is nothing to split: generate the code of the module as usual.
+  if (NumPartitions < 2) {
+    if (AddEmitPasses(Backend_EmitObj, OS))
+      CodeGenPasses->run(*TheModule);
+    return;
+  }
+
+  std::vector<std::string> Shared;
+  externalizeLocals(*TheModule, Partitions, Shared);
+
+  // Split the module on this thread: the pieces are then independent of
+  // the context of the module.
+  std::vector<CodeGenPartition> Parts(NumPartitions);
+  for (unsigned P = 0; P != NumPartitions; ++P) {
+    std::unique_ptr<Module> M(extractPartition(*TheModule, P, Partitions));
+    raw_svector_ostream BOS(Parts[P].Bitcode);
+    WriteBitcodeToFile(M.get(), BOS);
+    BOS.flush();
+
+    Parts[P].TM.reset(cloneTargetMachine(*TM));
+    if (!Parts[P].TM) {
+      Diags.Report(diag::err_fe_unable_to_interface_with_target);
+      return;
+    }
+  }
+
+  // The suffix of the shared symbols hashes the bitcode of the pieces, so
+  // the pieces append it themselves once they are read back.
+  std::string Suffix = getUniqueSuffix(*TheModule, Parts);
+
+  LLVMContext &MainContext = TheModule->getContext();
+  std::vector<std::thread> Threads;
+  for (unsigned P = 1; P != NumPartitions; ++P)
+    Threads.push_back(
+        std::thread([this, &Parts, &MainContext, &Shared, &Suffix, P] {
+          EmitPartition(Parts[P], MainContext, Shared, Suffix);
+        }));
+  EmitPartition(Parts[0], MainContext, Shared, Suffix);
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (const CodeGenPartition &Part : Parts)
+    if (Part.Failed) {
+      Diags.Report(diag::err_fe_unable_to_interface_with_target);
+      return;
+    }
+
+  LinkPartitions(Parts, OS);
+}
+
 void EmitAssemblyHelper::EmitAssembly(BackendAction Action, raw_ostream *OS) {
   TimeRegion Region(llvm::TimePassesIsEnabled ? &CodeGenerationTime : nullptr);
   llvm::formatted_raw_ostream FormattedOS;
@@ -545,6 +1037,8 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action, raw_ostream *OS) {
   if (UsesCodeGen && !TM) return;
   CreatePasses();
 
+  bool Parallel = shouldEmitInParallel(Action);
+
   switch (Action) {
   case Backend_EmitNothing:
     break;
@@ -560,7 +1054,7 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action, raw_ostream *OS) {
 
   default:
     FormattedOS.setStream(*OS, formatted_raw_ostream::PRESERVE_STREAM);
-    if (!AddEmitPasses(Action, FormattedOS))
+    if (!Parallel && !AddEmitPasses(Action, FormattedOS))
       return;
   }
 
@@ -589,6 +1083,9 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action, raw_ostream *OS) {
   if (CodeGenPasses) {
     PrettyStackTraceString CrashInfo("Code generation");
     CodeGenPasses->run(*TheModule);
+  } else if (Parallel) {
+    PrettyStackTraceString CrashInfo("Parallel code generation");
+    EmitObjectInParallel(FormattedOS);
   }
 }
 
@@ -598,6 +1095,7 @@ void clang::EmitBackendOutput(DiagnosticsEngine &Diags,
                               const LangOptions &LOpts, StringRef TDesc,
                               Module *M, BackendAction Action,
                               raw_ostream *OS) {
+  TimeTraceScope TimeScope("Backend");
   EmitAssemblyHelper AsmHelper(Diags, CGOpts, TOpts, LOpts, M);
 
   AsmHelper.EmitAssembly(Action, OS);
@@ -41,7 +41,11 @@ namespace {
       assert(lvalue.isSimple());
 
       AtomicTy = lvalue.getType();
-      ValueTy = AtomicTy->castAs<AtomicType>()->getValueType();
+      // The objects updated by OpenMP atomic constructs have no atomic type.
+      if (const AtomicType *ATy = AtomicTy->getAs<AtomicType>())
+        ValueTy = ATy->getValueType();
+      else
+        ValueTy = AtomicTy;
       EvaluationKind = CGF.getEvaluationKind(ValueTy);
 
       ASTContext &C = CGF.getContext();
@@ -120,6 +124,13 @@ namespace {
     /// Materialize an atomic r-value in atomic-layout memory.
     llvm::Value *materializeRValue(RValue rvalue) const;
 
+    /// Turn an r-value into the integer value of a native atomic operation.
+    llvm::Value *convertRValueToInt(RValue rvalue) const;
+
+    /// Turn the integer value of a native atomic operation into an
+    /// r-value, which must not be an aggregate.
+    RValue convertIntToValue(llvm::Value *intValue, SourceLocation loc) const;
+
   private:
     bool requiresMemSetZero(llvm::Type *type) const;
   };
@@ -137,6 +148,23 @@ static RValue emitAtomicLibcall(CodeGenFunction &CGF,
   return CGF.EmitCall(fnInfo, fn, ReturnValueSlot(), args);
 }
 
+/// Returns the memory_order argument of the atomic library functions which
+/// corresponds to \p AO.
+static int getAtomicABIOrdering(llvm::AtomicOrdering AO) {
+  switch (AO) {
+  case llvm::Monotonic:
+    return AtomicExpr::AO_ABI_memory_order_relaxed;
+  case llvm::Acquire:
+    return AtomicExpr::AO_ABI_memory_order_acquire;
+  case llvm::Release:
+    return AtomicExpr::AO_ABI_memory_order_release;
+  case llvm::AcquireRelease:
+    return AtomicExpr::AO_ABI_memory_order_acq_rel;
+  default:
+    return AtomicExpr::AO_ABI_memory_order_seq_cst;
+  }
+}
+
 /// Does a store of the given IR type modify the full expected width?
 static bool isFullSizeType(CodeGenModule &CGM, llvm::Type *type,
                            uint64_t expectedSize) {
@@ -907,7 +935,8 @@ RValue AtomicInfo::convertTempToRValue(llvm::Value *addr,
 /// Emit a load from an l-value of atomic type.  Note that the r-value
 /// we produce is an r-value of the atomic *value* type.
 RValue CodeGenFunction::EmitAtomicLoad(LValue src, SourceLocation loc,
-                                       AggValueSlot resultSlot) {
+                                       AggValueSlot resultSlot,
+                                       llvm::AtomicOrdering AO) {
   AtomicInfo atomics(*this, src);
 
   // Check whether we should use a library call.
@@ -928,8 +957,8 @@ RValue CodeGenFunction::EmitAtomicLoad(LValue src, SourceLocation loc,
              getContext().VoidPtrTy);
     args.add(RValue::get(EmitCastToVoidPtr(tempAddr)),
              getContext().VoidPtrTy);
-    args.add(RValue::get(llvm::ConstantInt::get(
-                 IntTy, AtomicExpr::AO_ABI_memory_order_seq_cst)),
+    args.add(RValue::get(llvm::ConstantInt::get(IntTy,
+                                                getAtomicABIOrdering(AO))),
              getContext().IntTy);
     emitAtomicLibcall(*this, "__atomic_load", getContext().VoidTy, args);
 
@@ -940,7 +969,7 @@ RValue CodeGenFunction::EmitAtomicLoad(LValue src, SourceLocation loc,
   // Okay, we're doing this natively.
   llvm::Value *addr = atomics.emitCastToAtomicIntPointer(src.getAddress());
   llvm::LoadInst *load = Builder.CreateLoad(addr, "atomic-load");
-  load->setAtomic(llvm::SequentiallyConsistent);
+  load->setAtomic(AO);
 
   // Other decoration.
   load->setAlignment(src.getAlignment().getQuantity());
@@ -1050,7 +1079,54 @@ llvm::Value *AtomicInfo::materializeRValue(RValue rvalue) const {
 /// Note that the r-value is expected to be an r-value *of the atomic
 /// type*; this means that for aggregate r-values, it should include
 /// storage for any padding that was necessary.
-void CodeGenFunction::EmitAtomicStore(RValue rvalue, LValue dest, bool isInit) {
+llvm::Value *AtomicInfo::convertRValueToInt(RValue rvalue) const {
+  // If we've got a scalar value of the right size, try to avoid going
+  // through memory.
+  if (rvalue.isScalar() && !hasPadding()) {
+    llvm::Value *value = rvalue.getScalarVal();
+    if (isa<llvm::IntegerType>(value->getType()))
+      return value;
+    llvm::IntegerType *inputIntTy =
+      llvm::IntegerType::get(CGF.getLLVMContext(), getValueSizeInBits());
+    if (isa<llvm::PointerType>(value->getType()))
+      return CGF.Builder.CreatePtrToInt(value, inputIntTy);
+    return CGF.Builder.CreateBitCast(value, inputIntTy);
+  }
+
+  // Otherwise, we need to go through memory.
+  // Put the r-value in memory.
+  llvm::Value *addr = materializeRValue(rvalue);
+
+  // Cast the temporary to the atomic int type and pull a value out.
+  addr = emitCastToAtomicIntPointer(addr);
+  return CGF.Builder.CreateAlignedLoad(addr,
+                                       getAtomicAlignment().getQuantity());
+}
+
+RValue AtomicInfo::convertIntToValue(llvm::Value *intValue,
+                                     SourceLocation loc) const {
+  assert(EvaluationKind != TEK_Aggregate && "cannot convert to aggregate");
+
+  // The easiest way to do this this is to go through memory, but we
+  // try not to in some easy cases.
+  if (EvaluationKind == TEK_Scalar && !hasPadding()) {
+    llvm::Type *valueTy = CGF.ConvertTypeForMem(ValueTy);
+    if (isa<llvm::IntegerType>(valueTy))
+      return RValue::get(CGF.EmitFromMemory(intValue, ValueTy));
+    if (isa<llvm::PointerType>(valueTy))
+      return RValue::get(CGF.Builder.CreateIntToPtr(intValue, valueTy));
+    return RValue::get(CGF.Builder.CreateBitCast(intValue, valueTy));
+  }
+
+  // Slam the integer into a temporary.
+  llvm::Value *temp = CGF.CreateMemTemp(AtomicTy, "atomic-temp");
+  CGF.Builder.CreateAlignedStore(intValue, emitCastToAtomicIntPointer(temp),
+                                 AtomicAlign.getQuantity());
+  return convertTempToRValue(temp, AggValueSlot::ignored(), loc);
+}
+
+void CodeGenFunction::EmitAtomicStore(RValue rvalue, LValue dest, bool isInit,
+                                      llvm::AtomicOrdering AO) {
   // If this is an aggregate r-value, it should agree in type except
   // maybe for address-space qualification.
   assert(!rvalue.isAggregate() ||
@@ -1078,49 +1154,22 @@ void CodeGenFunction::EmitAtomicStore(RValue rvalue, LValue dest, bool isInit) {
              getContext().VoidPtrTy);
     args.add(RValue::get(EmitCastToVoidPtr(srcAddr)),
              getContext().VoidPtrTy);
-    args.add(RValue::get(llvm::ConstantInt::get(
-                 IntTy, AtomicExpr::AO_ABI_memory_order_seq_cst)),
+    args.add(RValue::get(llvm::ConstantInt::get(IntTy,
+                                                getAtomicABIOrdering(AO))),
              getContext().IntTy);
     emitAtomicLibcall(*this, "__atomic_store", getContext().VoidTy, args);
     return;
   }
 
   // Okay, we're doing this natively.
-  llvm::Value *intValue;
-
-  // If we've got a scalar value of the right size, try to avoid going
-  // through memory.
-  if (rvalue.isScalar() && !atomics.hasPadding()) {
-    llvm::Value *value = rvalue.getScalarVal();
-    if (isa<llvm::IntegerType>(value->getType())) {
-      intValue = value;
-    } else {
-      llvm::IntegerType *inputIntTy =
-        llvm::IntegerType::get(getLLVMContext(), atomics.getValueSizeInBits());
-      if (isa<llvm::PointerType>(value->getType())) {
-        intValue = Builder.CreatePtrToInt(value, inputIntTy);
-      } else {
-        intValue = Builder.CreateBitCast(value, inputIntTy);
-      }
-    }
-
-  // Otherwise, we need to go through memory.
-  } else {
-    // Put the r-value in memory.
-    llvm::Value *addr = atomics.materializeRValue(rvalue);
-
-    // Cast the temporary to the atomic int type and pull a value out.
-    addr = atomics.emitCastToAtomicIntPointer(addr);
-    intValue = Builder.CreateAlignedLoad(addr,
-                                 atomics.getAtomicAlignment().getQuantity());
-  }
+  llvm::Value *intValue = atomics.convertRValueToInt(rvalue);
 
   // Do the atomic store.
   llvm::Value *addr = atomics.emitCastToAtomicIntPointer(dest.getAddress());
   llvm::StoreInst *store = Builder.CreateStore(intValue, addr);
 
   // Initializations don't need to be atomic.
-  if (!isInit) store->setAtomic(llvm::SequentiallyConsistent);
+  if (!isInit) store->setAtomic(AO);
 
   // Other decoration.
   store->setAlignment(dest.getAlignment().getQuantity());
@@ -1130,6 +1179,102 @@ void CodeGenFunction::EmitAtomicStore(RValue rvalue, LValue dest, bool isInit) {
     CGM.DecorateInstruction(store, dest.getTBAAInfo());
 }
 
+std::pair<RValue, RValue>
+CodeGenFunction::EmitAtomicUpdate(LValue lvalue, SourceLocation loc,
+                                  llvm::AtomicOrdering AO,
+                                  llvm::function_ref<RValue(RValue)> UpdateOp) {
+  AtomicInfo atomics(*this, lvalue);
+  assert(atomics.getEvaluationKind() != TEK_Aggregate &&
+         "cannot update an aggregate atomically");
+  llvm::BasicBlock *ContBB = createBasicBlock("atomic_cont");
+  llvm::BasicBlock *ExitBB = createBasicBlock("atomic_exit");
+
+  // Check whether we should use a library call.
+  if (atomics.shouldUseLibcall()) {
+    llvm::Value *expectedAddr =
+      CreateMemTemp(atomics.getAtomicType(), "atomic-expected");
+    llvm::Value *desiredAddr =
+      CreateMemTemp(atomics.getAtomicType(), "atomic-desired");
+
+    // void __atomic_load(size_t size, void *mem, void *return, int order);
+    CallArgList loadArgs;
+    loadArgs.add(RValue::get(atomics.getAtomicSizeValue()),
+                 getContext().getSizeType());
+    loadArgs.add(RValue::get(EmitCastToVoidPtr(lvalue.getAddress())),
+                 getContext().VoidPtrTy);
+    loadArgs.add(RValue::get(EmitCastToVoidPtr(expectedAddr)),
+                 getContext().VoidPtrTy);
+    loadArgs.add(RValue::get(llvm::ConstantInt::get(
+                     IntTy, AtomicExpr::AO_ABI_memory_order_relaxed)),
+                 getContext().IntTy);
+    emitAtomicLibcall(*this, "__atomic_load", getContext().VoidTy, loadArgs);
+
+    EmitBlock(ContBB);
+    RValue oldValue = atomics.convertTempToRValue(
+        expectedAddr, AggValueSlot::ignored(), loc);
+    RValue newValue = UpdateOp(oldValue);
+    atomics.emitCopyIntoMemory(
+        newValue, MakeAddrLValue(desiredAddr, atomics.getAtomicType(),
+                                 atomics.getAtomicAlignment()));
+
+    // bool __atomic_compare_exchange(size_t size, void *obj, void *expected,
+    //                                void *desired, int success, int failure);
+    // On failure, the current value is stored into *expected.
+    CallArgList args;
+    args.add(RValue::get(atomics.getAtomicSizeValue()),
+             getContext().getSizeType());
+    args.add(RValue::get(EmitCastToVoidPtr(lvalue.getAddress())),
+             getContext().VoidPtrTy);
+    args.add(RValue::get(EmitCastToVoidPtr(expectedAddr)),
+             getContext().VoidPtrTy);
+    args.add(RValue::get(EmitCastToVoidPtr(desiredAddr)),
+             getContext().VoidPtrTy);
+    args.add(RValue::get(llvm::ConstantInt::get(IntTy,
+                                                getAtomicABIOrdering(AO))),
+             getContext().IntTy);
+    args.add(RValue::get(llvm::ConstantInt::get(
+                 IntTy, getAtomicABIOrdering(
+                     llvm::AtomicCmpXchgInst::getStrongestFailureOrdering(
+                         AO)))),
+             getContext().IntTy);
+    RValue success = emitAtomicLibcall(*this, "__atomic_compare_exchange",
+                                       getContext().BoolTy, args);
+    Builder.CreateCondBr(success.getScalarVal(), ExitBB, ContBB);
+    EmitBlock(ExitBB);
+    return std::make_pair(oldValue, newValue);
+  }
+
+  // Okay, we're doing this natively: load the value, and compute the new
+  // one until the compare-and-exchange succeeds.
+  llvm::Value *addr = atomics.emitCastToAtomicIntPointer(lvalue.getAddress());
+  llvm::LoadInst *load = Builder.CreateLoad(addr, "atomic-load");
+  load->setAtomic(llvm::Monotonic);
+  load->setAlignment(lvalue.getAlignment().getQuantity());
+  if (lvalue.isVolatileQualified())
+    load->setVolatile(true);
+
+  llvm::BasicBlock *entryBB = Builder.GetInsertBlock();
+  EmitBlock(ContBB);
+  llvm::PHINode *oldInt = Builder.CreatePHI(load->getType(), 2, "atomic-old");
+  oldInt->addIncoming(load, entryBB);
+  RValue oldValue = atomics.convertIntToValue(oldInt, loc);
+  RValue newValue = UpdateOp(oldValue);
+  RValue newMemValue = newValue;
+  if (newValue.isScalar())
+    newMemValue = RValue::get(
+        EmitToMemory(newValue.getScalarVal(), atomics.getValueType()));
+  llvm::Value *newInt = atomics.convertRValueToInt(newMemValue);
+  llvm::AtomicCmpXchgInst *pair = Builder.CreateAtomicCmpXchg(
+      addr, oldInt, newInt, AO,
+      llvm::AtomicCmpXchgInst::getStrongestFailureOrdering(AO));
+  pair->setVolatile(lvalue.isVolatileQualified());
+  oldInt->addIncoming(Builder.CreateExtractValue(pair, 0),
+                      Builder.GetInsertBlock());
+  Builder.CreateCondBr(Builder.CreateExtractValue(pair, 1), ExitBB, ContBB);
+  EmitBlock(ExitBB);
+  return std::make_pair(oldValue, newValue);
+}
+
 void CodeGenFunction::EmitAtomicInit(Expr *init, LValue dest) {
   AtomicInfo atomics(*this, dest);
 
@@ -1888,8 +1888,10 @@ LValue CodeGenFunction::EmitDeclRefLValue(const DeclRefExpr *E) {
   }
 
   if (const auto *VD = dyn_cast<VarDecl>(ND)) {
-    // Check if this is a global variable.
-    if (VD->hasLinkage() || VD->isStaticDataMember())
+    // Check if this is a global variable which is not privatized by an
+    // OpenMP directive.
+    if ((VD->hasLinkage() || VD->isStaticDataMember()) &&
+        !LocalDeclMap.count(VD))
       return EmitGlobalVarDeclLValue(*this, E, VD);
 
     bool isBlockVariable = VD->hasAttr<BlocksAttr>();
@@ -34,6 +34,14 @@ CGOpenMPRuntime::CGOpenMPRuntime(CodeGenModule &CGM)
   llvm::Type *MicroParams[] = {llvm::PointerType::getUnqual(CGM.Int32Ty),
                                llvm::PointerType::getUnqual(CGM.Int32Ty)};
   Kmpc_MicroTy = llvm::FunctionType::get(CGM.VoidTy, MicroParams, true);
+  // Build kmp_int32 (*kmp_routine_entry_t)(kmp_int32, void *)
+  llvm::Type *EntryParams[] = {CGM.Int32Ty, CGM.VoidPtrTy};
+  KmpRoutineEntryTy = llvm::FunctionType::get(CGM.Int32Ty, EntryParams, false);
+  KmpTaskTTy = llvm::StructType::create(
+      "kmp_task_t", CGM.VoidPtrTy /* shareds */,
+      getKmpRoutineEntryPointerTy() /* routine */, CGM.Int32Ty /* part_id */,
+      NULL);
+  KmpCriticalNameTy = llvm::ArrayType::get(CGM.Int32Ty, /*NumElements*/ 8);
 }
 
 llvm::Value *
@@ -62,6 +70,7 @@ CGOpenMPRuntime::GetOrCreateDefaultOpenMPLocation(OpenMPLocationFlags Flags) {
                                 Zero, Zero, DefaultOpenMPPSource};
     llvm::Constant *Init = llvm::ConstantStruct::get(IdentTy, Values);
     DefaultOpenMPLocation->setInitializer(Init);
+    OpenMPDefaultLocMap[Flags] = DefaultOpenMPLocation;
     return DefaultOpenMPLocation;
   }
   return Entry;
@@ -174,6 +183,24 @@ llvm::Type *CGOpenMPRuntime::getKmpc_MicroPointerTy() {
   return llvm::PointerType::getUnqual(Kmpc_MicroTy);
 }
 
+llvm::Type *CGOpenMPRuntime::getKmpRoutineEntryPointerTy() {
+  return llvm::PointerType::getUnqual(KmpRoutineEntryTy);
+}
+
+llvm::Value *CGOpenMPRuntime::getCriticalRegionLock(StringRef CriticalName) {
+  llvm::Value *&Lock = CriticalRegionVarNames[CriticalName];
+  if (!Lock) {
+    llvm::GlobalVariable *GV = cast<llvm::GlobalVariable>(
+        CGM.CreateRuntimeVariable(KmpCriticalNameTy,
+                                  (".gomp_critical_user_" + CriticalName +
+                                   ".var").str()));
+    GV->setLinkage(llvm::GlobalValue::CommonLinkage);
+    GV->setInitializer(llvm::Constant::getNullValue(KmpCriticalNameTy));
+    Lock = GV;
+  }
+  return Lock;
+}
+
 llvm::Constant *
 CGOpenMPRuntime::CreateRuntimeFunction(OpenMPRTLFunction Function) {
   llvm::Constant *RTLFn = nullptr;
@@ -196,6 +223,481 @@ CGOpenMPRuntime::CreateRuntimeFunction(OpenMPRTLFunction Function) {
     RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_global_thread_num");
     break;
   }
+  case OMPRTL__kmpc_barrier: {
+    // Build void __kmpc_barrier(ident_t *loc, kmp_int32 global_tid);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_barrier");
+    break;
+  }
+  case OMPRTL__kmpc_for_static_fini: {
+    // Build void __kmpc_for_static_fini(ident_t *loc, kmp_int32 global_tid);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_for_static_fini");
+    break;
+  }
+  case OMPRTL__kmpc_omp_task_alloc: {
+    // Build kmp_task_t *__kmpc_omp_task_alloc(ident_t *loc, kmp_int32
+    // global_tid, kmp_int32 flags, size_t sizeof_kmp_task_t, size_t
+    // sizeof_shareds, kmp_routine_entry_t task_entry);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty,
+                                CGM.Int32Ty,           CGM.SizeTy,
+                                CGM.SizeTy, getKmpRoutineEntryPointerTy()};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.VoidPtrTy, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_omp_task_alloc");
+    break;
+  }
+  case OMPRTL__kmpc_omp_task: {
+    // Build kmp_int32 __kmpc_omp_task(ident_t *loc, kmp_int32 global_tid,
+    // kmp_task_t *new_task);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty,
+                                CGM.VoidPtrTy};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.Int32Ty, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_omp_task");
+    break;
+  }
+  case OMPRTL__kmpc_omp_task_begin_if0: {
+    // Build void __kmpc_omp_task_begin_if0(ident_t *loc, kmp_int32 global_tid,
+    // kmp_task_t *new_task);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty,
+                                CGM.VoidPtrTy};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_omp_task_begin_if0");
+    break;
+  }
+  case OMPRTL__kmpc_omp_task_complete_if0: {
+    // Build void __kmpc_omp_task_complete_if0(ident_t *loc, kmp_int32
+    // global_tid, kmp_task_t *new_task);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty,
+                                CGM.VoidPtrTy};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_omp_task_complete_if0");
+    break;
+  }
+  case OMPRTL__kmpc_omp_taskwait: {
+    // Build kmp_int32 __kmpc_omp_taskwait(ident_t *loc, kmp_int32 global_tid);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.Int32Ty, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_omp_taskwait");
+    break;
+  }
+  case OMPRTL__kmpc_omp_taskyield: {
+    // Build kmp_int32 __kmpc_omp_taskyield(ident_t *loc, kmp_int32 global_tid,
+    // int end_part);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty,
+                                CGM.IntTy};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.Int32Ty, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, "__kmpc_omp_taskyield");
+    break;
+  }
+  case OMPRTL__kmpc_reduce:
+  case OMPRTL__kmpc_reduce_nowait: {
+    // Build kmp_int32 __kmpc_reduce{_nowait}(ident_t *loc, kmp_int32
+    // global_tid, kmp_int32 num_vars, size_t reduce_size, void *reduce_data,
+    // void (*reduce_func)(void *lhs_data, void *rhs_data), kmp_critical_name
+    // *lck);
+    llvm::Type *ReduceTypeParams[] = {CGM.VoidPtrTy, CGM.VoidPtrTy};
+    llvm::FunctionType *ReduceFnTy =
+        llvm::FunctionType::get(CGM.VoidTy, ReduceTypeParams, false);
+    llvm::Type *TypeParams[] = {
+        getIdentTyPointerTy(), CGM.Int32Ty, CGM.Int32Ty, CGM.SizeTy,
+        CGM.VoidPtrTy, ReduceFnTy->getPointerTo(),
+        llvm::PointerType::getUnqual(KmpCriticalNameTy)};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.Int32Ty, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, Function == OMPRTL__kmpc_reduce
+                                                ? "__kmpc_reduce"
+                                                : "__kmpc_reduce_nowait");
+    break;
+  }
+  case OMPRTL__kmpc_end_reduce:
+  case OMPRTL__kmpc_end_reduce_nowait: {
+    // Build void __kmpc_end_reduce{_nowait}(ident_t *loc, kmp_int32
+    // global_tid, kmp_critical_name *lck);
+    llvm::Type *TypeParams[] = {
+        getIdentTyPointerTy(), CGM.Int32Ty,
+        llvm::PointerType::getUnqual(KmpCriticalNameTy)};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy,
+                                      Function == OMPRTL__kmpc_end_reduce
+                                          ? "__kmpc_end_reduce"
+                                          : "__kmpc_end_reduce_nowait");
+    break;
+  }
+  case OMPRTL__kmpc_critical:
+  case OMPRTL__kmpc_end_critical: {
+    // Build void __kmpc_{end_}critical(ident_t *loc, kmp_int32 global_tid,
+    // kmp_critical_name *crit);
+    llvm::Type *TypeParams[] = {
+        getIdentTyPointerTy(), CGM.Int32Ty,
+        llvm::PointerType::getUnqual(KmpCriticalNameTy)};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, Function == OMPRTL__kmpc_critical
+                                                ? "__kmpc_critical"
+                                                : "__kmpc_end_critical");
+    break;
+  }
+  case OMPRTL__kmpc_master:
+  case OMPRTL__kmpc_single: {
+    // Build kmp_int32 __kmpc_{master|single}(ident_t *loc, kmp_int32
+    // global_tid);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.Int32Ty, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, Function == OMPRTL__kmpc_master
+                                                ? "__kmpc_master"
+                                                : "__kmpc_single");
+    break;
+  }
+  case OMPRTL__kmpc_end_master:
+  case OMPRTL__kmpc_end_single: {
+    // Build void __kmpc_end_{master|single}(ident_t *loc, kmp_int32
+    // global_tid);
+    llvm::Type *TypeParams[] = {getIdentTyPointerTy(), CGM.Int32Ty};
+    llvm::FunctionType *FnTy =
+        llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+    RTLFn = CGM.CreateRuntimeFunction(FnTy, Function == OMPRTL__kmpc_end_master
+                                                ? "__kmpc_end_master"
+                                                : "__kmpc_end_single");
+    break;
+  }
   }
   return RTLFn;
 }
+
+llvm::Constant *CGOpenMPRuntime::CreateForStaticInitFunction(unsigned IVSize,
+                                                             bool IVSigned) {
+  assert((IVSize == 32 || IVSize == 64) &&
+         "IV size is not compatible with the omp runtime");
+  const char *Name = IVSize == 32 ? (IVSigned ? "__kmpc_for_static_init_4"
+                                               : "__kmpc_for_static_init_4u")
+                                  : (IVSigned ? "__kmpc_for_static_init_8"
+                                              : "__kmpc_for_static_init_8u");
+  llvm::Type *ITy = IVSize == 32 ? CGM.Int32Ty : CGM.Int64Ty;
+  llvm::Type *PtrTy = llvm::PointerType::getUnqual(ITy);
+  // Build void __kmpc_for_static_init_*(ident_t *loc, kmp_int32 global_tid,
+  // kmp_int32 schedtype, kmp_int32 *p_lastiter, IV *p_lower, IV *p_upper,
+  // IV *p_stride, IV incr, IV chunk);
+  llvm::Type *TypeParams[] = {
+      getIdentTyPointerTy(),                     // loc
+      CGM.Int32Ty,                               // global_tid
+      CGM.Int32Ty,                               // schedtype
+      llvm::PointerType::getUnqual(CGM.Int32Ty), // p_lastiter
+      PtrTy,                                     // p_lower
+      PtrTy,                                     // p_upper
+      PtrTy,                                     // p_stride
+      ITy,                                       // incr
+      ITy                                        // chunk
+  };
+  llvm::FunctionType *FnTy =
+      llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+  return CGM.CreateRuntimeFunction(FnTy, Name);
+}
+
+llvm::Constant *CGOpenMPRuntime::CreateDispatchInitFunction(unsigned IVSize,
+                                                            bool IVSigned) {
+  assert((IVSize == 32 || IVSize == 64) &&
+         "IV size is not compatible with the omp runtime");
+  const char *Name = IVSize == 32 ? (IVSigned ? "__kmpc_dispatch_init_4"
+                                               : "__kmpc_dispatch_init_4u")
+                                  : (IVSigned ? "__kmpc_dispatch_init_8"
+                                              : "__kmpc_dispatch_init_8u");
+  llvm::Type *ITy = IVSize == 32 ? CGM.Int32Ty : CGM.Int64Ty;
+  // Build void __kmpc_dispatch_init_*(ident_t *loc, kmp_int32 global_tid,
+  // kmp_int32 schedtype, IV lower, IV upper, IV stride, IV chunk);
+  llvm::Type *TypeParams[] = {
+      getIdentTyPointerTy(), // loc
+      CGM.Int32Ty,           // global_tid
+      CGM.Int32Ty,           // schedtype
+      ITy,                   // lower
+      ITy,                   // upper
+      ITy,                   // stride
+      ITy                    // chunk
+  };
+  llvm::FunctionType *FnTy =
+      llvm::FunctionType::get(CGM.VoidTy, TypeParams, false);
+  return CGM.CreateRuntimeFunction(FnTy, Name);
+}
+
+llvm::Constant *CGOpenMPRuntime::CreateDispatchNextFunction(unsigned IVSize,
+                                                            bool IVSigned) {
+  assert((IVSize == 32 || IVSize == 64) &&
+         "IV size is not compatible with the omp runtime");
+  const char *Name = IVSize == 32 ? (IVSigned ? "__kmpc_dispatch_next_4"
+                                               : "__kmpc_dispatch_next_4u")
+                                  : (IVSigned ? "__kmpc_dispatch_next_8"
+                                              : "__kmpc_dispatch_next_8u");
+  llvm::Type *PtrTy =
+      llvm::PointerType::getUnqual(IVSize == 32 ? CGM.Int32Ty : CGM.Int64Ty);
+  // Build kmp_int32 __kmpc_dispatch_next_*(ident_t *loc, kmp_int32 global_tid,
+  // kmp_int32 *p_lastiter, IV *p_lower, IV *p_upper, IV *p_stride);
+  llvm::Type *TypeParams[] = {
+      getIdentTyPointerTy(),                     // loc
+      CGM.Int32Ty,                               // global_tid
+      llvm::PointerType::getUnqual(CGM.Int32Ty), // p_lastiter
+      PtrTy,                                     // p_lower
+      PtrTy,                                     // p_upper
+      PtrTy                                      // p_stride
+  };
+  llvm::FunctionType *FnTy =
+      llvm::FunctionType::get(CGM.Int32Ty, TypeParams, false);
+  return CGM.CreateRuntimeFunction(FnTy, Name);
+}
+
+CGOpenMPRuntime::OpenMPSchedType
+CGOpenMPRuntime::getSchedType(OpenMPScheduleClauseKind ScheduleKind,
+                              bool Chunked) {
+  switch (ScheduleKind) {
+  case OMPC_SCHEDULE_static:
+    return Chunked ? OMP_sch_static_chunked : OMP_sch_static;
+  case OMPC_SCHEDULE_dynamic:
+    return OMP_sch_dynamic_chunked;
+  case OMPC_SCHEDULE_guided:
+    return OMP_sch_guided_chunked;
+  case OMPC_SCHEDULE_auto:
+    return OMP_sch_auto;
+  case OMPC_SCHEDULE_runtime:
+    return OMP_sch_runtime;
+  case OMPC_SCHEDULE_unknown:
+    // The default schedule is implementation defined; use static.
+    assert(!Chunked && "chunk size without schedule kind");
+    return OMP_sch_static;
+  }
+  llvm_unreachable("Unexpected schedule kind.");
+}
+
+void CGOpenMPRuntime::EmitOMPBarrierCall(CodeGenFunction &CGF,
+                                         SourceLocation Loc,
+                                         OpenMPLocationFlags Flags) {
+  // Build call __kmpc_barrier(loc, thread_id);
+  llvm::Value *Args[] = {
+      EmitOpenMPUpdateLocation(
+          CGF, Loc, static_cast<OpenMPLocationFlags>(OMP_IDENT_KMPC | Flags)),
+      GetOpenMPGlobalThreadNum(CGF, Loc)};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_barrier), Args);
+}
+
+void CGOpenMPRuntime::EmitOMPForInit(CodeGenFunction &CGF, SourceLocation Loc,
+                                     OpenMPSchedType Schedule,
+                                     unsigned IVSize, bool IVSigned,
+                                     llvm::Value *IL, llvm::Value *LB,
+                                     llvm::Value *UB, llvm::Value *ST,
+                                     llvm::Value *Chunk) {
+  llvm::Type *ITy = IVSize == 32 ? CGM.Int32Ty : CGM.Int64Ty;
+  if (!Chunk)
+    Chunk = llvm::ConstantInt::get(ITy, 1);
+  if (isStaticSchedule(Schedule)) {
+    // Build call __kmpc_for_static_init(loc, thread_id, schedtype,
+    // &isLastIter, &lower, &upper, &stride, incr, chunk);
+    llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                           GetOpenMPGlobalThreadNum(CGF, Loc),
+                           CGF.Builder.getInt32(Schedule),
+                           IL,
+                           LB,
+                           UB,
+                           ST,
+                           llvm::ConstantInt::get(ITy, 1),
+                           Chunk};
+    CGF.EmitRuntimeCall(CreateForStaticInitFunction(IVSize, IVSigned), Args);
+    return;
+  }
+  // Build call __kmpc_dispatch_init(loc, thread_id, schedtype, lower, upper,
+  // stride, chunk);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc),
+                         CGF.Builder.getInt32(Schedule),
+                         CGF.Builder.CreateLoad(LB),
+                         CGF.Builder.CreateLoad(UB),
+                         CGF.Builder.CreateLoad(ST),
+                         Chunk};
+  CGF.EmitRuntimeCall(CreateDispatchInitFunction(IVSize, IVSigned), Args);
+}
+
+llvm::Value *CGOpenMPRuntime::EmitOMPForNext(CodeGenFunction &CGF,
+                                             SourceLocation Loc,
+                                             unsigned IVSize, bool IVSigned,
+                                             llvm::Value *IL, llvm::Value *LB,
+                                             llvm::Value *UB,
+                                             llvm::Value *ST) {
+  // Build call __kmpc_dispatch_next(loc, thread_id, &isLastIter, &lower,
+  // &upper, &stride);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc), IL, LB, UB, ST};
+  return CGF.EmitRuntimeCall(CreateDispatchNextFunction(IVSize, IVSigned),
+                             Args);
+}
+
+void CGOpenMPRuntime::EmitOMPForFinish(CodeGenFunction &CGF,
+                                       SourceLocation Loc,
+                                       OpenMPSchedType Schedule) {
+  // Dynamically scheduled loops end when __kmpc_dispatch_next says so.
+  if (!isStaticSchedule(Schedule))
+    return;
+  // Build call __kmpc_for_static_fini(loc, thread_id);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc)};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_for_static_fini),
+                      Args);
+}
+
+llvm::Value *CGOpenMPRuntime::EmitOMPTaskAlloc(CodeGenFunction &CGF,
+                                               SourceLocation Loc,
+                                               llvm::Value *Flags,
+                                               uint64_t TaskSize,
+                                               uint64_t SharedsSize,
+                                               llvm::Value *TaskEntry) {
+  // Build call __kmpc_omp_task_alloc(loc, thread_id, flags,
+  // sizeof_kmp_task_t, sizeof_shareds, task_entry);
+  llvm::Value *Args[] = {
+      EmitOpenMPUpdateLocation(CGF, Loc), GetOpenMPGlobalThreadNum(CGF, Loc),
+      Flags, llvm::ConstantInt::get(CGM.SizeTy, TaskSize),
+      llvm::ConstantInt::get(CGM.SizeTy, SharedsSize),
+      CGF.Builder.CreateBitCast(TaskEntry, getKmpRoutineEntryPointerTy())};
+  return CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_omp_task_alloc),
+                             Args);
+}
+
+void CGOpenMPRuntime::EmitOMPTaskCall(CodeGenFunction &CGF, SourceLocation Loc,
+                                      llvm::Value *Task) {
+  // Build call __kmpc_omp_task(loc, thread_id, new_task);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc), Task};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_omp_task), Args);
+}
+
+void CGOpenMPRuntime::EmitOMPTaskBeginIf0(CodeGenFunction &CGF,
+                                          SourceLocation Loc,
+                                          llvm::Value *Task) {
+  // Build call __kmpc_omp_task_begin_if0(loc, thread_id, new_task);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc), Task};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_omp_task_begin_if0),
+                      Args);
+}
+
+void CGOpenMPRuntime::EmitOMPTaskCompleteIf0(CodeGenFunction &CGF,
+                                             SourceLocation Loc,
+                                             llvm::Value *Task) {
+  // Build call __kmpc_omp_task_complete_if0(loc, thread_id, new_task);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc), Task};
+  CGF.EmitRuntimeCall(
+      CreateRuntimeFunction(OMPRTL__kmpc_omp_task_complete_if0), Args);
+}
+
+void CGOpenMPRuntime::EmitOMPTaskwaitCall(CodeGenFunction &CGF,
+                                          SourceLocation Loc) {
+  // Build call __kmpc_omp_taskwait(loc, thread_id);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc)};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_omp_taskwait), Args);
+}
+
+void CGOpenMPRuntime::EmitOMPTaskyieldCall(CodeGenFunction &CGF,
+                                           SourceLocation Loc) {
+  // Build call __kmpc_omp_taskyield(loc, thread_id, 0);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc),
+                         llvm::ConstantInt::get(CGM.IntTy, 0)};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_omp_taskyield),
+                      Args);
+}
+
+llvm::Value *CGOpenMPRuntime::EmitOMPReduceCall(
+    CodeGenFunction &CGF, SourceLocation Loc, bool NoWait, bool AllowAtomic,
+    unsigned NumVars, uint64_t ReduceSize, llvm::Value *ReduceData,
+    llvm::Value *ReduceFn) {
+  // The runtime may only choose the atomic method if the location says so.
+  OpenMPLocationFlags Flags =
+      AllowAtomic
+          ? static_cast<OpenMPLocationFlags>(OMP_IDENT_KMPC | OMP_ATOMIC_REDUCE)
+          : OMP_IDENT_KMPC;
+  // Build call __kmpc_reduce{_nowait}(loc, thread_id, num_vars, reduce_size,
+  // reduce_data, reduce_func, &lck);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc, Flags),
+                         GetOpenMPGlobalThreadNum(CGF, Loc),
+                         CGF.Builder.getInt32(NumVars),
+                         llvm::ConstantInt::get(CGM.SizeTy, ReduceSize),
+                         ReduceData,
+                         ReduceFn,
+                         getCriticalRegionLock(".reduction")};
+  return CGF.EmitRuntimeCall(
+      CreateRuntimeFunction(NoWait ? OMPRTL__kmpc_reduce_nowait
+                                   : OMPRTL__kmpc_reduce),
+      Args);
+}
+
+void CGOpenMPRuntime::EmitOMPEndReduceCall(CodeGenFunction &CGF,
+                                           SourceLocation Loc, bool NoWait) {
+  // Build call __kmpc_end_reduce{_nowait}(loc, thread_id, &lck);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc),
+                         getCriticalRegionLock(".reduction")};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(NoWait
+                                                ? OMPRTL__kmpc_end_reduce_nowait
+                                                : OMPRTL__kmpc_end_reduce),
+                      Args);
+}
+
+void CGOpenMPRuntime::EmitOMPCriticalCall(CodeGenFunction &CGF,
+                                          SourceLocation Loc,
+                                          StringRef CriticalName) {
+  // Build call __kmpc_critical(loc, thread_id, &lck);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc),
+                         getCriticalRegionLock(CriticalName)};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_critical), Args);
+}
+
+void CGOpenMPRuntime::EmitOMPEndCriticalCall(CodeGenFunction &CGF,
+                                             SourceLocation Loc,
+                                             StringRef CriticalName) {
+  // Build call __kmpc_end_critical(loc, thread_id, &lck);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc),
+                         getCriticalRegionLock(CriticalName)};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_end_critical), Args);
+}
+
+llvm::Value *CGOpenMPRuntime::EmitOMPMasterCall(CodeGenFunction &CGF,
+                                                SourceLocation Loc) {
+  // Build call __kmpc_master(loc, thread_id);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc)};
+  return CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_master), Args);
+}
+
+void CGOpenMPRuntime::EmitOMPEndMasterCall(CodeGenFunction &CGF,
+                                           SourceLocation Loc) {
+  // Build call __kmpc_end_master(loc, thread_id);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc)};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_end_master), Args);
+}
+
+llvm::Value *CGOpenMPRuntime::EmitOMPSingleCall(CodeGenFunction &CGF,
+                                                SourceLocation Loc) {
+  // Build call __kmpc_single(loc, thread_id);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc)};
+  return CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_single), Args);
+}
+
+void CGOpenMPRuntime::EmitOMPEndSingleCall(CodeGenFunction &CGF,
+                                           SourceLocation Loc) {
+  // Build call __kmpc_end_single(loc, thread_id);
+  llvm::Value *Args[] = {EmitOpenMPUpdateLocation(CGF, Loc),
+                         GetOpenMPGlobalThreadNum(CGF, Loc)};
+  CGF.EmitRuntimeCall(CreateRuntimeFunction(OMPRTL__kmpc_end_single), Args);
+}
@@ -15,12 +15,15 @@
 #define LLVM_CLANG_LIB_CODEGEN_CGOPENMPRUNTIME_H
 
 #include "clang/AST/Type.h"
+#include "clang/Basic/OpenMPKinds.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Value.h"
 
 namespace llvm {
 class AllocaInst;
+class ArrayType;
 class CallInst;
 class GlobalVariable;
 class Constant;
@@ -63,12 +66,100 @@ public:
     /// \brief Implicit barrier in 'single' directive.
     OMP_IDENT_BARRIER_IMPL_SINGLE = 0x140
   };
+  /// \brief Schedule types for worksharing loops, passed to the runtime.
+  /// All enumeric elements are named and described in accordance with the code
+  /// from http://llvm.org/svn/llvm-project/openmp/trunk/runtime/src/kmp.h
+  enum OpenMPSchedType {
+    /// \brief Static schedule with the given chunk size.
+    OMP_sch_static_chunked = 33,
+    /// \brief Static schedule with chunks of equal size, one per thread.
+    OMP_sch_static = 34,
+    /// \brief Dynamic schedule with the given chunk size.
+    OMP_sch_dynamic_chunked = 35,
+    /// \brief Guided schedule with the given minimal chunk size.
+    OMP_sch_guided_chunked = 36,
+    /// \brief Schedule taken from the OMP_SCHEDULE environment variable.
+    OMP_sch_runtime = 37,
+    /// \brief Schedule chosen by the runtime.
+    OMP_sch_auto = 38
+  };
+  /// \brief Values for bit flags of the task, passed to __kmpc_omp_task_alloc.
+  /// All enumeric elements are named and described in accordance with the code
+  /// from http://llvm.org/svn/llvm-project/openmp/trunk/runtime/src/kmp.h
+  enum OpenMPTaskFlags {
+    /// \brief The task is tied to the thread which starts executing it.
+    OMP_TASK_TIED = 0x1,
+    /// \brief The task is final: its child tasks are executed immediately.
+    OMP_TASK_FINAL = 0x2
+  };
+  /// \brief Fields of kmp_task_t.
+  enum KmpTaskTFieldIndex {
+    /// \brief Pointer to the copy of the shared variables of the task.
+    KmpTaskTShareds,
+    /// \brief The task entry.
+    KmpTaskTRoutine,
+    /// \brief Part id, for untied tasks resumed in parts.
+    KmpTaskTPartId
+  };
   enum OpenMPRTLFunction {
     // Call to void __kmpc_fork_call(ident_t *loc, kmp_int32 argc, kmpc_micro
     // microtask, ...);
     OMPRTL__kmpc_fork_call,
     // Call to kmp_int32 kmpc_global_thread_num(ident_t *loc);
-    OMPRTL__kmpc_global_thread_num
+    OMPRTL__kmpc_global_thread_num,
+    // Call to void __kmpc_barrier(ident_t *loc, kmp_int32 global_tid);
+    OMPRTL__kmpc_barrier,
+    // Call to void __kmpc_for_static_fini(ident_t *loc, kmp_int32 global_tid);
+    OMPRTL__kmpc_for_static_fini,
+    // Call to kmp_task_t *__kmpc_omp_task_alloc(ident_t *loc, kmp_int32
+    // global_tid, kmp_int32 flags, size_t sizeof_kmp_task_t, size_t
+    // sizeof_shareds, kmp_routine_entry_t task_entry);
+    OMPRTL__kmpc_omp_task_alloc,
+    // Call to kmp_int32 __kmpc_omp_task(ident_t *loc, kmp_int32 global_tid,
+    // kmp_task_t *new_task);
+    OMPRTL__kmpc_omp_task,
+    // Call to void __kmpc_omp_task_begin_if0(ident_t *loc, kmp_int32
+    // global_tid, kmp_task_t *new_task);
+    OMPRTL__kmpc_omp_task_begin_if0,
+    // Call to void __kmpc_omp_task_complete_if0(ident_t *loc, kmp_int32
+    // global_tid, kmp_task_t *new_task);
+    OMPRTL__kmpc_omp_task_complete_if0,
+    // Call to kmp_int32 __kmpc_omp_taskwait(ident_t *loc, kmp_int32
+    // global_tid);
+    OMPRTL__kmpc_omp_taskwait,
+    // Call to kmp_int32 __kmpc_omp_taskyield(ident_t *loc, kmp_int32
+    // global_tid, int end_part);
+    OMPRTL__kmpc_omp_taskyield,
+    // Call to kmp_int32 __kmpc_reduce(ident_t *loc, kmp_int32 global_tid,
+    // kmp_int32 num_vars, size_t reduce_size, void *reduce_data,
+    // void (*reduce_func)(void *lhs_data, void *rhs_data), kmp_critical_name
+    // *lck);
+    OMPRTL__kmpc_reduce,
+    // Call to kmp_int32 __kmpc_reduce_nowait(ident_t *loc, kmp_int32
+    // global_tid, kmp_int32 num_vars, size_t reduce_size, void *reduce_data,
+    // void (*reduce_func)(void *lhs_data, void *rhs_data), kmp_critical_name
+    // *lck);
+    OMPRTL__kmpc_reduce_nowait,
+    // Call to void __kmpc_end_reduce(ident_t *loc, kmp_int32 global_tid,
+    // kmp_critical_name *lck);
+    OMPRTL__kmpc_end_reduce,
+    // Call to void __kmpc_end_reduce_nowait(ident_t *loc, kmp_int32
+    // global_tid, kmp_critical_name *lck);
+    OMPRTL__kmpc_end_reduce_nowait,
+    // Call to void __kmpc_critical(ident_t *loc, kmp_int32 global_tid,
+    // kmp_critical_name *crit);
+    OMPRTL__kmpc_critical,
+    // Call to void __kmpc_end_critical(ident_t *loc, kmp_int32 global_tid,
+    // kmp_critical_name *crit);
+    OMPRTL__kmpc_end_critical,
+    // Call to kmp_int32 __kmpc_master(ident_t *loc, kmp_int32 global_tid);
+    OMPRTL__kmpc_master,
+    // Call to void __kmpc_end_master(ident_t *loc, kmp_int32 global_tid);
+    OMPRTL__kmpc_end_master,
+    // Call to kmp_int32 __kmpc_single(ident_t *loc, kmp_int32 global_tid);
+    OMPRTL__kmpc_single,
+    // Call to void __kmpc_end_single(ident_t *loc, kmp_int32 global_tid);
+    OMPRTL__kmpc_end_single
   };
 
 private:
@@ -128,6 +219,23 @@ private:
   /// Original representation is:
   /// typedef void (kmpc_micro)(kmp_int32 global_tid, kmp_int32 bound_tid,...);
   llvm::FunctionType *Kmpc_MicroTy;
+  /// \brief The type for the entry of a task, which gets passed to
+  /// __kmpc_omp_task_alloc(). Original representation is:
+  /// typedef kmp_int32 (*kmp_routine_entry_t)(kmp_int32, void *);
+  llvm::FunctionType *KmpRoutineEntryTy;
+  /// \brief The part of a task which is shared with the runtime.
+  /// Original representation is:
+  /// typedef struct kmp_task {
+  ///   void *shareds;
+  ///   kmp_routine_entry_t routine;
+  ///   kmp_int32 part_id;
+  /// } kmp_task_t;
+  llvm::StructType *KmpTaskTTy;
+  /// \brief Type kmp_critical_name, originally defined as typedef kmp_int32
+  /// kmp_critical_name[8];
+  llvm::ArrayType *KmpCriticalNameTy;
+  /// \brief Map of the names of critical regions and their locks.
+  llvm::StringMap<llvm::Value *> CriticalRegionVarNames;
   /// \brief Map of local debug location and functions.
   typedef llvm::DenseMap<llvm::Function *, llvm::Value *> OpenMPLocMapTy;
   OpenMPLocMapTy OpenMPLocMap;
@@ -166,10 +274,187 @@ public:
   /// \brief Returns pointer to kmpc_micro type;
   llvm::Type *getKmpc_MicroPointerTy();
 
+  /// \brief Returns pointer to kmp_routine_entry_t type;
+  llvm::Type *getKmpRoutineEntryPointerTy();
+
+  /// \brief Returns kmp_task_t type;
+  llvm::StructType *getKmpTaskTTy() { return KmpTaskTTy; }
+
+  /// \brief Returns the lock of type kmp_critical_name, shared by the whole
+  /// program, for the critical regions named \a CriticalName.
+  llvm::Value *getCriticalRegionLock(StringRef CriticalName);
+
   /// \brief Returns specified OpenMP runtime function.
   /// \param Function OpenMP runtime function.
   /// \return Specified function.
   llvm::Constant *CreateRuntimeFunction(OpenMPRTLFunction Function);
+
+  /// \brief Returns __kmpc_for_static_init_* runtime function for the
+  /// specified size \a IVSize and sign \a IVSigned of the iteration variable.
+  llvm::Constant *CreateForStaticInitFunction(unsigned IVSize, bool IVSigned);
+
+  /// \brief Returns __kmpc_dispatch_init_* runtime function for the
+  /// specified size \a IVSize and sign \a IVSigned of the iteration variable.
+  llvm::Constant *CreateDispatchInitFunction(unsigned IVSize, bool IVSigned);
+
+  /// \brief Returns __kmpc_dispatch_next_* runtime function for the
+  /// specified size \a IVSize and sign \a IVSigned of the iteration variable.
+  llvm::Constant *CreateDispatchNextFunction(unsigned IVSize, bool IVSigned);
+
+  /// \brief Returns the runtime schedule type for the 'schedule' clause
+  /// kind \a ScheduleKind, with or without a chunk size.
+  static OpenMPSchedType getSchedType(OpenMPScheduleClauseKind ScheduleKind,
+                                      bool Chunked);
+
+  /// \brief Returns true if the schedule type \a Schedule is handled by
+  /// __kmpc_for_static_init, rather than by the __kmpc_dispatch_* functions.
+  static bool isStaticSchedule(OpenMPSchedType Schedule) {
+    return Schedule == OMP_sch_static || Schedule == OMP_sch_static_chunked;
+  }
+
+  /// \brief Emits a call to __kmpc_barrier.
+  /// \param CGF Reference to current CodeGenFunction.
+  /// \param Loc Clang source location.
+  /// \param Flags Flags for the barrier location, in addition to
+  /// OMP_IDENT_KMPC.
+  ///
+  void EmitOMPBarrierCall(CodeGenFunction &CGF, SourceLocation Loc,
+                          OpenMPLocationFlags Flags);
+
+  /// \brief Emits the start of a worksharing loop over the logical iterations
+  /// [*\a LB, *\a UB] with stride *\a ST. For static schedules, the runtime
+  /// stores the bounds and stride of the first chunk of the current thread
+  /// in *\a LB, *\a UB and *\a ST, and a non-zero value in *\a IL if the
+  /// chunk contains the last iteration. For the other schedules, chunks are
+  /// then requested with EmitOMPForNext.
+  /// \param CGF Reference to current CodeGenFunction.
+  /// \param Loc Clang source location.
+  /// \param Schedule Schedule type of the loop.
+  /// \param IVSize Size of the iteration variable in bits.
+  /// \param IVSigned Sign of the iteration variable.
+  /// \param Chunk Chunk size, or null if none was specified.
+  ///
+  void EmitOMPForInit(CodeGenFunction &CGF, SourceLocation Loc,
+                      OpenMPSchedType Schedule, unsigned IVSize, bool IVSigned,
+                      llvm::Value *IL, llvm::Value *LB, llvm::Value *UB,
+                      llvm::Value *ST, llvm::Value *Chunk);
+
+  /// \brief Requests the next chunk of a dynamically scheduled worksharing
+  /// loop, storing its bounds and stride in *\a LB, *\a UB and *\a ST.
+  /// \return A value which is zero when there are no more chunks.
+  ///
+  llvm::Value *EmitOMPForNext(CodeGenFunction &CGF, SourceLocation Loc,
+                              unsigned IVSize, bool IVSigned, llvm::Value *IL,
+                              llvm::Value *LB, llvm::Value *UB,
+                              llvm::Value *ST);
+
+  /// \brief Emits the end of a worksharing loop with schedule \a Schedule.
+  ///
+  void EmitOMPForFinish(CodeGenFunction &CGF, SourceLocation Loc,
+                        OpenMPSchedType Schedule);
+
+  /// \brief Emits a call to __kmpc_omp_task_alloc, which allocates a task of
+  /// \a TaskSize bytes, starting with a kmp_task_t, whose shareds point to
+  /// \a SharedsSize uninitialized bytes.
+  /// \param CGF Reference to current CodeGenFunction.
+  /// \param Loc Clang source location.
+  /// \param Flags Combination of OpenMPTaskFlags.
+  /// \param TaskEntry Function of kmp_routine_entry_t type which runs the
+  /// task.
+  /// \return The new task, as a void pointer.
+  ///
+  llvm::Value *EmitOMPTaskAlloc(CodeGenFunction &CGF, SourceLocation Loc,
+                                llvm::Value *Flags, uint64_t TaskSize,
+                                uint64_t SharedsSize, llvm::Value *TaskEntry);
+
+  /// \brief Emits a call to __kmpc_omp_task, which schedules \a Task for
+  /// execution.
+  ///
+  void EmitOMPTaskCall(CodeGenFunction &CGF, SourceLocation Loc,
+                       llvm::Value *Task);
+
+  /// \brief Emits a call to __kmpc_omp_task_begin_if0, before \a Task is
+  /// executed immediately by the encountering thread.
+  ///
+  void EmitOMPTaskBeginIf0(CodeGenFunction &CGF, SourceLocation Loc,
+                           llvm::Value *Task);
+
+  /// \brief Emits a call to __kmpc_omp_task_complete_if0, after \a Task was
+  /// executed immediately by the encountering thread.
+  ///
+  void EmitOMPTaskCompleteIf0(CodeGenFunction &CGF, SourceLocation Loc,
+                              llvm::Value *Task);
+
+  /// \brief Emits a call to __kmpc_omp_taskwait.
+  ///
+  void EmitOMPTaskwaitCall(CodeGenFunction &CGF, SourceLocation Loc);
+
+  /// \brief Emits a call to __kmpc_omp_taskyield.
+  ///
+  void EmitOMPTaskyieldCall(CodeGenFunction &CGF, SourceLocation Loc);
+
+  /// \brief Emits a call to __kmpc_reduce or __kmpc_reduce_nowait, which
+  /// selects the method used to combine the private copies of the \a NumVars
+  /// variables of a 'reduction' clause.
+  /// \param CGF Reference to current CodeGenFunction.
+  /// \param Loc Clang source location.
+  /// \param NoWait True if the reduction is not followed by a barrier.
+  /// \param AllowAtomic True if the copies can be combined with atomic
+  /// operations.
+  /// \param ReduceSize Size of the array pointed to by \a ReduceData.
+  /// \param ReduceData Array of pointers to the private copies, as a void
+  /// pointer.
+  /// \param ReduceFn Function of type void(void *, void *) which combines
+  /// two arrays of private copies into the first one.
+  /// \return 1 if the current thread must combine its copies with the
+  /// original variables, 2 if it must do so atomically, and 0 otherwise.
+  ///
+  llvm::Value *EmitOMPReduceCall(CodeGenFunction &CGF, SourceLocation Loc,
+                                 bool NoWait, bool AllowAtomic,
+                                 unsigned NumVars, uint64_t ReduceSize,
+                                 llvm::Value *ReduceData,
+                                 llvm::Value *ReduceFn);
+
+  /// \brief Emits a call to __kmpc_end_reduce or __kmpc_end_reduce_nowait,
+  /// after the current thread combined its copies with the original
+  /// variables.
+  ///
+  void EmitOMPEndReduceCall(CodeGenFunction &CGF, SourceLocation Loc,
+                            bool NoWait);
+
+  /// \brief Emits a call to __kmpc_critical, which waits until the current
+  /// thread may enter the critical regions named \a CriticalName.
+  ///
+  void EmitOMPCriticalCall(CodeGenFunction &CGF, SourceLocation Loc,
+                           StringRef CriticalName);
+
+  /// \brief Emits a call to __kmpc_end_critical, at the exit of a critical
+  /// region named \a CriticalName.
+  ///
+  void EmitOMPEndCriticalCall(CodeGenFunction &CGF, SourceLocation Loc,
+                              StringRef CriticalName);
+
+  /// \brief Emits a call to __kmpc_master.
+  /// \return A value which is non-zero if the current thread is the master
+  /// thread of the team.
+  ///
+  llvm::Value *EmitOMPMasterCall(CodeGenFunction &CGF, SourceLocation Loc);
+
+  /// \brief Emits a call to __kmpc_end_master, at the end of a 'master'
+  /// region executed by the current thread.
+  ///
+  void EmitOMPEndMasterCall(CodeGenFunction &CGF, SourceLocation Loc);
+
+  /// \brief Emits a call to __kmpc_single.
+  /// \return A value which is non-zero if the current thread must execute
+  /// the 'single' region.
+  ///
+  llvm::Value *EmitOMPSingleCall(CodeGenFunction &CGF, SourceLocation Loc);
+
+  /// \brief Emits a call to __kmpc_end_single, at the end of a 'single'
+  /// region executed by the current thread.
+  ///
+  void EmitOMPEndSingleCall(CodeGenFunction &CGF, SourceLocation Loc);
 };
 } // namespace CodeGen
 } // namespace clang
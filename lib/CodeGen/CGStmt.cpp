@@ -578,7 +578,8 @@ void CodeGenFunction::EmitCondBrHints(llvm::LLVMContext &Context,
   if (Attrs.empty())
     return;
 
-  // Add vectorize and unroll hints to the metadata on the conditional branch.
+  // Add vectorize, unroll, distribute and pipeline hints to the metadata on the
+  // conditional branch.
   SmallVector<llvm::Value *, 2> Metadata(1);
   for (const auto *Attr : Attrs) {
     const LoopHintAttr *LH = dyn_cast<LoopHintAttr>(Attr);
@@ -609,6 +610,27 @@ void CodeGenFunction::EmitCondBrHints(llvm::LLVMContext &Context,
     case LoopHintAttr::UnrollCount:
       MetadataName = "llvm.loop.unroll.count";
       break;
+    case LoopHintAttr::VectorizePredicate:
+      MetadataName = "llvm.loop.vectorize.predicate.enable";
+      break;
+    case LoopHintAttr::Distribute:
+      MetadataName = "llvm.loop.distribute.enable";
+      break;
+    case LoopHintAttr::UnrollAndJam:
+      MetadataName = State == LoopHintAttr::Disable
+                         ? "llvm.loop.unroll_and_jam.disable"
+                         : "llvm.loop.unroll_and_jam.enable";
+      break;
+    case LoopHintAttr::UnrollAndJamCount:
+      MetadataName = "llvm.loop.unroll_and_jam.count";
+      break;
+    case LoopHintAttr::Pipeline:
+      // Pipelining can only be disabled.
+      MetadataName = "llvm.loop.pipeline.disable";
+      break;
+    case LoopHintAttr::PipelineInitiationInterval:
+      MetadataName = "llvm.loop.pipeline.initiationinterval";
+      break;
     }
     llvm::Value *Value;
     llvm::MDString *Name;
@@ -628,13 +650,25 @@ void CodeGenFunction::EmitCondBrHints(llvm::LLVMContext &Context,
     case LoopHintAttr::VectorizeWidth:
     case LoopHintAttr::InterleaveCount:
     case LoopHintAttr::UnrollCount:
+    case LoopHintAttr::UnrollAndJamCount:
+    case LoopHintAttr::PipelineInitiationInterval:
       Name = llvm::MDString::get(Context, MetadataName);
       Value = llvm::ConstantInt::get(Int32Ty, ValueInt);
       break;
     case LoopHintAttr::Unroll:
+    case LoopHintAttr::UnrollAndJam:
       Name = llvm::MDString::get(Context, MetadataName);
       Value = nullptr;
       break;
+    case LoopHintAttr::VectorizePredicate:
+    case LoopHintAttr::Distribute:
+      Name = llvm::MDString::get(Context, MetadataName);
+      Value = Builder.getInt1(State != LoopHintAttr::Disable);
+      break;
+    case LoopHintAttr::Pipeline:
+      Name = llvm::MDString::get(Context, MetadataName);
+      Value = Builder.getTrue();
+      break;
     }
 
     SmallVector<llvm::Value *, 2> OpValues;
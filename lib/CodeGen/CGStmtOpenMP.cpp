@@ -16,6 +16,7 @@
 #include "CodeGenModule.h"
 #include "clang/AST/Stmt.h"
 #include "clang/AST/StmtOpenMP.h"
+#include "llvm/ADT/FoldingSet.h"
 using namespace clang;
 using namespace CodeGen;
 
@@ -23,36 +24,980 @@ using namespace CodeGen;
 //                              OpenMP Directive Emission
 //===----------------------------------------------------------------------===//
 
-void CodeGenFunction::EmitOMPParallelDirective(const OMPParallelDirective &S) {
+/// \brief Emits a call to __kmpc_fork_call for the parallel region of the
+/// directive \p S, whose outlined body is emitted by \p CGInfo.
+static void EmitOMPParallelCall(CodeGenFunction &CGF,
+                                const OMPExecutableDirective &S,
+                                CodeGenFunction::CGCapturedStmtInfo &CGInfo) {
   const CapturedStmt *CS = cast<CapturedStmt>(S.getAssociatedStmt());
-  llvm::Value *CapturedStruct = GenerateCapturedStmtArgument(*CS);
+  llvm::Value *CapturedStruct = CGF.GenerateCapturedStmtArgument(*CS);
 
   llvm::Value *OutlinedFn;
   {
-    CodeGenFunction CGF(CGM, true);
-    CGCapturedStmtInfo CGInfo(*CS, CS->getCapturedRegionKind());
-    CGF.CapturedStmtInfo = &CGInfo;
-    OutlinedFn = CGF.GenerateCapturedStmtFunction(*CS);
+    CodeGenFunction OutlinedCGF(CGF.CGM, true);
+    OutlinedCGF.CapturedStmtInfo = &CGInfo;
+    OutlinedFn = OutlinedCGF.GenerateCapturedStmtFunction(*CS);
   }
 
   // Build call __kmpc_fork_call(loc, 1, microtask, captured_struct/*context*/)
+  CGOpenMPRuntime &RT = CGF.CGM.getOpenMPRuntime();
   llvm::Value *Args[] = {
-      CGM.getOpenMPRuntime().EmitOpenMPUpdateLocation(*this, S.getLocStart()),
-      Builder.getInt32(1), // Number of arguments after 'microtask' argument
+      RT.EmitOpenMPUpdateLocation(CGF, S.getLocStart()),
+      CGF.Builder.getInt32(1), // Number of arguments after 'microtask' argument
       // (there is only one additional argument - 'context')
-      Builder.CreateBitCast(OutlinedFn,
-                            CGM.getOpenMPRuntime().getKmpc_MicroPointerTy()),
-      EmitCastToVoidPtr(CapturedStruct)};
-  llvm::Constant *RTLFn = CGM.getOpenMPRuntime().CreateRuntimeFunction(
-      CGOpenMPRuntime::OMPRTL__kmpc_fork_call);
-  EmitRuntimeCall(RTLFn, Args);
+      CGF.Builder.CreateBitCast(OutlinedFn, RT.getKmpc_MicroPointerTy()),
+      CGF.EmitCastToVoidPtr(CapturedStruct)};
+  llvm::Constant *RTLFn =
+      RT.CreateRuntimeFunction(CGOpenMPRuntime::OMPRTL__kmpc_fork_call);
+  CGF.EmitRuntimeCall(RTLFn, Args);
 }
 
-void CodeGenFunction::EmitOMPSimdDirective(const OMPSimdDirective &S) {
+namespace {
+/// \brief Emits the outlined region of a 'parallel' directive, with private
+/// copies of the variables of its data-sharing clauses.
+class CGParallelStmtInfo : public CodeGenFunction::CGCapturedStmtInfo {
+  const OMPParallelDirective &S;
+
+public:
+  explicit CGParallelStmtInfo(const OMPParallelDirective &S)
+      : CGCapturedStmtInfo(*cast<CapturedStmt>(S.getAssociatedStmt()),
+                           CR_OpenMP),
+        S(S) {}
+
+  void EmitBody(CodeGenFunction &CGF, Stmt *Body) override {
+    CodeGenFunction::OMPPrivateScope PrivateScope(CGF);
+    CGF.EmitOMPPrivateClauses(S, PrivateScope);
+    SmallVector<CodeGenFunction::OMPReductionItem, 4> Reductions;
+    CGF.EmitOMPReductionClauseInit(S, PrivateScope, Reductions);
+    CGCapturedStmtInfo::EmitBody(CGF, Body);
+    // The end of the parallel region is a barrier.
+    CGF.EmitOMPReductionClauseFinal(S, Reductions, /*UseRuntime=*/true,
+                                    /*NoWait=*/true);
+  }
+};
+} // namespace
+
+void CodeGenFunction::EmitOMPParallelDirective(const OMPParallelDirective &S) {
+  CGParallelStmtInfo CGInfo(S);
+  EmitOMPParallelCall(*this, S, CGInfo);
+}
+
+llvm::Value *CodeGenFunction::OMPPrivateScope::addPrivate(const VarDecl *VD) {
+  for (unsigned I = 0, E = SavedAddrs.size(); I != E; ++I)
+    if (SavedAddrs[I].first == VD)
+      return CGF.LocalDeclMap[VD];
+  SavedAddrs.push_back(std::make_pair(VD, CGF.LocalDeclMap.lookup(VD)));
+  llvm::Value *Private = CGF.CreateMemTemp(VD->getType(), VD->getName());
+  CGF.LocalDeclMap[VD] = Private;
+  return Private;
+}
+
+void CodeGenFunction::OMPPrivateScope::ForceCleanup() {
+  for (auto I = SavedAddrs.rbegin(), E = SavedAddrs.rend(); I != E; ++I) {
+    if (I->second)
+      CGF.LocalDeclMap[I->first] = I->second;
+    else
+      CGF.LocalDeclMap.erase(I->first);
+  }
+  SavedAddrs.clear();
+}
+
+namespace {
+/// \brief One of the loops associated with an OpenMP loop directive, in the
+/// canonical form checked by Sema (OpenMP [2.6]):
+///   for (Var = LB; Var < UB; Var += Step)
+/// where '<' may be any relational operator, and the increment may be
+/// written in any of the other canonical forms.
+struct OMPCanonicalLoop {
+  const VarDecl *Var;
+  /// \brief The reference to Var in the init-expr, or null if Var is declared
+  /// there.
+  const DeclRefExpr *VarRef;
+  const Expr *LB;
+  const Expr *UB;
+  /// \brief The step, or null if the increment is '++' or '--'.
+  const Expr *Step;
+  /// \brief True if the condition is 'Var < UB' or 'Var <= UB'.
+  bool TestIsLessOp;
+  /// \brief True if the condition is strict ('<' or '>').
+  bool TestIsStrictOp;
+  /// \brief True if the step is subtracted from Var on each iteration.
+  bool SubtractStep;
+};
+} // namespace
+
+static const VarDecl *getReferencedVar(const Expr *E) {
+  if (auto DRE = dyn_cast<DeclRefExpr>(E->IgnoreParenImpCasts()))
+    return dyn_cast<VarDecl>(DRE->getDecl());
+  return nullptr;
+}
+
+/// \brief Skips the attributed and single-statement compound statements
+/// around the next loop of a loop nest.
+static const Stmt *ignoreContainerStmts(const Stmt *S) {
+  while (true) {
+    if (auto AS = dyn_cast<AttributedStmt>(S))
+      S = AS->getSubStmt();
+    else if (auto CS = dyn_cast<CompoundStmt>(S)) {
+      if (CS->size() != 1)
+        break;
+      S = CS->body_back();
+    } else
+      break;
+  }
+  return S;
+}
+
+/// \brief Decomposes the loop \p S into \p L.
+/// \return The loop, or null if it has an integer counter that we cannot
+/// emit yet, such as an iterator or a pointer.
+static const ForStmt *getCanonicalLoop(const Stmt *S, OMPCanonicalLoop &L) {
+  auto For = dyn_cast<ForStmt>(ignoreContainerStmts(S));
+  if (!For)
+    return nullptr;
+
+  // init-expr: 'Var = LB' or 'integer-type Var = LB'.
+  L.Var = nullptr;
+  L.VarRef = nullptr;
+  L.LB = nullptr;
+  const Stmt *Init = For->getInit();
+  if (auto E = dyn_cast_or_null<Expr>(Init))
+    Init = E->IgnoreParens();
+  if (auto BO = dyn_cast_or_null<BinaryOperator>(Init)) {
+    if (BO->getOpcode() == BO_Assign) {
+      L.Var = getReferencedVar(BO->getLHS());
+      L.VarRef = dyn_cast<DeclRefExpr>(BO->getLHS()->IgnoreParenImpCasts());
+      L.LB = BO->getRHS();
+    }
+  } else if (auto DS = dyn_cast_or_null<DeclStmt>(Init)) {
+    if (DS->isSingleDecl())
+      if (auto VD = dyn_cast<VarDecl>(DS->getSingleDecl())) {
+        L.Var = VD;
+        L.LB = VD->getInit();
+      }
+  }
+  if (!L.Var || !L.LB || !L.Var->getType()->isIntegerType())
+    return nullptr;
+
+  // test-expr: 'Var relational-op UB' or 'UB relational-op Var'.
+  if (!For->getCond())
+    return nullptr;
+  auto Cond = dyn_cast<BinaryOperator>(For->getCond()->IgnoreParenImpCasts());
+  if (!Cond || !Cond->isRelationalOp())
+    return nullptr;
+  BinaryOperatorKind Op = Cond->getOpcode();
+  L.TestIsStrictOp = Op == BO_LT || Op == BO_GT;
+  if (getReferencedVar(Cond->getLHS()) == L.Var) {
+    L.UB = Cond->getRHS();
+    L.TestIsLessOp = Op == BO_LT || Op == BO_LE;
+  } else if (getReferencedVar(Cond->getRHS()) == L.Var) {
+    L.UB = Cond->getLHS();
+    L.TestIsLessOp = Op == BO_GT || Op == BO_GE;
+  } else
+    return nullptr;
+  if (!L.UB->getType()->isIntegerType())
+    return nullptr;
+
+  // incr-expr: '++Var', 'Var++', '--Var', 'Var--', 'Var += Step',
+  // 'Var -= Step', 'Var = Var + Step', 'Var = Step + Var', 'Var = Var - Step'.
+  L.Step = nullptr;
+  L.SubtractStep = false;
+  const Expr *Inc = For->getInc() ? For->getInc()->IgnoreParens() : nullptr;
+  if (auto UO = dyn_cast_or_null<UnaryOperator>(Inc)) {
+    if (!UO->isIncrementDecrementOp() ||
+        getReferencedVar(UO->getSubExpr()) != L.Var)
+      return nullptr;
+    L.SubtractStep = UO->isDecrementOp();
+    return For;
+  }
+  auto BO = dyn_cast_or_null<BinaryOperator>(Inc);
+  if (!BO || getReferencedVar(BO->getLHS()) != L.Var)
+    return nullptr;
+  switch (BO->getOpcode()) {
+  case BO_AddAssign:
+  case BO_SubAssign:
+    L.Step = BO->getRHS();
+    L.SubtractStep = BO->getOpcode() == BO_SubAssign;
+    return For;
+  case BO_Assign: {
+    auto RHS = dyn_cast<BinaryOperator>(BO->getRHS()->IgnoreParenImpCasts());
+    if (!RHS || !RHS->isAdditiveOp())
+      return nullptr;
+    bool IsAdd = RHS->getOpcode() == BO_Add;
+    if (getReferencedVar(RHS->getLHS()) == L.Var) {
+      L.Step = RHS->getRHS();
+      L.SubtractStep = !IsAdd;
+      return For;
+    }
+    if (IsAdd && getReferencedVar(RHS->getRHS()) == L.Var) {
+      L.Step = RHS->getLHS();
+      return For;
+    }
+    return nullptr;
+  }
+  default:
+    return nullptr;
+  }
+}
+
+/// \brief Sets \p Counter to its value on the logical iteration \p Idx of its
+/// loop. The counter is an integer, or a pointer which is advanced by Step
+/// elements on each iteration.
+static void setOMPLoopCounter(CodeGenFunction &CGF,
+                              const CodeGenFunction::OMPLoopCounter &Counter,
+                              llvm::Value *Idx) {
+  // The iteration number is unsigned.
+  Idx = CGF.Builder.CreateIntCast(Idx, Counter.Step->getType(),
+                                  /*isSigned=*/false);
+  llvm::Value *Offset = CGF.Builder.CreateMul(Idx, Counter.Step);
+  QualType Ty = Counter.Var->getType();
+  llvm::Value *Val;
+  if (Ty->isPointerType())
+    Val = CGF.Builder.CreateGEP(Counter.Start, Offset);
+  else
+    Val = CGF.Builder.CreateIntCast(CGF.Builder.CreateAdd(Counter.Start,
+                                                          Offset),
+                                    CGF.ConvertType(Ty), /*isSigned=*/false);
+  CGF.EmitStoreOfScalar(Val, CGF.MakeNaturalAlignAddrLValue(Counter.Addr, Ty));
+}
+
+/// \brief Copies a variable of type \p Ty from \p Src to \p Dst.
+static void emitOMPCopy(CodeGenFunction &CGF, QualType Ty, llvm::Value *Dst,
+                        llvm::Value *Src) {
+  LValue DstLV = CGF.MakeNaturalAlignAddrLValue(Dst, Ty);
+  LValue SrcLV = CGF.MakeNaturalAlignAddrLValue(Src, Ty);
+  switch (CodeGenFunction::getEvaluationKind(Ty)) {
+  case TEK_Scalar:
+    CGF.EmitStoreOfScalar(CGF.EmitLoadOfScalar(SrcLV, SourceLocation()),
+                          DstLV);
+    return;
+  case TEK_Complex:
+    CGF.EmitStoreOfComplex(CGF.EmitLoadOfComplex(SrcLV, SourceLocation()),
+                           DstLV, /*isInit=*/false);
+    return;
+  case TEK_Aggregate:
+    CGF.EmitAggregateCopy(Dst, Src, Ty);
+    return;
+  }
+  llvm_unreachable("bad evaluation kind");
+}
+
+void CodeGenFunction::EmitOMPPrivateClauses(const OMPExecutableDirective &S,
+                                            OMPPrivateScope &PrivateScope) {
+  for (auto C : S.clauses()) {
+    OpenMPClauseKind Kind = C->getClauseKind();
+    if (Kind != OMPC_private && Kind != OMPC_firstprivate)
+      continue;
+    for (auto *Ref : C->children()) {
+      auto DRE = cast<DeclRefExpr>(Ref);
+      auto VD = cast<VarDecl>(DRE->getDecl());
+      // A variable which is not referenced in the region needs no copy.
+      if (!isOMPReferenceableVar(VD))
+        continue;
+      QualType Ty = VD->getType();
+      if (!Ty.isPODType(getContext()) || Ty->isVariablyModifiedType()) {
+        CGM.ErrorUnsupported(&S, "private variable of this type");
+        continue;
+      }
+      if (Kind == OMPC_private) {
+        PrivateScope.addPrivate(VD);
+        continue;
+      }
+      // Take the address of the original variable before it is privatized.
+      llvm::Value *Original = EmitLValue(DRE).getAddress();
+      emitOMPCopy(*this, Ty, PrivateScope.addPrivate(VD), Original);
+    }
+  }
+}
+
+/// \brief Returns the reduction operator of the clause \p C, as in Sema.
+static BinaryOperatorKind getOMPReductionOp(const OMPReductionClause *C) {
+  DeclarationName Name = C->getNameInfo().getName();
+  switch (Name.getCXXOverloadedOperator()) {
+  case OO_Plus:
+  case OO_Minus:
+    return BO_AddAssign;
+  case OO_Star:
+    return BO_MulAssign;
+  case OO_Amp:
+    return BO_AndAssign;
+  case OO_Pipe:
+    return BO_OrAssign;
+  case OO_Caret:
+    return BO_XorAssign;
+  case OO_AmpAmp:
+    return BO_LAnd;
+  case OO_PipePipe:
+    return BO_LOr;
+  default:
+    break;
+  }
+  return Name.getAsIdentifierInfo()->isStr("max") ? BO_GT : BO_LT;
+}
+
+/// \brief Returns the initial value of the private copies of a variable of
+/// type \p Ty in a reduction with operator \p Op (OpenMP [2.14.3.6]).
+static llvm::Value *getOMPReductionIdentity(CodeGenFunction &CGF,
+                                            BinaryOperatorKind Op,
+                                            QualType Ty) {
+  llvm::Type *LTy = CGF.ConvertType(Ty);
+  if (Ty->isRealFloatingType()) {
+    const llvm::fltSemantics &Sem = CGF.getContext().getFloatTypeSemantics(Ty);
+    switch (Op) {
+    case BO_MulAssign:
+    case BO_LAnd:
+      return llvm::ConstantFP::get(LTy, 1.0);
+    case BO_GT:
+      return llvm::ConstantFP::get(CGF.getLLVMContext(),
+                                   llvm::APFloat::getLargest(Sem, true));
+    case BO_LT:
+      return llvm::ConstantFP::get(CGF.getLLVMContext(),
+                                   llvm::APFloat::getLargest(Sem, false));
+    default:
+      return llvm::Constant::getNullValue(LTy);
+    }
+  }
+  unsigned Width = LTy->getIntegerBitWidth();
+  bool Signed = Ty->hasSignedIntegerRepresentation();
+  switch (Op) {
+  case BO_MulAssign:
+  case BO_LAnd:
+    return llvm::ConstantInt::get(LTy, 1);
+  case BO_AndAssign:
+    return llvm::ConstantInt::get(CGF.getLLVMContext(),
+                                  llvm::APInt::getAllOnesValue(Width));
+  case BO_GT:
+    return llvm::ConstantInt::get(CGF.getLLVMContext(),
+                                  Signed ? llvm::APInt::getSignedMinValue(Width)
+                                         : llvm::APInt::getMinValue(Width));
+  case BO_LT:
+    return llvm::ConstantInt::get(CGF.getLLVMContext(),
+                                  Signed ? llvm::APInt::getSignedMaxValue(Width)
+                                         : llvm::APInt::getMaxValue(Width));
+  default:
+    return llvm::Constant::getNullValue(LTy);
+  }
+}
+
+/// \brief Combines the values \p LHS and \p RHS of type \p Ty with the
+/// reduction operator \p Op.
+static llvm::Value *emitOMPReductionOp(CodeGenFunction &CGF,
+                                       BinaryOperatorKind Op, QualType Ty,
+                                       llvm::Value *LHS, llvm::Value *RHS) {
+  CGBuilderTy &Builder = CGF.Builder;
+  if (Ty->isBooleanType()) {
+    // The operands are promoted to 'int', and the result converted back.
+    switch (Op) {
+    case BO_MulAssign:
+    case BO_AndAssign:
+    case BO_LAnd:
+    case BO_LT:
+      return Builder.CreateAnd(LHS, RHS);
+    case BO_XorAssign:
+      return Builder.CreateXor(LHS, RHS);
+    default:
+      return Builder.CreateOr(LHS, RHS);
+    }
+  }
+  bool IsFloat = Ty->isRealFloatingType();
+  switch (Op) {
+  case BO_AddAssign:
+    return IsFloat ? Builder.CreateFAdd(LHS, RHS) : Builder.CreateAdd(LHS, RHS);
+  case BO_MulAssign:
+    return IsFloat ? Builder.CreateFMul(LHS, RHS) : Builder.CreateMul(LHS, RHS);
+  case BO_AndAssign:
+    return Builder.CreateAnd(LHS, RHS);
+  case BO_OrAssign:
+    return Builder.CreateOr(LHS, RHS);
+  case BO_XorAssign:
+    return Builder.CreateXor(LHS, RHS);
+  case BO_LAnd:
+  case BO_LOr: {
+    QualType BoolTy = CGF.getContext().BoolTy;
+    LHS = CGF.EmitScalarConversion(LHS, Ty, BoolTy);
+    RHS = CGF.EmitScalarConversion(RHS, Ty, BoolTy);
+    return CGF.EmitScalarConversion(Op == BO_LAnd ? Builder.CreateAnd(LHS, RHS)
+                                                  : Builder.CreateOr(LHS, RHS),
+                                    BoolTy, Ty);
+  }
+  case BO_GT:
+  case BO_LT: {
+    // 'max' and 'min' keep the greater, or the lesser, value.
+    llvm::Value *Cmp;
+    if (IsFloat)
+      Cmp = Op == BO_GT ? Builder.CreateFCmpOGT(RHS, LHS)
+                        : Builder.CreateFCmpOLT(RHS, LHS);
+    else if (Ty->hasSignedIntegerRepresentation())
+      Cmp = Op == BO_GT ? Builder.CreateICmpSGT(RHS, LHS)
+                        : Builder.CreateICmpSLT(RHS, LHS);
+    else
+      Cmp = Op == BO_GT ? Builder.CreateICmpUGT(RHS, LHS)
+                        : Builder.CreateICmpULT(RHS, LHS);
+    return Builder.CreateSelect(Cmp, RHS, LHS);
+  }
+  default:
+    llvm_unreachable("unexpected reduction operator");
+  }
+}
+
+/// \brief Emits *\p LHSAddr = *\p LHSAddr op *\p RHSAddr for the reduction
+/// operator \p Op and variables of type \p Ty.
+static void emitOMPReductionUpdate(CodeGenFunction &CGF, BinaryOperatorKind Op,
+                                   QualType Ty, llvm::Value *LHSAddr,
+                                   llvm::Value *RHSAddr) {
+  LValue LHS = CGF.MakeNaturalAlignAddrLValue(LHSAddr, Ty);
+  LValue RHS = CGF.MakeNaturalAlignAddrLValue(RHSAddr, Ty);
+  llvm::Value *LHSVal = CGF.EmitLoadOfScalar(LHS, SourceLocation());
+  llvm::Value *RHSVal = CGF.EmitLoadOfScalar(RHS, SourceLocation());
+  CGF.EmitStoreOfScalar(emitOMPReductionOp(CGF, Op, Ty, LHSVal, RHSVal), LHS);
+}
+
+/// \brief Returns true if the reduction with operator \p Op of a variable of
+/// type \p Ty can be done by an atomicrmw instruction, and sets \p AtomicOp
+/// to its operation.
+static bool getOMPReductionAtomicOp(BinaryOperatorKind Op, QualType Ty,
+                                    llvm::AtomicRMWInst::BinOp &AtomicOp) {
+  if (!Ty->isIntegerType() || Ty->isBooleanType())
+    return false;
+  bool Signed = Ty->hasSignedIntegerRepresentation();
+  switch (Op) {
+  case BO_AddAssign:
+    AtomicOp = llvm::AtomicRMWInst::Add;
+    return true;
+  case BO_AndAssign:
+    AtomicOp = llvm::AtomicRMWInst::And;
+    return true;
+  case BO_OrAssign:
+    AtomicOp = llvm::AtomicRMWInst::Or;
+    return true;
+  case BO_XorAssign:
+    AtomicOp = llvm::AtomicRMWInst::Xor;
+    return true;
+  case BO_GT:
+    AtomicOp = Signed ? llvm::AtomicRMWInst::Max : llvm::AtomicRMWInst::UMax;
+    return true;
+  case BO_LT:
+    AtomicOp = Signed ? llvm::AtomicRMWInst::Min : llvm::AtomicRMWInst::UMin;
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// \brief Emits the function which the runtime calls to combine two arrays
+/// of private copies of the variables of \p Reductions:
+/// \code
+/// void .omp.reduction.reduction_func(void *lhs[N], void *rhs[N]) {
+///   *(T0 *)lhs[0] = *(T0 *)lhs[0] op0 *(T0 *)rhs[0];
+///   ...
+/// }
+/// \endcode
+static llvm::Function *emitOMPReductionFunction(
+    CodeGenModule &CGM, const OMPExecutableDirective &S,
+    ArrayRef<CodeGenFunction::OMPReductionItem> Reductions) {
+  ASTContext &C = CGM.getContext();
+  ImplicitParamDecl LHSArg(C, nullptr, S.getLocStart(), nullptr, C.VoidPtrTy);
+  ImplicitParamDecl RHSArg(C, nullptr, S.getLocStart(), nullptr, C.VoidPtrTy);
+  FunctionArgList Args;
+  Args.push_back(&LHSArg);
+  Args.push_back(&RHSArg);
+  const CGFunctionInfo &FnInfo = CGM.getTypes().arrangeFreeFunctionDeclaration(
+      C.VoidTy, Args, FunctionType::ExtInfo(), /*IsVariadic=*/false);
+  llvm::Function *Fn = llvm::Function::Create(
+      CGM.getTypes().GetFunctionType(FnInfo),
+      llvm::GlobalValue::InternalLinkage, ".omp.reduction.reduction_func",
+      &CGM.getModule());
+  CGM.SetInternalFunctionAttributes(
+      cast<CapturedStmt>(S.getAssociatedStmt())->getCapturedDecl(), Fn,
+      FnInfo);
+
+  CodeGenFunction CGF(CGM);
+  CGF.disableDebugInfo();
+  CGF.StartFunction(GlobalDecl(), C.VoidTy, Fn, FnInfo, Args);
+  llvm::Type *ArrayPtrTy =
+      llvm::ArrayType::get(CGM.VoidPtrTy, Reductions.size())->getPointerTo();
+  llvm::Value *LHS = CGF.Builder.CreateBitCast(
+      CGF.Builder.CreateLoad(CGF.GetAddrOfLocalVar(&LHSArg)), ArrayPtrTy);
+  llvm::Value *RHS = CGF.Builder.CreateBitCast(
+      CGF.Builder.CreateLoad(CGF.GetAddrOfLocalVar(&RHSArg)), ArrayPtrTy);
+  for (unsigned I = 0, E = Reductions.size(); I != E; ++I) {
+    QualType Ty = Reductions[I].Var->getType();
+    llvm::Type *PtrTy = CGF.ConvertTypeForMem(Ty)->getPointerTo();
+    llvm::Value *LHSElt = CGF.Builder.CreateBitCast(
+        CGF.Builder.CreateLoad(CGF.Builder.CreateConstGEP2_32(LHS, 0, I)),
+        PtrTy);
+    llvm::Value *RHSElt = CGF.Builder.CreateBitCast(
+        CGF.Builder.CreateLoad(CGF.Builder.CreateConstGEP2_32(RHS, 0, I)),
+        PtrTy);
+    emitOMPReductionUpdate(CGF, Reductions[I].Op, Ty, LHSElt, RHSElt);
+  }
+  CGF.FinishFunction();
+  return Fn;
+}
+
+void CodeGenFunction::EmitOMPReductionClauseInit(
+    const OMPExecutableDirective &S, OMPPrivateScope &PrivateScope,
+    SmallVectorImpl<OMPReductionItem> &Reductions) {
+  for (auto C : S.clauses()) {
+    auto RC = dyn_cast<OMPReductionClause>(C);
+    if (!RC)
+      continue;
+    BinaryOperatorKind Op = getOMPReductionOp(RC);
+    for (auto *E : RC->varlists()) {
+      auto DRE = cast<DeclRefExpr>(E);
+      auto VD = cast<VarDecl>(DRE->getDecl());
+      // A variable which is not referenced in the region keeps its value.
+      if (!isOMPReferenceableVar(VD))
+        continue;
+      QualType Ty = VD->getType();
+      if (!Ty->isIntegerType() && !Ty->isRealFloatingType()) {
+        CGM.ErrorUnsupported(&S, "reduction variable of this type");
+        continue;
+      }
+      OMPReductionItem Item;
+      Item.Var = VD;
+      Item.Op = Op;
+      Item.Original = EmitLValue(DRE).getAddress();
+      Item.Private = PrivateScope.addPrivate(VD);
+      EmitStoreOfScalar(getOMPReductionIdentity(*this, Op, Ty),
+                        MakeNaturalAlignAddrLValue(Item.Private, Ty));
+      Reductions.push_back(Item);
+    }
+  }
+}
+
+void CodeGenFunction::EmitOMPReductionClauseFinal(
+    const OMPExecutableDirective &S, ArrayRef<OMPReductionItem> Reductions,
+    bool UseRuntime, bool NoWait) {
+  if (Reductions.empty())
+    return;
+  if (!UseRuntime) {
+    for (auto &R : Reductions)
+      emitOMPReductionUpdate(*this, R.Op, R.Var->getType(), R.Original,
+                             R.Private);
+    return;
+  }
+
+  // The runtime chooses how the copies of the threads are combined, and
+  // returns:
+  // 1, if the current thread must combine its copies, which the runtime may
+  //    have combined with those of other threads with the reduction function,
+  //    with the original variables;
+  // 2, if each thread must combine its copies atomically;
+  // 0, if nothing is left to do for the current thread.
+  CGOpenMPRuntime &RT = CGM.getOpenMPRuntime();
+  SourceLocation Loc = S.getLocStart();
+  unsigned NumVars = Reductions.size();
+  llvm::ArrayType *ReduceDataTy = llvm::ArrayType::get(CGM.VoidPtrTy, NumVars);
+  llvm::Value *ReduceData =
+      CreateTempAlloca(ReduceDataTy, ".omp.reduction.red_list");
+  bool AllowAtomic = true;
+  SmallVector<llvm::AtomicRMWInst::BinOp, 4> AtomicOps;
+  for (unsigned I = 0; I != NumVars; ++I) {
+    Builder.CreateStore(EmitCastToVoidPtr(Reductions[I].Private),
+                        Builder.CreateConstGEP2_32(ReduceData, 0, I));
+    llvm::AtomicRMWInst::BinOp AtomicOp = llvm::AtomicRMWInst::BAD_BINOP;
+    AllowAtomic &= getOMPReductionAtomicOp(
+        Reductions[I].Op, Reductions[I].Var->getType(), AtomicOp);
+    AtomicOps.push_back(AtomicOp);
+  }
+  llvm::Value *Res = RT.EmitOMPReduceCall(
+      *this, Loc, NoWait, AllowAtomic, NumVars,
+      CGM.getDataLayout().getTypeAllocSize(ReduceDataTy),
+      EmitCastToVoidPtr(ReduceData),
+      emitOMPReductionFunction(CGM, S, Reductions));
+
+  llvm::BasicBlock *CombineBlock = createBasicBlock(".omp.reduction.case1");
+  llvm::BasicBlock *DoneBlock = createBasicBlock(".omp.reduction.default");
+  llvm::SwitchInst *Switch =
+      Builder.CreateSwitch(Res, DoneBlock, AllowAtomic ? 2 : 1);
+  Switch->addCase(Builder.getInt32(1), CombineBlock);
+  EmitBlock(CombineBlock);
+  for (auto &R : Reductions)
+    emitOMPReductionUpdate(*this, R.Op, R.Var->getType(), R.Original,
+                           R.Private);
+  RT.EmitOMPEndReduceCall(*this, Loc, NoWait);
+  EmitBranch(DoneBlock);
+  if (AllowAtomic) {
+    llvm::BasicBlock *AtomicBlock = createBasicBlock(".omp.reduction.case2");
+    Switch->addCase(Builder.getInt32(2), AtomicBlock);
+    EmitBlock(AtomicBlock);
+    for (unsigned I = 0; I != NumVars; ++I)
+      Builder.CreateAtomicRMW(AtomicOps[I], Reductions[I].Original,
+                              Builder.CreateLoad(Reductions[I].Private),
+                              llvm::Monotonic);
+    if (!NoWait)
+      RT.EmitOMPEndReduceCall(*this, Loc, NoWait);
+    EmitBranch(DoneBlock);
+  }
+  EmitBlock(DoneBlock);
+}
+
+void CodeGenFunction::EmitOMPInnerLoop(const Stmt *Body, llvm::Value *LB,
+                                       llvm::Value *UB,
+                                       ArrayRef<OMPLoopCounter> Counters,
+                                       ArrayRef<OMPLoopCounter> Linears) {
+  llvm::Type *IVTy = LB->getType();
+  llvm::Value *IV = CreateTempAlloca(IVTy, "omp.iv");
+  Builder.CreateStore(LB, IV);
+
+  JumpDest LoopExit = getJumpDestInCurrentScope("omp.inner.for.end");
+  JumpDest Continue = getJumpDestInCurrentScope("omp.inner.for.inc");
+  llvm::BasicBlock *CondBlock = createBasicBlock("omp.inner.for.cond");
+  EmitBlock(CondBlock);
+  LoopStack.push(CondBlock);
+
+  llvm::BasicBlock *ForBody = createBasicBlock("omp.inner.for.body");
+  llvm::Value *IVVal = Builder.CreateLoad(IV);
+  Builder.CreateCondBr(Builder.CreateICmpULE(IVVal, UB), ForBody,
+                       LoopExit.getBlock());
+  EmitBlock(ForBody);
+
+  // Compute the loop counters from the logical iteration number. With
+  // 'collapse', the counter of the innermost loop varies fastest.
+  llvm::Value *Idx = IVVal;
+  for (unsigned I = Counters.size(); I > 0; --I) {
+    const OMPLoopCounter &Counter = Counters[I - 1];
+    llvm::Value *LoopIdx = Idx;
+    if (I > 1) {
+      LoopIdx = Builder.CreateURem(Idx, Counter.NumIterations);
+      Idx = Builder.CreateUDiv(Idx, Counter.NumIterations);
+    }
+    setOMPLoopCounter(*this, Counter, LoopIdx);
+  }
+  for (auto &Linear : Linears)
+    setOMPLoopCounter(*this, Linear, IVVal);
+
+  BreakContinueStack.push_back(BreakContinue(LoopExit, Continue));
+  {
+    RunCleanupsScope BodyScope(*this);
+    EmitStmt(Body);
+  }
+  BreakContinueStack.pop_back();
+
+  EmitBlock(Continue.getBlock());
+  llvm::Value *One = llvm::ConstantInt::get(IVTy, 1);
+  Builder.CreateStore(Builder.CreateAdd(Builder.CreateLoad(IV), One), IV);
+  EmitBranch(CondBlock);
+  LoopStack.pop();
+
+  EmitBlock(LoopExit.getBlock());
+}
+
+/// \brief Decomposes the loops associated with \p S into \p Loops.
+/// \return The body of the innermost loop, or null if one of the loops
+/// cannot be emitted yet.
+static const Stmt *getCanonicalLoops(const OMPLoopDirective &S,
+                                     SmallVectorImpl<OMPCanonicalLoop> &Loops) {
   const CapturedStmt *CS = cast<CapturedStmt>(S.getAssociatedStmt());
+  Loops.resize(S.getCollapsedNumber());
   const Stmt *Body = CS->getCapturedStmt();
+  for (auto &L : Loops) {
+    const ForStmt *For = getCanonicalLoop(Body, L);
+    if (!For)
+      return nullptr;
+    Body = For->getBody();
+  }
+  return Body;
+}
+
+/// \brief Returns true if \p L may run once for every value of the type of
+/// its comparison, e.g. 'for (unsigned i = 0; i <= UINT_MAX; ++i)', so that
+/// its number of iterations does not fit in that type.
+static bool mayRunOverWholeRange(ASTContext &Ctx, const OMPCanonicalLoop &L) {
+  // A strict comparison leaves out at least one value.
+  if (L.TestIsStrictOp)
+    return false;
+
+  // So does a step of more than one.
+  llvm::APSInt Step;
+  if (L.Step && L.Step->EvaluateAsInt(Step, Ctx) &&
+      (Step.isSigned() ? Step.abs().ugt(1) : Step.ugt(1)))
+    return false;
+
+  // And so does a bound other than the extreme value of the type.
+  llvm::APSInt UB;
+  if (L.UB->EvaluateAsInt(UB, Ctx)) {
+    unsigned Width = Ctx.getTypeSize(L.UB->getType());
+    bool IsUnsigned = UB.isUnsigned();
+    llvm::APSInt Extreme =
+        L.TestIsLessOp ? llvm::APSInt::getMaxValue(Width, IsUnsigned)
+                       : llvm::APSInt::getMinValue(Width, IsUnsigned);
+    return UB.extOrTrunc(Width) == Extreme;
+  }
+  return true;
+}
+
+/// \brief Returns the type of the logical iteration number of \p Loops:
+/// unsigned integers of 32 bits if they are wide enough, and of 64 bits
+/// otherwise.
+static llvm::IntegerType *
+getOMPIterationType(CodeGenFunction &CGF, ArrayRef<OMPCanonicalLoop> Loops) {
+  ASTContext &Ctx = CGF.getContext();
+  unsigned IVSize = Loops.size() > 1 ? 64 : 32;
+  for (auto &L : Loops) {
+    uint64_t CmpSize = Ctx.getTypeSize(L.UB->getType());
+    if (Ctx.getTypeSize(L.Var->getType()) > 32 || CmpSize > 32 ||
+        (CmpSize == 32 && mayRunOverWholeRange(Ctx, L)))
+      IVSize = 64;
+  }
+  return CGF.Builder.getIntNTy(IVSize);
+}
+
+/// \brief Evaluates the bounds and steps of \p Loops into \p Counters, whose
+/// addresses are left null.
+/// \return The number of iterations of the loop nest.
+static llvm::Value *
+emitOMPLoopCounters(CodeGenFunction &CGF, ArrayRef<OMPCanonicalLoop> Loops,
+                    llvm::IntegerType *IVTy,
+                    MutableArrayRef<CodeGenFunction::OMPLoopCounter> Counters) {
+  CGBuilderTy &Builder = CGF.Builder;
+  llvm::Value *Zero = llvm::ConstantInt::get(IVTy, 0);
+  llvm::Value *One = llvm::ConstantInt::get(IVTy, 1);
+  llvm::Value *NumIterations = nullptr;
+  for (unsigned I = 0, E = Loops.size(); I != E; ++I) {
+    const OMPCanonicalLoop &L = Loops[I];
+    QualType VarTy = L.Var->getType();
+    // The condition compares the counter and the upper bound in this type.
+    QualType CmpTy = L.UB->getType();
+    bool CmpSigned = CmpTy->hasSignedIntegerRepresentation();
+
+    llvm::Value *LB = CGF.EmitScalarConversion(CGF.EmitScalarExpr(L.LB),
+                                               L.LB->getType(), VarTy);
+    llvm::Value *CmpLB = CGF.EmitScalarConversion(LB, VarTy, CmpTy);
+    llvm::Value *UB = CGF.EmitScalarExpr(L.UB);
+    llvm::Value *Step = One;
+    if (L.Step)
+      Step = Builder.CreateIntCast(
+          CGF.EmitScalarExpr(L.Step), IVTy,
+          L.Step->getType()->hasSignedIntegerRepresentation());
+    if (L.SubtractStep)
+      Step = Builder.CreateNeg(Step);
+
+    // The number of iterations is the distance between the bounds divided by
+    // the absolute value of the step, rounded up for strict comparisons.
+    llvm::Value *Lo = Builder.CreateIntCast(CmpLB, IVTy, CmpSigned);
+    llvm::Value *Hi = Builder.CreateIntCast(UB, IVTy, CmpSigned);
+    llvm::Value *Stride = Step;
+    if (!L.TestIsLessOp) {
+      std::swap(Lo, Hi);
+      Stride = Builder.CreateNeg(Step);
+    }
+    llvm::Value *Distance = Builder.CreateSub(Hi, Lo);
+    if (L.TestIsStrictOp)
+      Distance = Builder.CreateSub(Distance, One);
+    llvm::Value *Count =
+        Builder.CreateAdd(Builder.CreateUDiv(Distance, Stride), One);
+
+    // The loop has no iterations if the condition fails for the lower bound.
+    llvm::CmpInst::Predicate Pred;
+    if (L.TestIsLessOp)
+      Pred = L.TestIsStrictOp
+                 ? (CmpSigned ? llvm::CmpInst::ICMP_SLT
+                              : llvm::CmpInst::ICMP_ULT)
+                 : (CmpSigned ? llvm::CmpInst::ICMP_SLE
+                              : llvm::CmpInst::ICMP_ULE);
+    else
+      Pred = L.TestIsStrictOp
+                 ? (CmpSigned ? llvm::CmpInst::ICMP_SGT
+                              : llvm::CmpInst::ICMP_UGT)
+                 : (CmpSigned ? llvm::CmpInst::ICMP_SGE
+                              : llvm::CmpInst::ICMP_UGE);
+    Count = Builder.CreateSelect(Builder.CreateICmp(Pred, CmpLB, UB), Count,
+                                 Zero);
+
+    Counters[I].Var = L.Var;
+    Counters[I].Addr = nullptr;
+    Counters[I].Start = Builder.CreateIntCast(
+        LB, IVTy, VarTy->hasSignedIntegerRepresentation());
+    Counters[I].Step = Step;
+    Counters[I].NumIterations = Count;
+    NumIterations = NumIterations ? Builder.CreateMul(NumIterations, Count)
+                                  : Count;
+  }
+  return NumIterations;
+}
+
+void CodeGenFunction::EmitOMPWorksharingLoop(const OMPLoopDirective &S) {
+  SmallVector<OMPCanonicalLoop, 4> Loops;
+  const Stmt *Body = getCanonicalLoops(S, Loops);
+  if (!Body) {
+    CGM.ErrorUnsupported(&S, "OpenMP loop with non-integer loop counter");
+    return;
+  }
+
+  OpenMPScheduleClauseKind ScheduleKind = OMPC_SCHEDULE_unknown;
+  const Expr *ChunkExpr = nullptr;
+  SmallVector<const VarDecl *, 8> PrivateVars;
+  SmallVector<const DeclRefExpr *, 8> LastprivateRefs;
+  // The end of the parallel region of 'parallel for' is a barrier.
+  bool NoWait = S.getDirectiveKind() == OMPD_parallel_for;
+  for (auto C : S.clauses()) {
+    switch (C->getClauseKind()) {
+    case OMPC_schedule: {
+      auto SC = cast<OMPScheduleClause>(C);
+      ScheduleKind = SC->getScheduleKind();
+      ChunkExpr = SC->getChunkSize();
+      break;
+    }
+    case OMPC_lastprivate:
+      for (auto *E : cast<OMPLastprivateClause>(C)->varlists()) {
+        LastprivateRefs.push_back(cast<DeclRefExpr>(E));
+        PrivateVars.push_back(cast<VarDecl>(cast<DeclRefExpr>(E)->getDecl()));
+      }
+      break;
+    case OMPC_nowait:
+      NoWait = true;
+      break;
+    case OMPC_ordered:
+      CGM.ErrorUnsupported(&S, "clause on OpenMP loop directive");
+      return;
+    default:
+      // 'collapse' is reflected in the directive itself, the data-sharing
+      // clauses are emitted with the private copies, and the clauses of
+      // 'parallel for' which apply to the parallel region are handled like
+      // those of 'parallel'.
+      break;
+    }
+  }
+  for (auto VD : PrivateVars) {
+    if (!VD->getType().isPODType(getContext()) ||
+        VD->getType()->isVariablyModifiedType()) {
+      CGM.ErrorUnsupported(&S, "private variable of this type");
+      return;
+    }
+  }
+
+  // The logical iteration space [0, NumIterations) is scheduled with
+  // unsigned iteration variables.
+  llvm::IntegerType *IVTy = getOMPIterationType(*this, Loops);
+  unsigned IVSize = IVTy->getBitWidth();
+  llvm::Value *Zero = llvm::ConstantInt::get(IVTy, 0);
+  llvm::Value *One = llvm::ConstantInt::get(IVTy, 1);
+  SmallVector<OMPLoopCounter, 4> Counters(Loops.size());
+  llvm::Value *NumIterations =
+      emitOMPLoopCounters(*this, Loops, IVTy, Counters);
+
+  llvm::Value *Chunk = nullptr;
+  if (ChunkExpr)
+    Chunk = Builder.CreateIntCast(
+        EmitScalarExpr(ChunkExpr), IVTy,
+        ChunkExpr->getType()->hasSignedIntegerRepresentation());
+  CGOpenMPRuntime::OpenMPSchedType Schedule =
+      CGOpenMPRuntime::getSchedType(ScheduleKind, Chunk != nullptr);
+
+  // Get the addresses of the original 'lastprivate' variables. A variable
+  // which is referenced neither in the region nor around it (which may happen
+  // for 'parallel for', whose clauses are outside of the outlined region)
+  // keeps its value.
+  SmallVector<std::pair<const VarDecl *, llvm::Value *>, 8> LastprivateAddrs;
+  for (auto *DRE : LastprivateRefs) {
+    auto VD = cast<VarDecl>(DRE->getDecl());
+    if (isOMPReferenceableVar(VD))
+      LastprivateAddrs.push_back(
+          std::make_pair(VD, EmitLValue(DRE).getAddress()));
+  }
+
+  CGOpenMPRuntime &RT = CGM.getOpenMPRuntime();
+  SourceLocation Loc = S.getLocStart();
+  llvm::BasicBlock *ThenBlock = createBasicBlock("omp.precond.then");
+  llvm::BasicBlock *ContBlock = createBasicBlock("omp.precond.end");
+  Builder.CreateCondBr(Builder.CreateICmpNE(NumIterations, Zero), ThenBlock,
+                       ContBlock);
+  EmitBlock(ThenBlock);
+  {
+    OMPPrivateScope Privates(*this);
+    for (auto &Counter : Counters)
+      Counter.Addr = Privates.addPrivate(Counter.Var);
+    EmitOMPPrivateClauses(S, Privates);
+    for (auto VD : PrivateVars)
+      Privates.addPrivate(VD);
+    SmallVector<OMPReductionItem, 4> Reductions;
+    EmitOMPReductionClauseInit(S, Privates, Reductions);
+
+    llvm::Value *LastIteration = Builder.CreateSub(NumIterations, One);
+    llvm::Value *IL = CreateTempAlloca(Int32Ty, "omp.is_last");
+    llvm::Value *LBAddr = CreateTempAlloca(IVTy, "omp.lb");
+    llvm::Value *UBAddr = CreateTempAlloca(IVTy, "omp.ub");
+    llvm::Value *STAddr = CreateTempAlloca(IVTy, "omp.stride");
+    Builder.CreateStore(Builder.getInt32(0), IL);
+    Builder.CreateStore(Zero, LBAddr);
+    Builder.CreateStore(LastIteration, UBAddr);
+    Builder.CreateStore(One, STAddr);
+    RT.EmitOMPForInit(*this, Loc, Schedule, IVSize, /*IVSigned=*/false, IL,
+                      LBAddr, UBAddr, STAddr, Chunk);
+
+    if (Schedule == CGOpenMPRuntime::OMP_sch_static) {
+      // The runtime assigned a single chunk to this thread, whose upper bound
+      // may be past the last iteration.
+      llvm::Value *UB = Builder.CreateLoad(UBAddr);
+      UB = Builder.CreateSelect(Builder.CreateICmpUGT(UB, LastIteration),
+                                LastIteration, UB);
+      EmitOMPInnerLoop(Body, Builder.CreateLoad(LBAddr), UB, Counters);
+    } else {
+      // Loop over the chunks assigned to this thread: with a static chunked
+      // schedule, they are each 'stride' iterations after the previous one;
+      // otherwise, they are requested from the runtime one at a time.
+      bool IsStaticChunked = CGOpenMPRuntime::isStaticSchedule(Schedule);
+      llvm::BasicBlock *CondBlock = createBasicBlock("omp.dispatch.cond");
+      llvm::BasicBlock *BodyBlock = createBasicBlock("omp.dispatch.body");
+      llvm::BasicBlock *EndBlock = createBasicBlock("omp.dispatch.end");
+      EmitBlock(CondBlock);
+      llvm::Value *HasChunk;
+      if (IsStaticChunked)
+        HasChunk =
+            Builder.CreateICmpULE(Builder.CreateLoad(LBAddr), LastIteration);
+      else
+        HasChunk = Builder.CreateIsNotNull(
+            RT.EmitOMPForNext(*this, Loc, IVSize, /*IVSigned=*/false, IL,
+                              LBAddr, UBAddr, STAddr));
+      Builder.CreateCondBr(HasChunk, BodyBlock, EndBlock);
+      EmitBlock(BodyBlock);
+      llvm::Value *UB = Builder.CreateLoad(UBAddr);
+      if (IsStaticChunked)
+        UB = Builder.CreateSelect(Builder.CreateICmpUGT(UB, LastIteration),
+                                  LastIteration, UB);
+      EmitOMPInnerLoop(Body, Builder.CreateLoad(LBAddr), UB, Counters);
+      if (IsStaticChunked) {
+        llvm::Value *ST = Builder.CreateLoad(STAddr);
+        Builder.CreateStore(Builder.CreateAdd(Builder.CreateLoad(LBAddr), ST),
+                            LBAddr);
+        Builder.CreateStore(Builder.CreateAdd(Builder.CreateLoad(UBAddr), ST),
+                            UBAddr);
+      }
+      EmitBranch(CondBlock);
+      EmitBlock(EndBlock);
+    }
+    RT.EmitOMPForFinish(*this, Loc, Schedule);
+
+    // The thread which executed the last iteration stores the values of the
+    // 'lastprivate' variables. A loop counter gets the value it would have
+    // after the loop if it was executed sequentially.
+    if (!LastprivateAddrs.empty()) {
+      llvm::BasicBlock *LastBlock = createBasicBlock("omp.lastprivate.then");
+      llvm::BasicBlock *DoneBlock = createBasicBlock("omp.lastprivate.done");
+      Builder.CreateCondBr(Builder.CreateIsNotNull(Builder.CreateLoad(IL)),
+                           LastBlock, DoneBlock);
+      EmitBlock(LastBlock);
+      for (auto &Counter : Counters)
+        for (auto &Lastprivate : LastprivateAddrs)
+          if (Lastprivate.first == Counter.Var)
+            setOMPLoopCounter(*this, Counter, Counter.NumIterations);
+      for (auto &Lastprivate : LastprivateAddrs)
+        emitOMPCopy(*this, Lastprivate.first->getType(), Lastprivate.second,
+                    Privates.addPrivate(Lastprivate.first));
+      EmitBlock(DoneBlock);
+    }
+    EmitOMPReductionClauseFinal(S, Reductions, /*UseRuntime=*/true, NoWait);
+  }
+  EmitBlock(ContBlock);
+}
+
+void CodeGenFunction::EmitOMPSimdDirective(const OMPSimdDirective &S) {
   LoopStack.setParallel();
   LoopStack.setVectorizerEnable(true);
+  SmallVector<const DeclRefExpr *, 8> LastprivateRefs;
+  SmallVector<std::pair<const DeclRefExpr *, const Expr *>, 8> LinearRefs;
   for (auto C : S.clauses()) {
     switch (C->getClauseKind()) {
     case OMPC_safelen: {
@@ -66,16 +1011,145 @@ void CodeGenFunction::EmitOMPSimdDirective(const OMPSimdDirective &S) {
       LoopStack.setParallel(false);
       break;
     }
+    case OMPC_lastprivate:
+      for (auto *E : cast<OMPLastprivateClause>(C)->varlists())
+        LastprivateRefs.push_back(cast<DeclRefExpr>(E));
+      break;
+    case OMPC_linear: {
+      auto LC = cast<OMPLinearClause>(C);
+      for (auto *E : LC->varlists())
+        LinearRefs.push_back(std::make_pair(cast<DeclRefExpr>(E),
+                                            LC->getStep()));
+      break;
+    }
     default:
-      // Not handled yet
-      ;
+      // 'collapse' is reflected in the directive itself, and the private
+      // and reduction clauses are emitted with the private copies.
+      // 'aligned' only promises the alignment of pointers, which LLVM has
+      // no way to assume yet (see __assume in CGBuiltin.cpp).
+      break;
+    }
+  }
+
+  SmallVector<OMPCanonicalLoop, 4> Loops;
+  const Stmt *Body = getCanonicalLoops(S, Loops);
+  if (!Body) {
+    // A loop which is not in a form we can emit yet is executed as written,
+    // which is a valid execution of its iterations in a single SIMD lane.
+    OMPPrivateScope PrivateScope(*this);
+    EmitOMPPrivateClauses(S, PrivateScope);
+    SmallVector<OMPReductionItem, 4> Reductions;
+    EmitOMPReductionClauseInit(S, PrivateScope, Reductions);
+    EmitStmt(cast<CapturedStmt>(S.getAssociatedStmt())->getCapturedStmt());
+    EmitOMPReductionClauseFinal(S, Reductions, /*UseRuntime=*/false,
+                                /*NoWait=*/true);
+    return;
+  }
+  for (auto *DRE : LastprivateRefs) {
+    QualType Ty = DRE->getDecl()->getType();
+    if (!Ty.isPODType(getContext()) || Ty->isVariablyModifiedType()) {
+      CGM.ErrorUnsupported(&S, "private variable of this type");
+      return;
     }
   }
-  EmitStmt(Body);
+
+  // The iterations of the loop nest are numbered in [0, NumIterations), and
+  // its counters and the 'linear' variables are computed from that number on
+  // each iteration, so that they are all inductions of the same loop.
+  llvm::IntegerType *IVTy = getOMPIterationType(*this, Loops);
+  llvm::Value *Zero = llvm::ConstantInt::get(IVTy, 0);
+  llvm::Value *One = llvm::ConstantInt::get(IVTy, 1);
+  SmallVector<OMPLoopCounter, 4> Counters(Loops.size());
+  llvm::Value *NumIterations =
+      emitOMPLoopCounters(*this, Loops, IVTy, Counters);
+
+  // Get the addresses of the original variables which get the values of the
+  // last iteration: the 'lastprivate' and 'linear' variables, and the loop
+  // counters declared outside of the loops, which are predetermined
+  // 'linear'. The values of the 'linear' variables on the first iteration
+  // are those of the original variables.
+  SmallVector<std::pair<const VarDecl *, llvm::Value *>, 8> LastAddrs;
+  for (auto &L : Loops)
+    if (L.VarRef && isOMPReferenceableVar(L.Var))
+      LastAddrs.push_back(
+          std::make_pair(L.Var, EmitLValue(L.VarRef).getAddress()));
+  for (auto *DRE : LastprivateRefs) {
+    auto VD = cast<VarDecl>(DRE->getDecl());
+    if (isOMPReferenceableVar(VD))
+      LastAddrs.push_back(std::make_pair(VD, EmitLValue(DRE).getAddress()));
+  }
+  SmallVector<OMPLoopCounter, 4> Linears;
+  for (auto &Linear : LinearRefs) {
+    auto VD = cast<VarDecl>(Linear.first->getDecl());
+    if (!isOMPReferenceableVar(VD))
+      continue;
+    QualType Ty = VD->getType();
+    LValue Original = EmitLValue(Linear.first);
+    LastAddrs.push_back(std::make_pair(VD, Original.getAddress()));
+    OMPLoopCounter Counter;
+    Counter.Var = VD;
+    Counter.Addr = nullptr;
+    Counter.Start = EmitLoadOfScalar(Original, Linear.first->getExprLoc());
+    // An integer variable is computed in its own type, which may be wider
+    // than the iteration number, and a pointer is advanced by a number of
+    // elements of the type of the iteration number.
+    llvm::Type *StepTy = Ty->isPointerType() ? IVTy : Counter.Start->getType();
+    Counter.Step = llvm::ConstantInt::get(StepTy, 1);
+    if (const Expr *Step = Linear.second)
+      Counter.Step = Builder.CreateIntCast(
+          EmitScalarExpr(Step), StepTy,
+          Step->getType()->hasSignedIntegerRepresentation());
+    Counter.NumIterations = nullptr;
+    Linears.push_back(Counter);
+  }
+
+  llvm::BasicBlock *ThenBlock = createBasicBlock("omp.precond.then");
+  llvm::BasicBlock *ContBlock = createBasicBlock("omp.precond.end");
+  Builder.CreateCondBr(Builder.CreateICmpNE(NumIterations, Zero), ThenBlock,
+                       ContBlock);
+  EmitBlock(ThenBlock);
+  {
+    OMPPrivateScope Privates(*this);
+    for (auto &Counter : Counters)
+      Counter.Addr = Privates.addPrivate(Counter.Var);
+    for (auto &Linear : Linears)
+      Linear.Addr = Privates.addPrivate(Linear.Var);
+    EmitOMPPrivateClauses(S, Privates);
+    for (auto *DRE : LastprivateRefs)
+      Privates.addPrivate(cast<VarDecl>(DRE->getDecl()));
+    // The loop combines its partial results in private copies of the
+    // reduction variables, which do not prevent its vectorization.
+    SmallVector<OMPReductionItem, 4> Reductions;
+    EmitOMPReductionClauseInit(S, Privates, Reductions);
+
+    EmitOMPInnerLoop(Body, Zero, Builder.CreateSub(NumIterations, One),
+                     Counters, Linears);
+
+    // The loop counters and the 'linear' variables get the values they would
+    // have after a sequential execution of the loop, and the 'lastprivate'
+    // variables keep those of the last iteration.
+    for (auto &Counter : Counters)
+      setOMPLoopCounter(*this, Counter, Counter.NumIterations);
+    for (auto &Linear : Linears)
+      setOMPLoopCounter(*this, Linear, NumIterations);
+    for (auto &Last : LastAddrs)
+      emitOMPCopy(*this, Last.first->getType(), Last.second,
+                  Privates.addPrivate(Last.first));
+    EmitOMPReductionClauseFinal(S, Reductions, /*UseRuntime=*/false,
+                                /*NoWait=*/true);
+  }
+  EmitBlock(ContBlock);
 }
 
-void CodeGenFunction::EmitOMPForDirective(const OMPForDirective &) {
-  llvm_unreachable("CodeGen for 'omp for' is not supported yet.");
+void CodeGenFunction::EmitOMPForDirective(const OMPForDirective &S) {
+  EmitOMPWorksharingLoop(S);
+
+  // Emit an implicit barrier at the end, unless 'nowait' is specified.
+  for (auto C : S.clauses())
+    if (C->getClauseKind() == OMPC_nowait)
+      return;
+  CGM.getOpenMPRuntime().EmitOMPBarrierCall(
+      *this, S.getLocStart(), CGOpenMPRuntime::OMP_IDENT_BARRIER_IMPL_FOR);
 }
 
 void CodeGenFunction::EmitOMPSectionsDirective(const OMPSectionsDirective &) {
@@ -86,21 +1160,97 @@ void CodeGenFunction::EmitOMPSectionDirective(const OMPSectionDirective &) {
   llvm_unreachable("CodeGen for 'omp section' is not supported yet.");
 }
 
-void CodeGenFunction::EmitOMPSingleDirective(const OMPSingleDirective &) {
-  llvm_unreachable("CodeGen for 'omp single' is not supported yet.");
+void CodeGenFunction::EmitOMPSingleDirective(const OMPSingleDirective &S) {
+  bool NoWait = false;
+  for (auto C : S.clauses()) {
+    if (C->getClauseKind() == OMPC_nowait) {
+      NoWait = true;
+    } else if (C->getClauseKind() == OMPC_copyprivate) {
+      CGM.ErrorUnsupported(&S, "'copyprivate' clause");
+      return;
+    }
+  }
+
+  // Only the thread for which __kmpc_single returns non-zero executes the
+  // region.
+  CGOpenMPRuntime &RT = CGM.getOpenMPRuntime();
+  llvm::Value *IsSingle = RT.EmitOMPSingleCall(*this, S.getLocStart());
+  llvm::BasicBlock *ThenBlock = createBasicBlock("omp.single.then");
+  llvm::BasicBlock *ContBlock = createBasicBlock("omp.single.end");
+  Builder.CreateCondBr(Builder.CreateIsNotNull(IsSingle), ThenBlock,
+                       ContBlock);
+  EmitBlock(ThenBlock);
+  {
+    OMPPrivateScope PrivateScope(*this);
+    EmitOMPPrivateClauses(S, PrivateScope);
+    EmitStmt(cast<CapturedStmt>(S.getAssociatedStmt())->getCapturedStmt());
+    EnsureInsertPoint();
+  }
+  RT.EmitOMPEndSingleCall(*this, S.getLocStart());
+  EmitBlock(ContBlock);
+
+  // Emit an implicit barrier at the end, unless 'nowait' is specified.
+  if (!NoWait)
+    RT.EmitOMPBarrierCall(*this, S.getLocStart(),
+                          CGOpenMPRuntime::OMP_IDENT_BARRIER_IMPL_SINGLE);
 }
 
-void CodeGenFunction::EmitOMPMasterDirective(const OMPMasterDirective &) {
-  llvm_unreachable("CodeGen for 'omp master' is not supported yet.");
+void CodeGenFunction::EmitOMPMasterDirective(const OMPMasterDirective &S) {
+  // Only the master thread of the team, for which __kmpc_master returns
+  // non-zero, executes the region. There is no implied barrier.
+  CGOpenMPRuntime &RT = CGM.getOpenMPRuntime();
+  llvm::Value *IsMaster = RT.EmitOMPMasterCall(*this, S.getLocStart());
+  llvm::BasicBlock *ThenBlock = createBasicBlock("omp.master.then");
+  llvm::BasicBlock *ContBlock = createBasicBlock("omp.master.end");
+  Builder.CreateCondBr(Builder.CreateIsNotNull(IsMaster), ThenBlock,
+                       ContBlock);
+  EmitBlock(ThenBlock);
+  {
+    RunCleanupsScope Scope(*this);
+    EmitStmt(cast<CapturedStmt>(S.getAssociatedStmt())->getCapturedStmt());
+    EnsureInsertPoint();
+  }
+  RT.EmitOMPEndMasterCall(*this, S.getLocStart());
+  EmitBlock(ContBlock);
 }
 
-void CodeGenFunction::EmitOMPCriticalDirective(const OMPCriticalDirective &) {
-  llvm_unreachable("CodeGen for 'omp critical' is not supported yet.");
+void CodeGenFunction::EmitOMPCriticalDirective(const OMPCriticalDirective &S) {
+  // All the critical regions with the same name, including the unnamed ones,
+  // share the same lock.
+  CGOpenMPRuntime &RT = CGM.getOpenMPRuntime();
+  std::string Name = S.getDirectiveName().getAsString();
+  RT.EmitOMPCriticalCall(*this, S.getLocStart(), Name);
+  {
+    RunCleanupsScope Scope(*this);
+    EmitStmt(cast<CapturedStmt>(S.getAssociatedStmt())->getCapturedStmt());
+    EnsureInsertPoint();
+  }
+  RT.EmitOMPEndCriticalCall(*this, S.getLocStart(), Name);
 }
 
+namespace {
+/// \brief Emits the outlined region of a 'parallel for' directive, which is
+/// the worksharing loop itself. The end of the parallel region is an implicit
+/// barrier, so the loop needs none of its own.
+class CGParallelForStmtInfo : public CodeGenFunction::CGCapturedStmtInfo {
+  const OMPParallelForDirective &S;
+
+public:
+  explicit CGParallelForStmtInfo(const OMPParallelForDirective &S)
+      : CGCapturedStmtInfo(*cast<CapturedStmt>(S.getAssociatedStmt()),
+                           CR_OpenMP),
+        S(S) {}
+
+  void EmitBody(CodeGenFunction &CGF, Stmt *) override {
+    CGF.EmitOMPWorksharingLoop(S);
+  }
+};
+} // namespace
+
 void
-CodeGenFunction::EmitOMPParallelForDirective(const OMPParallelForDirective &) {
-  llvm_unreachable("CodeGen for 'omp parallel for' is not supported yet.");
+CodeGenFunction::EmitOMPParallelForDirective(const OMPParallelForDirective &S) {
+  CGParallelForStmtInfo CGInfo(S);
+  EmitOMPParallelCall(*this, S, CGInfo);
 }
 
 void CodeGenFunction::EmitOMPParallelSectionsDirective(
@@ -108,20 +1258,235 @@ void CodeGenFunction::EmitOMPParallelSectionsDirective(
   llvm_unreachable("CodeGen for 'omp parallel sections' is not supported yet.");
 }
 
-void CodeGenFunction::EmitOMPTaskDirective(const OMPTaskDirective &) {
-  llvm_unreachable("CodeGen for 'omp task' is not supported yet.");
+namespace {
+/// \brief A captured variable of a task region which gets a copy in each
+/// task, instead of being shared.
+struct OMPTaskPrivate {
+  const VarDecl *Var;
+  /// \brief The field of the captured record for the variable.
+  const FieldDecl *Field;
+  /// \brief True if the copy is initialized with the value of the original
+  /// variable when the task is created ('firstprivate').
+  bool IsFirstprivate;
+};
+} // namespace
+
+/// \brief Emits the entry of a task, which the runtime calls to run the
+/// outlined region \p OutlinedFn of the task region \p CS:
+/// \code
+/// kmp_int32 .omp_task_entry.(kmp_int32 gtid, void *task) {
+///   OutlinedFn(((kmp_task_t *)task)->shareds);
+///   return 0;
+/// }
+/// \endcode
+static llvm::Function *emitOMPTaskEntry(CodeGenModule &CGM,
+                                        const CapturedStmt &CS,
+                                        llvm::Function *OutlinedFn) {
+  ASTContext &C = CGM.getContext();
+  QualType Int32Ty = C.getIntTypeForBitwidth(32, /*Signed=*/true);
+  ImplicitParamDecl GtidArg(C, nullptr, CS.getLocStart(), nullptr, Int32Ty);
+  ImplicitParamDecl TaskArg(C, nullptr, CS.getLocStart(), nullptr,
+                            C.VoidPtrTy);
+  FunctionArgList Args;
+  Args.push_back(&GtidArg);
+  Args.push_back(&TaskArg);
+  const CGFunctionInfo &FnInfo = CGM.getTypes().arrangeFreeFunctionDeclaration(
+      Int32Ty, Args, FunctionType::ExtInfo(), /*IsVariadic=*/false);
+  llvm::Function *Fn = llvm::Function::Create(
+      CGM.getTypes().GetFunctionType(FnInfo),
+      llvm::GlobalValue::InternalLinkage, ".omp_task_entry.", &CGM.getModule());
+  CGM.SetInternalFunctionAttributes(CS.getCapturedDecl(), Fn, FnInfo);
+
+  CodeGenFunction CGF(CGM);
+  CGF.disableDebugInfo();
+  CGF.StartFunction(GlobalDecl(), Int32Ty, Fn, FnInfo, Args);
+  llvm::Value *Task = CGF.Builder.CreateBitCast(
+      CGF.Builder.CreateLoad(CGF.GetAddrOfLocalVar(&TaskArg)),
+      CGM.getOpenMPRuntime().getKmpTaskTTy()->getPointerTo());
+  llvm::Value *Shareds = CGF.Builder.CreateLoad(
+      CGF.Builder.CreateStructGEP(Task, CGOpenMPRuntime::KmpTaskTShareds));
+  CGF.EmitCallOrInvoke(OutlinedFn,
+                       CGF.Builder.CreateBitCast(
+                           Shareds, OutlinedFn->arg_begin()->getType()));
+  CGF.Builder.CreateStore(CGF.Builder.getInt32(0), CGF.ReturnValue);
+  CGF.FinishFunction();
+  return Fn;
+}
+
+/// \brief Executes \p Task immediately in the encountering thread, as
+/// required for an 'if' clause whose condition is false.
+static void emitOMPUndeferredTask(CodeGenFunction &CGF, SourceLocation Loc,
+                                  llvm::Function *TaskEntry,
+                                  llvm::Value *Task) {
+  CGOpenMPRuntime &RT = CGF.CGM.getOpenMPRuntime();
+  RT.EmitOMPTaskBeginIf0(CGF, Loc, Task);
+  llvm::Value *Args[] = {RT.GetOpenMPGlobalThreadNum(CGF, Loc), Task};
+  CGF.EmitCallOrInvoke(TaskEntry, Args);
+  RT.EmitOMPTaskCompleteIf0(CGF, Loc, Task);
+}
+
+void CodeGenFunction::EmitOMPTaskDirective(const OMPTaskDirective &S) {
+  const CapturedStmt *CS = cast<CapturedStmt>(S.getAssociatedStmt());
+  const RecordDecl *RD = CS->getCapturedRecordDecl();
+  QualType SharedsTy = getContext().getRecordType(RD);
+
+  const Expr *IfCond = nullptr;
+  const Expr *FinalCond = nullptr;
+  bool Tied = true;
+  llvm::SmallPtrSet<const VarDecl *, 8> PrivateVars, FirstprivateVars;
+  bool HasGlobalPrivates = false;
+  for (auto C : S.clauses()) {
+    switch (C->getClauseKind()) {
+    case OMPC_if:
+      IfCond = cast<OMPIfClause>(C)->getCondition();
+      break;
+    case OMPC_final:
+      FinalCond = cast<OMPFinalClause>(C)->getCondition();
+      break;
+    case OMPC_untied:
+      Tied = false;
+      break;
+    case OMPC_private:
+      for (auto *E : cast<OMPPrivateClause>(C)->varlists())
+        PrivateVars.insert(cast<VarDecl>(cast<DeclRefExpr>(E)->getDecl()));
+      break;
+    case OMPC_firstprivate:
+      // Sema adds the variables which are firstprivate by default.
+      for (auto *E : cast<OMPFirstprivateClause>(C)->varlists())
+        FirstprivateVars.insert(
+            cast<VarDecl>(cast<DeclRefExpr>(E)->getDecl()));
+      break;
+    default:
+      // 'shared' variables and 'default' need nothing beyond the captures,
+      // and 'mergeable' tasks are never merged.
+      break;
+    }
+  }
+
+  // Variables with global storage are not captured: the region refers to
+  // them directly, so they cannot be given a copy in the task yet.
+  for (auto *VD : PrivateVars)
+    HasGlobalPrivates |= VD->hasGlobalStorage();
+  for (auto *VD : FirstprivateVars)
+    HasGlobalPrivates |= VD->hasGlobalStorage();
+  if (HasGlobalPrivates) {
+    CGM.ErrorUnsupported(&S, "private variable with global storage");
+    return;
+  }
+
+  // The variables referenced in the region are captured by reference. The
+  // private ones get a copy in the task, at the end of the kmp_task_t.
+  SmallVector<OMPTaskPrivate, 8> Privates;
+  SmallVector<llvm::Type *, 8> PrivateTys;
+  RecordDecl::field_iterator Field = RD->field_begin();
+  for (auto I = CS->capture_begin(), E = CS->capture_end(); I != E;
+       ++I, ++Field) {
+    if (!I->capturesVariable())
+      continue;
+    const VarDecl *VD = I->getCapturedVar();
+    bool IsFirstprivate = FirstprivateVars.count(VD);
+    if (!IsFirstprivate && !PrivateVars.count(VD))
+      continue;
+    QualType Ty = VD->getType();
+    if (Ty->isReferenceType() || Ty->isVariablyModifiedType() ||
+        !Ty.isPODType(getContext())) {
+      CGM.ErrorUnsupported(&S, "private variable of this type");
+      return;
+    }
+    OMPTaskPrivate Private = {VD, *Field, IsFirstprivate};
+    Privates.push_back(Private);
+    PrivateTys.push_back(ConvertTypeForMem(Ty));
+  }
+
+  llvm::Value *CapturedStruct = GenerateCapturedStmtArgument(*CS);
+  llvm::Function *OutlinedFn;
+  {
+    CodeGenFunction OutlinedCGF(CGM, true);
+    CGCapturedStmtInfo CGInfo(*CS, CS->getCapturedRegionKind());
+    OutlinedCGF.CapturedStmtInfo = &CGInfo;
+    OutlinedFn = OutlinedCGF.GenerateCapturedStmtFunction(*CS);
+  }
+  llvm::Function *TaskEntry = emitOMPTaskEntry(CGM, *CS, OutlinedFn);
+
+  CGOpenMPRuntime &RT = CGM.getOpenMPRuntime();
+  SourceLocation Loc = S.getLocStart();
+  llvm::Value *Flags =
+      Builder.getInt32(Tied ? CGOpenMPRuntime::OMP_TASK_TIED : 0);
+  if (FinalCond)
+    Flags = Builder.CreateOr(
+        Flags, Builder.CreateSelect(
+                   EvaluateExprAsBool(FinalCond),
+                   Builder.getInt32(CGOpenMPRuntime::OMP_TASK_FINAL),
+                   Builder.getInt32(0)));
+  llvm::Type *TaskFields[] = {
+      RT.getKmpTaskTTy(), llvm::StructType::get(getLLVMContext(), PrivateTys)};
+  llvm::StructType *TaskTy =
+      llvm::StructType::get(getLLVMContext(), TaskFields);
+  llvm::Value *NewTask = RT.EmitOMPTaskAlloc(
+      *this, Loc, Flags, CGM.getDataLayout().getTypeAllocSize(TaskTy),
+      getContext().getTypeSizeInChars(SharedsTy).getQuantity(), TaskEntry);
+  llvm::Value *Task = Builder.CreateBitCast(NewTask, TaskTy->getPointerTo());
+
+  // Copy the captured struct to the shareds of the task, then point the
+  // fields of the private variables to their copies in the task.
+  llvm::Value *Shareds = Builder.CreateLoad(Builder.CreateStructGEP(
+      Builder.CreateStructGEP(Task, 0), CGOpenMPRuntime::KmpTaskTShareds));
+  LValue SharedsLV = MakeNaturalAlignAddrLValue(
+      Builder.CreateBitCast(Shareds, CapturedStruct->getType()), SharedsTy);
+  EmitAggregateCopy(SharedsLV.getAddress(), CapturedStruct, SharedsTy);
+  LValue CapturedLV = MakeNaturalAlignAddrLValue(CapturedStruct, SharedsTy);
+  llvm::Value *PrivatesAddr = Builder.CreateStructGEP(Task, 1);
+  for (unsigned I = 0, E = Privates.size(); I != E; ++I) {
+    llvm::Value *Private =
+        Builder.CreateStructGEP(PrivatesAddr, I, Privates[I].Var->getName());
+    if (Privates[I].IsFirstprivate) {
+      llvm::Value *Original = Builder.CreateLoad(
+          EmitLValueForFieldInitialization(CapturedLV, Privates[I].Field)
+              .getAddress());
+      emitOMPCopy(*this, Privates[I].Var->getType(), Private, Original);
+    }
+    Builder.CreateStore(
+        Private, EmitLValueForFieldInitialization(SharedsLV, Privates[I].Field)
+                     .getAddress());
+  }
+
+  // If the 'if' clause is false, the task is not deferred.
+  if (!IfCond) {
+    RT.EmitOMPTaskCall(*this, Loc, NewTask);
+    return;
+  }
+  bool CondConstant;
+  if (ConstantFoldsToSimpleInteger(IfCond, CondConstant)) {
+    if (CondConstant)
+      RT.EmitOMPTaskCall(*this, Loc, NewTask);
+    else
+      emitOMPUndeferredTask(*this, Loc, TaskEntry, NewTask);
+    return;
+  }
+  llvm::BasicBlock *ThenBlock = createBasicBlock("omp_if.then");
+  llvm::BasicBlock *ElseBlock = createBasicBlock("omp_if.else");
+  llvm::BasicBlock *ContBlock = createBasicBlock("omp_if.end");
+  EmitBranchOnBoolExpr(IfCond, ThenBlock, ElseBlock, /*TrueCount=*/0);
+  EmitBlock(ThenBlock);
+  RT.EmitOMPTaskCall(*this, Loc, NewTask);
+  EmitBranch(ContBlock);
+  EmitBlock(ElseBlock);
+  emitOMPUndeferredTask(*this, Loc, TaskEntry, NewTask);
+  EmitBlock(ContBlock);
 }
 
-void CodeGenFunction::EmitOMPTaskyieldDirective(const OMPTaskyieldDirective &) {
-  llvm_unreachable("CodeGen for 'omp taskyield' is not supported yet.");
+void
+CodeGenFunction::EmitOMPTaskyieldDirective(const OMPTaskyieldDirective &S) {
+  CGM.getOpenMPRuntime().EmitOMPTaskyieldCall(*this, S.getLocStart());
 }
 
-void CodeGenFunction::EmitOMPBarrierDirective(const OMPBarrierDirective &) {
-  llvm_unreachable("CodeGen for 'omp barrier' is not supported yet.");
+void CodeGenFunction::EmitOMPBarrierDirective(const OMPBarrierDirective &S) {
+  CGM.getOpenMPRuntime().EmitOMPBarrierCall(
+      *this, S.getLocStart(), CGOpenMPRuntime::OMP_IDENT_BARRIER_EXPL);
 }
 
-void CodeGenFunction::EmitOMPTaskwaitDirective(const OMPTaskwaitDirective &) {
-  llvm_unreachable("CodeGen for 'omp taskwait' is not supported yet.");
+void CodeGenFunction::EmitOMPTaskwaitDirective(const OMPTaskwaitDirective &S) {
+  CGM.getOpenMPRuntime().EmitOMPTaskwaitCall(*this, S.getLocStart());
 }
 
 void CodeGenFunction::EmitOMPFlushDirective(const OMPFlushDirective &) {
@@ -132,7 +1497,376 @@ void CodeGenFunction::EmitOMPOrderedDirective(const OMPOrderedDirective &) {
   llvm_unreachable("CodeGen for 'omp ordered' is not supported yet.");
 }
 
-void CodeGenFunction::EmitOMPAtomicDirective(const OMPAtomicDirective &) {
-  llvm_unreachable("CodeGen for 'omp atomic' is not supported yet.");
+namespace {
+/// \brief The update of the location 'x' of an 'omp atomic' construct, in one
+/// of the forms x++, x--, ++x, --x, x binop= expr, x = x binop expr and
+/// x = expr binop x, or the write x = expr of a capture.
+struct OMPAtomicUpdate {
+  /// \brief The updated lvalue 'x'.
+  const Expr *X;
+  /// \brief The operand 'expr', or null for increments and decrements.
+  const Expr *E;
+  /// \brief The operator, or BO_Assign for a write.
+  BinaryOperatorKind Op;
+  /// \brief True in the form x = expr binop x.
+  bool IsXRHS;
+  /// \brief True for x++ and x--, whose value is the old value of 'x'.
+  bool IsPostfix;
+  /// \brief The type of 'x' as an operand of the operator.
+  QualType XOpTy;
+  /// \brief The type of the result of the operator.
+  QualType ResultTy;
+};
+} // namespace
+
+/// \brief Returns true if \p Ty is an integer or real floating type.
+static bool isOMPAtomicArithmeticType(QualType Ty) {
+  return Ty->isIntegerType() || Ty->isRealFloatingType();
+}
+
+/// \brief Returns true if the lvalue \p X can be accessed atomically.
+static bool isOMPAtomicLValue(const Expr *X) {
+  return X->isGLValue() && !X->refersToBitField() &&
+         !X->refersToVectorElement() &&
+         CodeGenFunction::hasScalarEvaluationKind(X->getType());
+}
+
+/// \brief Returns true if \p LHS and \p RHS designate the same lvalue.
+static bool isSameOMPAtomicLValue(const ASTContext &C, const Expr *LHS,
+                                  const Expr *RHS) {
+  llvm::FoldingSetNodeID LHSID, RHSID;
+  LHS->IgnoreParenImpCasts()->Profile(LHSID, C, /*Canonical=*/true);
+  RHS->IgnoreParenImpCasts()->Profile(RHSID, C, /*Canonical=*/true);
+  return LHSID == RHSID;
+}
+
+/// \brief Recognizes the update \p S of an 'omp atomic' construct, which may
+/// also be a write if \p AllowWrite is true.
+/// \return False if \p S has none of the forms of OMPAtomicUpdate, or
+/// operates on unsupported types.
+static bool getOMPAtomicUpdate(const ASTContext &C, const Expr *S,
+                               bool AllowWrite, OMPAtomicUpdate &U) {
+  S = S->IgnoreParenImpCasts();
+  U.E = nullptr;
+  U.IsXRHS = false;
+  U.IsPostfix = false;
+  if (auto UO = dyn_cast<UnaryOperator>(S)) {
+    if (!UO->isIncrementDecrementOp() ||
+        UO->getSubExpr()->getType()->isBooleanType())
+      return false;
+    U.X = UO->getSubExpr();
+    U.Op = UO->isIncrementOp() ? BO_Add : BO_Sub;
+    U.IsPostfix = UO->isPostfix();
+    U.XOpTy = U.ResultTy = U.X->getType();
+  } else if (auto CAO = dyn_cast<CompoundAssignOperator>(S)) {
+    U.X = CAO->getLHS();
+    U.E = CAO->getRHS();
+    U.Op = BinaryOperator::getOpForCompoundAssignment(CAO->getOpcode());
+    U.XOpTy = CAO->getComputationLHSType();
+    U.ResultTy = CAO->getComputationResultType();
+  } else if (auto BO = dyn_cast<BinaryOperator>(S)) {
+    if (BO->getOpcode() != BO_Assign)
+      return false;
+    U.X = BO->getLHS();
+    auto RHS = dyn_cast<BinaryOperator>(BO->getRHS()->IgnoreParenImpCasts());
+    if (RHS && (RHS->isMultiplicativeOp() || RHS->isAdditiveOp() ||
+                RHS->isShiftOp() || RHS->isBitwiseOp()) &&
+        (isSameOMPAtomicLValue(C, U.X, RHS->getLHS()) ||
+         isSameOMPAtomicLValue(C, U.X, RHS->getRHS()))) {
+      U.Op = RHS->getOpcode();
+      U.IsXRHS = !isSameOMPAtomicLValue(C, U.X, RHS->getLHS());
+      U.E = U.IsXRHS ? RHS->getLHS() : RHS->getRHS();
+      U.XOpTy = (U.IsXRHS ? RHS->getRHS() : RHS->getLHS())->getType();
+      U.ResultTy = RHS->getType();
+    } else if (AllowWrite) {
+      U.Op = BO_Assign;
+      U.E = BO->getRHS();
+      U.XOpTy = U.ResultTy = U.X->getType();
+    } else {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  return isOMPAtomicLValue(U.X) && isOMPAtomicArithmeticType(U.X->getType()) &&
+         isOMPAtomicArithmeticType(U.XOpTy) &&
+         isOMPAtomicArithmeticType(U.ResultTy) &&
+         (!U.E || isOMPAtomicArithmeticType(U.E->getType()));
+}
+
+/// \brief Recognizes the assignment v = x of the value of 'x' to 'v' in an
+/// 'omp atomic' construct.
+static bool getOMPAtomicCaptureAssign(const Stmt *S, const Expr *&V,
+                                      const Expr *&X) {
+  auto E = dyn_cast<Expr>(S);
+  if (!E)
+    return false;
+  auto BO = dyn_cast<BinaryOperator>(E->IgnoreParenImpCasts());
+  if (!BO || BO->getOpcode() != BO_Assign)
+    return false;
+  V = BO->getLHS();
+  X = BO->getRHS()->IgnoreParenImpCasts();
+  QualType VTy = V->getType();
+  QualType XTy = X->getType();
+  return isOMPAtomicLValue(X) &&
+         CodeGenFunction::hasScalarEvaluationKind(VTy) &&
+         (VTy.getCanonicalType().getUnqualifiedType() ==
+              XTy.getCanonicalType().getUnqualifiedType() ||
+          (isOMPAtomicArithmeticType(VTy) && isOMPAtomicArithmeticType(XTy)));
+}
+
+/// \brief Emits \p LHS op \p RHS, where \p LHS has type \p Ty, and \p RHS
+/// type \p RHSTy.
+static llvm::Value *emitOMPAtomicBinOp(CodeGenFunction &CGF,
+                                       BinaryOperatorKind Op, QualType Ty,
+                                       llvm::Value *LHS, QualType RHSTy,
+                                       llvm::Value *RHS) {
+  CGBuilderTy &Builder = CGF.Builder;
+  if (Op == BO_Shl || Op == BO_Shr)
+    RHS = Builder.CreateIntCast(RHS, LHS->getType(), /*isSigned=*/false);
+  else
+    RHS = CGF.EmitScalarConversion(RHS, RHSTy, Ty);
+  bool IsFloat = Ty->isRealFloatingType();
+  bool IsSigned = Ty->hasSignedIntegerRepresentation();
+  switch (Op) {
+  case BO_Add:
+    return IsFloat ? Builder.CreateFAdd(LHS, RHS) : Builder.CreateAdd(LHS, RHS);
+  case BO_Sub:
+    return IsFloat ? Builder.CreateFSub(LHS, RHS) : Builder.CreateSub(LHS, RHS);
+  case BO_Mul:
+    return IsFloat ? Builder.CreateFMul(LHS, RHS) : Builder.CreateMul(LHS, RHS);
+  case BO_Div:
+    if (IsFloat)
+      return Builder.CreateFDiv(LHS, RHS);
+    return IsSigned ? Builder.CreateSDiv(LHS, RHS)
+                    : Builder.CreateUDiv(LHS, RHS);
+  case BO_Rem:
+    return IsSigned ? Builder.CreateSRem(LHS, RHS)
+                    : Builder.CreateURem(LHS, RHS);
+  case BO_Shl:
+    return Builder.CreateShl(LHS, RHS);
+  case BO_Shr:
+    return IsSigned ? Builder.CreateAShr(LHS, RHS)
+                    : Builder.CreateLShr(LHS, RHS);
+  case BO_And:
+    return Builder.CreateAnd(LHS, RHS);
+  case BO_Xor:
+    return Builder.CreateXor(LHS, RHS);
+  case BO_Or:
+    return Builder.CreateOr(LHS, RHS);
+  case BO_Assign:
+    return RHS;
+  default:
+    llvm_unreachable("unexpected atomic update operator");
+  }
+}
+
+/// \brief Returns true if the update \p U of the lvalue \p XLV can be done
+/// by an atomicrmw instruction, and sets \p RMWOp to its operation. Integer
+/// additions, subtractions and bitwise operations can: the conversions of
+/// 'x' and 'expr' to a wider integer type do not change the low-order bits
+/// of their result.
+static bool getOMPAtomicRMWOp(CodeGenFunction &CGF, const OMPAtomicUpdate &U,
+                              LValue XLV, llvm::AtomicRMWInst::BinOp &RMWOp) {
+  QualType XTy = U.X->getType();
+  if (!XTy->isIntegerType() || XTy->isBooleanType() ||
+      !U.XOpTy->isIntegerType() || !U.ResultTy->isIntegerType() ||
+      (U.E && !U.E->getType()->isIntegerType()))
+    return false;
+  ASTContext &C = CGF.getContext();
+  uint64_t Size = C.getTypeSize(XTy);
+  if (Size > C.getTargetInfo().getMaxAtomicInlineWidth() ||
+      Size > C.toBits(XLV.getAlignment()))
+    return false;
+  switch (U.Op) {
+  case BO_Add:
+    RMWOp = llvm::AtomicRMWInst::Add;
+    return true;
+  case BO_Sub:
+    RMWOp = llvm::AtomicRMWInst::Sub;
+    return !U.IsXRHS;
+  case BO_And:
+    RMWOp = llvm::AtomicRMWInst::And;
+    return true;
+  case BO_Or:
+    RMWOp = llvm::AtomicRMWInst::Or;
+    return true;
+  case BO_Xor:
+    RMWOp = llvm::AtomicRMWInst::Xor;
+    return true;
+  case BO_Assign:
+    RMWOp = llvm::AtomicRMWInst::Xchg;
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// \brief Emits the update \p U atomically, with ordering \p AO.
+/// \return The old and the new values of 'x'.
+static std::pair<llvm::Value *, llvm::Value *>
+emitOMPAtomicUpdate(CodeGenFunction &CGF, const OMPAtomicUpdate &U,
+                    llvm::AtomicOrdering AO, SourceLocation Loc) {
+  QualType XTy = U.X->getType();
+  LValue XLV = CGF.EmitLValue(U.X);
+  // 'expr' is evaluated once, before the update.
+  QualType ETy = U.E ? U.E->getType() : XTy;
+  llvm::Value *EVal;
+  if (U.E)
+    EVal = CGF.EmitScalarExpr(U.E);
+  else if (XTy->isRealFloatingType())
+    EVal = llvm::ConstantFP::get(CGF.ConvertType(XTy), 1.0);
+  else
+    EVal = llvm::ConstantInt::get(CGF.ConvertType(XTy), 1);
+
+  llvm::AtomicRMWInst::BinOp RMWOp;
+  if (getOMPAtomicRMWOp(CGF, U, XLV, RMWOp)) {
+    llvm::Value *RMWVal = CGF.EmitScalarConversion(EVal, ETy, XTy);
+    llvm::AtomicRMWInst *Old =
+        CGF.Builder.CreateAtomicRMW(RMWOp, XLV.getAddress(), RMWVal, AO);
+    Old->setVolatile(XLV.isVolatileQualified());
+    return std::make_pair(
+        Old, emitOMPAtomicBinOp(CGF, U.Op, XTy, Old, XTy, RMWVal));
+  }
+
+  // Otherwise, compute the new value until a compare-and-exchange succeeds.
+  std::pair<RValue, RValue> Res =
+      CGF.EmitAtomicUpdate(XLV, Loc, AO, [&](RValue Old) {
+        llvm::Value *XVal =
+            CGF.EmitScalarConversion(Old.getScalarVal(), XTy, U.XOpTy);
+        llvm::Value *New =
+            U.IsXRHS ? emitOMPAtomicBinOp(CGF, U.Op, ETy, EVal, U.XOpTy, XVal)
+                     : emitOMPAtomicBinOp(CGF, U.Op, U.XOpTy, XVal, ETy, EVal);
+        return RValue::get(CGF.EmitScalarConversion(New, U.ResultTy, XTy));
+      });
+  return std::make_pair(Res.first.getScalarVal(), Res.second.getScalarVal());
+}
+
+/// \brief Stores the value \p Val of 'x' into 'v', for the assignment v = x
+/// of an 'omp atomic' construct. The store itself is not atomic.
+static void emitOMPAtomicCaptureStore(CodeGenFunction &CGF, const Expr *V,
+                                      QualType XTy, llvm::Value *Val) {
+  Val = CGF.EmitScalarConversion(Val, XTy.getUnqualifiedType(),
+                                 V->getType().getUnqualifiedType());
+  CGF.EmitStoreThroughLValue(RValue::get(Val), CGF.EmitLValue(V));
+}
+
+/// \brief Emits the body \p S of an 'omp atomic read' construct, v = x.
+static bool emitOMPAtomicRead(CodeGenFunction &CGF, const Expr *S,
+                              llvm::AtomicOrdering AO, SourceLocation Loc) {
+  const Expr *V, *X;
+  if (!getOMPAtomicCaptureAssign(S, V, X))
+    return false;
+  RValue Val = CGF.EmitAtomicLoad(CGF.EmitLValue(X), Loc,
+                                  AggValueSlot::ignored(), AO);
+  emitOMPAtomicCaptureStore(CGF, V, X->getType(), Val.getScalarVal());
+  return true;
+}
+
+/// \brief Emits the body \p S of an 'omp atomic write' construct, x = expr.
+static bool emitOMPAtomicWrite(CodeGenFunction &CGF, const Expr *S,
+                               llvm::AtomicOrdering AO) {
+  auto BO = dyn_cast<BinaryOperator>(S->IgnoreParenImpCasts());
+  if (!BO || BO->getOpcode() != BO_Assign || !isOMPAtomicLValue(BO->getLHS()))
+    return false;
+  QualType XTy = BO->getLHS()->getType();
+  LValue XLV = CGF.EmitLValue(BO->getLHS());
+  llvm::Value *Val = CGF.EmitToMemory(CGF.EmitScalarExpr(BO->getRHS()), XTy);
+  CGF.EmitAtomicStore(RValue::get(Val), XLV, /*isInit=*/false, AO);
+  return true;
+}
+
+/// \brief Emits the body \p S of an 'omp atomic capture' construct, which is
+/// either v = update, or a block {v = x; update} or {update; v = x}, where
+/// the update of the first block may also be a write.
+static bool emitOMPAtomicCapture(CodeGenFunction &CGF, const Stmt *S,
+                                 llvm::AtomicOrdering AO, SourceLocation Loc) {
+  const ASTContext &C = CGF.getContext();
+  OMPAtomicUpdate U;
+  const Expr *V, *X;
+  bool CaptureOld;
+  if (auto E = dyn_cast<Expr>(S)) {
+    auto BO = dyn_cast<BinaryOperator>(E->IgnoreParenImpCasts());
+    if (!BO || BO->getOpcode() != BO_Assign ||
+        !getOMPAtomicUpdate(C, BO->getRHS(), /*AllowWrite=*/false, U))
+      return false;
+    V = BO->getLHS();
+    CaptureOld = U.IsPostfix;
+  } else if (auto CS = dyn_cast<CompoundStmt>(S)) {
+    if (CS->size() != 2)
+      return false;
+    const Stmt *First = CS->body_front();
+    const Stmt *Second = CS->body_back();
+    if (getOMPAtomicCaptureAssign(First, V, X) && isa<Expr>(Second) &&
+        getOMPAtomicUpdate(C, cast<Expr>(Second), /*AllowWrite=*/true, U) &&
+        isSameOMPAtomicLValue(C, X, U.X)) {
+      CaptureOld = true;
+    } else if (isa<Expr>(First) &&
+               getOMPAtomicUpdate(C, cast<Expr>(First), /*AllowWrite=*/false,
+                                  U) &&
+               getOMPAtomicCaptureAssign(Second, V, X) &&
+               isSameOMPAtomicLValue(C, X, U.X)) {
+      CaptureOld = false;
+    } else {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  QualType VTy = V->getType();
+  QualType XTy = U.X->getType();
+  if (!CodeGenFunction::hasScalarEvaluationKind(VTy) ||
+      !isOMPAtomicArithmeticType(VTy))
+    return false;
+  std::pair<llvm::Value *, llvm::Value *> Res =
+      emitOMPAtomicUpdate(CGF, U, AO, Loc);
+  emitOMPAtomicCaptureStore(CGF, V, XTy, CaptureOld ? Res.first : Res.second);
+  return true;
+}
+
+void CodeGenFunction::EmitOMPAtomicDirective(const OMPAtomicDirective &S) {
+  // The constructs are lowered to atomic instructions on 'x', which are
+  // sequentially consistent with the 'seq_cst' clause, and relaxed otherwise.
+  OpenMPClauseKind Kind = OMPC_update;
+  llvm::AtomicOrdering AO = llvm::Monotonic;
+  for (auto C : S.clauses()) {
+    if (C->getClauseKind() == OMPC_seq_cst)
+      AO = llvm::SequentiallyConsistent;
+    else
+      Kind = C->getClauseKind();
+  }
+  const Stmt *Body =
+      cast<CapturedStmt>(S.getAssociatedStmt())->getCapturedStmt();
+  if (auto E = dyn_cast<Expr>(Body))
+    Body = E->IgnoreImplicit();
+
+  bool Emitted = false;
+  switch (Kind) {
+  case OMPC_read:
+    Emitted = isa<Expr>(Body) &&
+              emitOMPAtomicRead(*this, cast<Expr>(Body), AO, S.getLocStart());
+    break;
+  case OMPC_write:
+    Emitted =
+        isa<Expr>(Body) && emitOMPAtomicWrite(*this, cast<Expr>(Body), AO);
+    break;
+  case OMPC_update: {
+    OMPAtomicUpdate U;
+    if (isa<Expr>(Body) &&
+        getOMPAtomicUpdate(getContext(), cast<Expr>(Body),
+                           /*AllowWrite=*/false, U)) {
+      emitOMPAtomicUpdate(*this, U, AO, S.getLocStart());
+      Emitted = true;
+    }
+    break;
+  }
+  case OMPC_capture:
+    Emitted = emitOMPAtomicCapture(*this, Body, AO, S.getLocStart());
+    break;
+  default:
+    llvm_unreachable("unexpected 'omp atomic' clause");
+  }
+  if (!Emitted)
+    CGM.ErrorUnsupported(&S, "OpenMP atomic expression");
 }
 
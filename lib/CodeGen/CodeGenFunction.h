@@ -31,6 +31,7 @@
 #include "clang/Frontend/CodeGenOptions.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/ValueHandle.h"
 #include "llvm/Support/Debug.h"
@@ -1950,6 +1951,101 @@ public:
   void EmitOMPOrderedDirective(const OMPOrderedDirective &S);
   void EmitOMPAtomicDirective(const OMPAtomicDirective &S);
 
+  /// \brief Maps variables to private copies for the duration of an OpenMP
+  /// construct. The original mapping is restored when the scope is exited.
+  class OMPPrivateScope {
+    CodeGenFunction &CGF;
+    /// \brief The privatized variables and their addresses before that.
+    SmallVector<std::pair<const VarDecl *, llvm::Value *>, 8> SavedAddrs;
+
+    OMPPrivateScope(const OMPPrivateScope &) LLVM_DELETED_FUNCTION;
+    void operator=(const OMPPrivateScope &) LLVM_DELETED_FUNCTION;
+
+  public:
+    explicit OMPPrivateScope(CodeGenFunction &CGF) : CGF(CGF) {}
+    ~OMPPrivateScope() { ForceCleanup(); }
+
+    /// \brief Returns the address of the private copy of \p VD, creating it
+    /// if \p VD is not private in this scope yet.
+    llvm::Value *addPrivate(const VarDecl *VD);
+
+    /// \brief Restores the original addresses of the privatized variables.
+    void ForceCleanup();
+  };
+
+  /// \brief A counter of one of the loops associated with an OpenMP loop
+  /// directive, in terms of the logical iteration space of its loop. The
+  /// variables of 'linear' clauses are described in terms of the logical
+  /// iteration space of the whole loop nest, with no NumIterations.
+  struct OMPLoopCounter {
+    /// \brief The loop counter variable.
+    const VarDecl *Var;
+    /// \brief The address of the private copy of the counter.
+    llvm::Value *Addr;
+    /// \brief The value of the counter on the first iteration. Start and Step
+    /// have the type of the logical iteration number, except for integer
+    /// 'linear' variables, which are computed in their own type.
+    llvm::Value *Start;
+    /// \brief The value added to the counter on each iteration.
+    llvm::Value *Step;
+    /// \brief The number of iterations of the loop.
+    llvm::Value *NumIterations;
+  };
+
+  /// \brief Emit the worksharing loop of a 'for' or 'parallel for' directive,
+  /// and store the values of the 'lastprivate' variables at its end.
+  void EmitOMPWorksharingLoop(const OMPLoopDirective &S);
+
+  /// \brief Emit the logical iterations [\p LB, \p UB] of an OpenMP loop
+  /// with body \p Body, setting \p Counters and the 'linear' variables
+  /// \p Linears at the start of each iteration.
+  void EmitOMPInnerLoop(const Stmt *Body, llvm::Value *LB, llvm::Value *UB,
+                        ArrayRef<OMPLoopCounter> Counters,
+                        ArrayRef<OMPLoopCounter> Linears = None);
+
+  /// \brief Returns true if \p VD can be referenced in the current function:
+  /// it is a global, a local of the function, or captured by the current
+  /// captured statement.
+  bool isOMPReferenceableVar(const VarDecl *VD) {
+    return VD->hasGlobalStorage() || LocalDeclMap.count(VD) ||
+           (CapturedStmtInfo && CapturedStmtInfo->lookup(VD));
+  }
+
+  /// \brief Emit the private copies of the variables of the 'private' and
+  /// 'firstprivate' clauses of \p S in \p PrivateScope, and initialize the
+  /// 'firstprivate' ones with the values of the original variables.
+  void EmitOMPPrivateClauses(const OMPExecutableDirective &S,
+                             OMPPrivateScope &PrivateScope);
+
+  /// \brief A variable of a 'reduction' clause.
+  struct OMPReductionItem {
+    const VarDecl *Var;
+    /// \brief The reduction operator, as in Sema: the compound assignment
+    /// for the arithmetic and bitwise operators, BO_LAnd and BO_LOr for the
+    /// logical ones, and BO_GT and BO_LT for 'max' and 'min'.
+    BinaryOperatorKind Op;
+    /// \brief The address of the original variable.
+    llvm::Value *Original;
+    /// \brief The address of the private copy of the variable.
+    llvm::Value *Private;
+  };
+
+  /// \brief Emit the private copies of the variables of the 'reduction'
+  /// clauses of \p S in \p PrivateScope, initialized with the identity value
+  /// of their reduction operator, and add them to \p Reductions.
+  void
+  EmitOMPReductionClauseInit(const OMPExecutableDirective &S,
+                             OMPPrivateScope &PrivateScope,
+                             SmallVectorImpl<OMPReductionItem> &Reductions);
+
+  /// \brief Combine the private copies of \p Reductions with the original
+  /// variables. If \p UseRuntime is true, the copies of all the threads of
+  /// the team are combined through __kmpc_reduce, or __kmpc_reduce_nowait if
+  /// \p NoWait is true; otherwise the current thread combines its own copies.
+  void EmitOMPReductionClauseFinal(const OMPExecutableDirective &S,
+                                   ArrayRef<OMPReductionItem> Reductions,
+                                   bool UseRuntime, bool NoWait);
+
   //===--------------------------------------------------------------------===//
   //                         LValue Expression Emission
   //===--------------------------------------------------------------------===//
@@ -1997,9 +2093,20 @@ public:
   void EmitAtomicInit(Expr *E, LValue lvalue);
 
   RValue EmitAtomicLoad(LValue lvalue, SourceLocation loc,
-                        AggValueSlot slot = AggValueSlot::ignored());
-
-  void EmitAtomicStore(RValue rvalue, LValue lvalue, bool isInit);
+                        AggValueSlot slot = AggValueSlot::ignored(),
+                        llvm::AtomicOrdering AO = llvm::SequentiallyConsistent);
+
+  void EmitAtomicStore(RValue rvalue, LValue lvalue, bool isInit,
+                       llvm::AtomicOrdering AO = llvm::SequentiallyConsistent);
+
+  /// \brief Atomically replaces the scalar or complex value of \p lvalue
+  /// with the result of \p UpdateOp applied to it, retrying with a
+  /// compare-and-exchange loop until no other thread changed the value in the
+  /// meantime. \p UpdateOp may thus be emitted and run several times.
+  /// \return The old and the new values.
+  std::pair<RValue, RValue>
+  EmitAtomicUpdate(LValue lvalue, SourceLocation loc, llvm::AtomicOrdering AO,
+                   llvm::function_ref<RValue(RValue)> UpdateOp);
 
   /// EmitToMemory - Change a scalar value from its value
   /// representation to its in-memory representation.
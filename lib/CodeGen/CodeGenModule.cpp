@@ -38,6 +38,7 @@
 #include "clang/Basic/Module.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Basic/Version.h"
 #include "clang/Frontend/CodeGenOptions.h"
 #include "clang/Sema/SemaDiagnostic.h"
@@ -333,7 +334,10 @@ void InstrProfStats::reportDiagnostics(DiagnosticsEngine &Diags,
 }
 
 void CodeGenModule::Release() {
-  EmitDeferred();
+  {
+    TimeTraceScope TimeScope("EmitDeferred");
+    EmitDeferred();
+  }
   applyReplacements();
   checkAliases();
   EmitCXXGlobalInitFunc();
@@ -3005,6 +3009,11 @@ void CodeGenModule::EmitTopLevelDecl(Decl *D) {
   if (D->getDeclContext() && D->getDeclContext()->isDependentContext())
     return;
 
+  TimeTraceScope TimeScope("EmitTopLevelDecl");
+  if (TimeScope.isEnabled())
+    if (const NamedDecl *ND = dyn_cast<NamedDecl>(D))
+      TimeScope.setDetail(ND->getQualifiedNameAsString());
+
   switch (D->getKind()) {
   case Decl::CXXConversion:
   case Decl::CXXMethod:
@@ -3167,6 +3176,36 @@ void CodeGenModule::EmitTopLevelDecl(Decl *D) {
   }
 }
 
+void CodeGenModule::DiscardEmittedFunctionBody(Decl *D) {
+  // Namespaces and linkage specs reach CodeGen as a whole.
+  if (isa<NamespaceDecl>(D) || isa<LinkageSpecDecl>(D)) {
+    for (auto *I : cast<DeclContext>(D)->decls())
+      DiscardEmittedFunctionBody(I);
+    return;
+  }
+
+  FunctionDecl *FD = dyn_cast<FunctionDecl>(D);
+  if (!FD || !FD->doesThisDeclarationHaveABody())
+    return;
+
+  // Inline functions are emitted again wherever they are used, constexpr
+  // functions can still be evaluated and templates instantiated. Structors
+  // are emitted in several variants, some of them only on demand.
+  if (FD->isInlined() || FD->isConstexpr() ||
+      FD->getTemplatedKind() != FunctionDecl::TK_NonTemplate ||
+      FD->isDependentContext() || isa<CXXConstructorDecl>(FD) ||
+      isa<CXXDestructorDecl>(FD))
+    return;
+
+  // Deferred definitions are only emitted at the end of the translation unit,
+  // if at all.
+  llvm::GlobalValue *GV = GetGlobalValue(getMangledName(FD));
+  if (!GV || GV->isDeclaration())
+    return;
+
+  Context.discardFunctionBody(FD);
+}
+
 void CodeGenModule::AddDeferredUnusedCoverageMapping(Decl *D) {
   // Do we need to generate coverage mapping?
   if (!CodeGenOpts.CoverageMapping)
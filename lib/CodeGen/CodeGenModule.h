@@ -826,6 +826,10 @@ public:
   /// Emit code for a single top level declaration.
   void EmitTopLevelDecl(Decl *D);
 
+  /// \brief Release the body of a top level function whose definition has
+  /// been emitted, if nothing later in the translation unit can need it.
+  void DiscardEmittedFunctionBody(Decl *D);
+
   /// \brief Stored a deferred empty coverage mapping for an unused
   /// and thus uninstrumented top level declaration.
   void AddDeferredUnusedCoverageMapping(Decl *D);
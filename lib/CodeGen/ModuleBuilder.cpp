@@ -110,8 +110,11 @@ namespace {
       HandlingTopLevelDeclRAII HandlingDecl(*this);
 
       // Make sure to emit all elements of a Decl.
-      for (DeclGroupRef::iterator I = DG.begin(), E = DG.end(); I != E; ++I)
+      for (DeclGroupRef::iterator I = DG.begin(), E = DG.end(); I != E; ++I) {
         Builder->EmitTopLevelDecl(*I);
+        if (CodeGenOpts.DiscardEmittedFunctionBodies)
+          Builder->DiscardEmittedFunctionBody(*I);
+      }
 
       return true;
     }
@@ -3718,6 +3718,16 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back(Args.MakeArgString("-mstack-alignment=" + alignment));
   }
 
+  // The objects of the pieces of the module are combined with the linker of
+  // the toolchain.
+  if (Arg *A = Args.getLastArg(options::OPT_fparallel_codegen_EQ)) {
+    CmdArgs.push_back(
+        Args.MakeArgString(Twine("-fparallel-codegen=") + A->getValue()));
+    CmdArgs.push_back("-parallel-codegen-linker");
+    CmdArgs.push_back(
+        Args.MakeArgString(getToolChain().GetProgramPath("ld")));
+  }
+
   if (getToolChain().getTriple().getArch() == llvm::Triple::aarch64 ||
       getToolChain().getTriple().getArch() == llvm::Triple::aarch64_be)
     CmdArgs.push_back("-fallow-half-arguments-and-returns");
@@ -3875,6 +3885,8 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   Args.AddAllArgs(CmdArgs, options::OPT_fmodules_ignore_macro);
   Args.AddLastArg(CmdArgs, options::OPT_fmodules_prune_interval);
   Args.AddLastArg(CmdArgs, options::OPT_fmodules_prune_after);
+  Args.AddLastArg(CmdArgs, options::OPT_fmodules_cache_size_limit);
+  Args.AddLastArg(CmdArgs, options::OPT_fmodules_embed_all_files);
 
   Args.AddLastArg(CmdArgs, options::OPT_fbuild_session_timestamp);
 
@@ -4006,6 +4018,11 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
                    options::OPT_fno_delayed_template_parsing, IsWindowsMSVC))
     CmdArgs.push_back("-fdelayed-template-parsing");
 
+  // -fno-pch-instantiate-templates is default.
+  if (Args.hasFlag(options::OPT_fpch_instantiate_templates,
+                   options::OPT_fno_pch_instantiate_templates, false))
+    CmdArgs.push_back("-fpch-instantiate-templates");
+
   // -fgnu-keywords default varies depending on language; only pass if
   // specified.
   if (Arg *A = Args.getLastArg(options::OPT_fgnu_keywords,
@@ -4294,6 +4311,7 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   if (!Args.hasFlag(options::OPT_fspell_checking,
                     options::OPT_fno_spell_checking))
     CmdArgs.push_back("-fno-spell-checking");
+  Args.AddLastArg(CmdArgs, options::OPT_fspell_checking_time_budget_EQ);
 
 
   // -fno-asm-blocks is default.
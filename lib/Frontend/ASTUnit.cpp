@@ -1960,7 +1960,10 @@ ASTUnit *ASTUnit::LoadFromCommandLine(
   // Override the resources path.
   CI->getHeaderSearchOpts().ResourceDir = ResourceFilesPath;
 
-  CI->getFrontendOpts().SkipFunctionBodies = SkipFunctionBodies;
+  // Lazy-body mode skips function bodies too; FunctionDecl::getBody parses
+  // them once the unit is loaded.
+  CI->getFrontendOpts().SkipFunctionBodies =
+      SkipFunctionBodies || CI->getFrontendOpts().LazyFunctionBodies;
 
   // Create the AST unit.
   std::unique_ptr<ASTUnit> AST;
@@ -20,7 +20,11 @@
 #include "clang/Parse/ParseAST.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/ASTWriter.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 
 using namespace clang;
 
@@ -104,6 +108,116 @@ createASTReader(CompilerInstance &CI, StringRef pchFile,
   return nullptr;
 }
 
+namespace {
+/// \brief Checks that none of the input files of a cached chained include
+/// were modified after the cache entry was written.
+class CachedChainedIncludeValidator : public ASTReaderListener {
+  llvm::sys::TimeValue CacheTime;
+
+public:
+  bool OutOfDate;
+
+  explicit CachedChainedIncludeValidator(llvm::sys::TimeValue CacheTime)
+      : CacheTime(CacheTime), OutOfDate(false) {}
+
+  bool needsInputFileVisitation() override { return true; }
+  bool needsSystemInputFileVisitation() override { return true; }
+  bool visitInputFile(StringRef Filename, bool isSystem,
+                      bool isOverridden) override {
+    llvm::sys::fs::file_status Status;
+    if (isOverridden || llvm::sys::fs::status(Filename, Status) ||
+        Status.getLastModificationTime() > CacheTime) {
+      OutOfDate = true;
+      return false;
+    }
+    return true;
+  }
+};
+}
+
+/// \brief Compute the name of the chained include cache entry for
+/// \p Include, extending the running \p Key with everything the serialized
+/// state of the include prefix depends on.
+///
+/// \returns the path of the cache entry, or an empty string if \p Include
+/// cannot be cached.
+static std::string getChainedIncludeCacheFile(const CompilerInvocation &CInvok,
+                                              InputKind IK, StringRef CachePath,
+                                              StringRef Include,
+                                              llvm::hash_code &Key) {
+  SmallString<128> IncludePath(Include);
+  llvm::sys::fs::file_status Status;
+  if (llvm::sys::fs::make_absolute(IncludePath) ||
+      llvm::sys::fs::status(IncludePath.str(), Status))
+    return std::string();
+
+  Key = llvm::hash_combine(Key, CInvok.getModuleHash(),
+                           static_cast<unsigned>(IK), IncludePath.str(),
+                           Status.getSize(),
+                           Status.getLastModificationTime().toEpochTime());
+  const HeaderSearchOptions &HSOpts = CInvok.getHeaderSearchOpts();
+  for (const auto &Entry : HSOpts.UserEntries)
+    Key = llvm::hash_combine(Key, Entry.Path,
+                             static_cast<unsigned>(Entry.Group),
+                             Entry.IsFramework);
+
+  SmallString<128> CacheFile(CachePath);
+  llvm::sys::path::append(CacheFile, llvm::sys::path::filename(Include));
+  CacheFile += "-";
+  CacheFile += llvm::utohexstr(static_cast<size_t>(Key));
+  CacheFile += ".pch";
+  return CacheFile.str();
+}
+
+/// \brief Load a chained include cache entry, provided that none of the
+/// files it was built from changed since it was written.
+static std::unique_ptr<llvm::MemoryBuffer>
+readChainedIncludeCacheFile(StringRef CacheFile, FileManager &FileMgr) {
+  llvm::sys::fs::file_status Status;
+  if (llvm::sys::fs::status(CacheFile, Status))
+    return nullptr;
+
+  CachedChainedIncludeValidator Validator(Status.getLastModificationTime());
+  if (ASTReader::readASTFileControlBlock(CacheFile, FileMgr, Validator) ||
+      Validator.OutOfDate)
+    return nullptr;
+
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+      llvm::MemoryBuffer::getFile(CacheFile);
+  if (!Buffer)
+    return nullptr;
+  return std::move(*Buffer);
+}
+
+/// \brief Store a serialized chained include in the cache. Failures are
+/// ignored; the entry is simply rebuilt by the next translation unit.
+static void writeChainedIncludeCacheFile(StringRef CacheFile,
+                                         StringRef Contents) {
+  StringRef CacheDir = llvm::sys::path::parent_path(CacheFile);
+  if (llvm::sys::fs::create_directories(CacheDir))
+    return;
+
+  // Write to a temporary file and rename it into place, so that concurrent
+  // compilations never observe a partially written entry.
+  SmallString<128> TempPath(CacheFile);
+  TempPath += "-%%%%%%%%";
+  int FD;
+  if (llvm::sys::fs::createUniqueFile(TempPath.str(), FD, TempPath))
+    return;
+
+  llvm::raw_fd_ostream Out(FD, /*shouldClose=*/true);
+  Out << Contents;
+  Out.close();
+  if (Out.has_error()) {
+    Out.clear_error();
+    llvm::sys::fs::remove(TempPath.str());
+    return;
+  }
+
+  if (llvm::sys::fs::rename(TempPath.str(), CacheFile))
+    llvm::sys::fs::remove(TempPath.str());
+}
+
 ChainedIncludesSource::~ChainedIncludesSource() {
   for (unsigned i = 0, e = CIs.size(); i != e; ++i)
     delete CIs[i];
@@ -121,8 +235,22 @@ IntrusiveRefCntPtr<ExternalSemaSource> clang::createChainedIncludesSource(
   SmallVector<std::unique_ptr<llvm::MemoryBuffer>, 4> SerialBufs;
   SmallVector<std::string, 4> serialBufNames;
 
+  // Each cache entry is only valid on top of the exact entries it was built
+  // against, so the key accumulates over the include prefix and, once one
+  // include has to be rebuilt, every later one is rebuilt as well.
+  StringRef CachePath = CI.getPreprocessorOpts().ChainedIncludesCachePath;
+  llvm::hash_code CacheKey = llvm::hash_value(CachePath);
+  bool ReadFromCache = !CachePath.empty();
+
   for (unsigned i = 0, e = includes.size(); i != e; ++i) {
     bool firstInclude = (i == 0);
+    if (!firstInclude) {
+      std::string pchName = includes[i-1];
+      llvm::raw_string_ostream os(pchName);
+      os << ".pch" << i-1;
+      serialBufNames.push_back(os.str());
+    }
+
     std::unique_ptr<CompilerInvocation> CInvok;
     CInvok.reset(new CompilerInvocation(CI.getInvocation()));
     
@@ -138,6 +266,19 @@ IntrusiveRefCntPtr<ExternalSemaSource> clang::createChainedIncludesSource(
     FrontendInputFile InputFile(includes[i], IK);
     CInvok->getFrontendOpts().Inputs.push_back(InputFile);
 
+    std::string CacheFile;
+    if (!CachePath.empty())
+      CacheFile = getChainedIncludeCacheFile(*CInvok, IK, CachePath,
+                                             includes[i], CacheKey);
+    if (ReadFromCache && !CacheFile.empty()) {
+      if (std::unique_ptr<llvm::MemoryBuffer> Cached =
+              readChainedIncludeCacheFile(CacheFile, CI.getFileManager())) {
+        SerialBufs.push_back(std::move(Cached));
+        continue;
+      }
+    }
+    ReadFromCache = false;
+
     TextDiagnosticPrinter *DiagClient =
       new TextDiagnosticPrinter(llvm::errs(), new DiagnosticOptions());
     IntrusiveRefCntPtr<DiagnosticIDs> DiagID(new DiagnosticIDs());
@@ -177,14 +318,10 @@ IntrusiveRefCntPtr<ExternalSemaSource> clang::createChainedIncludesSource(
       // allocating new ones.
       for (auto &SB : SerialBufs)
         Bufs.push_back(llvm::MemoryBuffer::getMemBuffer(SB->getBuffer()));
-      std::string pchName = includes[i-1];
-      llvm::raw_string_ostream os(pchName);
-      os << ".pch" << i-1;
-      serialBufNames.push_back(os.str());
 
       IntrusiveRefCntPtr<ASTReader> Reader;
       Reader = createASTReader(
-          *Clang, pchName, Bufs, serialBufNames,
+          *Clang, serialBufNames.back(), Bufs, serialBufNames,
           Clang->getASTConsumer().GetASTDeserializationListener());
       if (!Reader)
         return nullptr;
@@ -197,6 +334,8 @@ IntrusiveRefCntPtr<ExternalSemaSource> clang::createChainedIncludesSource(
 
     ParseAST(Clang->getSema());
     Clang->getDiagnosticClient().EndSourceFile();
+    if (!CacheFile.empty() && !Clang->getDiagnostics().hasErrorOccurred())
+      writeChainedIncludeCacheFile(CacheFile, OS.str());
     SerialBufs.push_back(llvm::MemoryBuffer::getMemBufferCopy(OS.str()));
     source->CIs.push_back(Clang.release());
   }
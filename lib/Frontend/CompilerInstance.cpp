@@ -15,6 +15,7 @@
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Basic/Version.h"
 #include "clang/Config/config.h"
 #include "clang/Frontend/ChainedDiagnosticConsumer.h"
@@ -45,6 +46,7 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <sys/stat.h>
 #include <system_error>
 #include <time.h>
@@ -374,6 +376,10 @@ void CompilerInstance::createPreprocessor(TranslationUnitKind TUKind) {
     AttachHeaderIncludeGen(*PP, /*ShowAllHeaders=*/false, /*OutputPath=*/"",
                            /*ShowDepth=*/true, /*MSStyle=*/true);
   }
+
+  // Handle tracing the time spent in each source file, if requested.
+  if (TimeTraceProfiler::getCurrent())
+    AttachTimeTraceCallbacks(*PP);
 }
 
 // ASTContext
@@ -1132,9 +1138,62 @@ static void writeTimestampFile(StringRef TimestampFile) {
   llvm::raw_fd_ostream Out(TimestampFile.str(), EC, llvm::sys::fs::F_None);
 }
 
-/// \brief Prune the module cache of modules that haven't been accessed in
-/// a long time.
-static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
+namespace {
+/// \brief A module file that is a candidate for eviction when the module
+/// cache exceeds its size limit.
+struct PrunableModuleFile {
+  std::string Path;
+  uint64_t Size;
+  time_t AccessTime;
+
+  bool operator<(const PrunableModuleFile &Other) const {
+    return AccessTime < Other.AccessTime;
+  }
+};
+}
+
+/// \brief Remove the module file \p Path, its timestamp file, and the global
+/// module index of its directory, which would otherwise still refer to it.
+static bool removeModuleFile(StringRef Path) {
+  if (llvm::sys::fs::remove(Path))
+    return false;
+
+  llvm::sys::fs::remove(Path + ".timestamp");
+  SmallString<128> IndexFile = llvm::sys::path::parent_path(Path);
+  llvm::sys::path::append(IndexFile, "modules.idx");
+  llvm::sys::fs::remove(IndexFile.str());
+  return true;
+}
+
+/// \brief Remove the least recently used module files in \p Files until their
+/// total size is no larger than \p SizeLimit.
+static void pruneModuleCacheToSize(std::vector<PrunableModuleFile> &Files,
+                                   uint64_t TotalSize, uint64_t SizeLimit) {
+  if (TotalSize <= SizeLimit)
+    return;
+
+  std::sort(Files.begin(), Files.end());
+  for (std::vector<PrunableModuleFile>::iterator F = Files.begin(),
+                                                 FEnd = Files.end();
+       F != FEnd && TotalSize > SizeLimit; ++F) {
+    if (!removeModuleFile(F->Path))
+      continue;
+    TotalSize -= F->Size;
+
+    // If we removed the last module file in its directory, remove the
+    // directory itself.
+    std::error_code EC;
+    StringRef Dir = llvm::sys::path::parent_path(F->Path);
+    if (llvm::sys::fs::directory_iterator(Dir, EC) ==
+            llvm::sys::fs::directory_iterator() && !EC)
+      llvm::sys::fs::remove(Dir);
+  }
+}
+
+/// \brief Determine whether the pruning interval has elapsed since the module
+/// cache was last pruned of unused modules, and if so, restart it.
+static bool isModuleCachePruneDue(const HeaderSearchOptions &HSOpts,
+                                  time_t CurrentTime) {
   struct stat StatBuf;
   llvm::SmallString<128> TimestampFile;
   TimestampFile = HSOpts.ModuleCachePath;
@@ -1146,23 +1205,42 @@ static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
     if (errno == ENOENT) {
       writeTimestampFile(TimestampFile);
     }
-    return;
+    return false;
   }
 
   // Check whether the time stamp is older than our pruning interval.
   // If not, do nothing.
   time_t TimeStampModTime = StatBuf.st_mtime;
-  time_t CurrentTime = time(nullptr);
   if (CurrentTime - TimeStampModTime <= time_t(HSOpts.ModuleCachePruneInterval))
-    return;
+    return false;
 
   // Write a new timestamp file so that nobody else attempts to prune.
   // There is a benign race condition here, if two Clang instances happen to
   // notice at the same time that the timestamp is out-of-date.
   writeTimestampFile(TimestampFile);
+  return true;
+}
+
+/// \brief Prune the module cache of modules that haven't been accessed in
+/// a long time, and, if the cache has a size limit, of the least recently
+/// used modules that don't fit within that limit.
+///
+/// Unused modules are only looked for once per pruning interval, but the size
+/// limit is enforced every time, so that the cache never grows past it.
+static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
+  struct stat StatBuf;
+  time_t CurrentTime = time(nullptr);
+  bool PruneUnused = HSOpts.ModuleCachePruneInterval > 0 &&
+                     HSOpts.ModuleCachePruneAfter > 0 &&
+                     isModuleCachePruneDue(HSOpts, CurrentTime);
+  if (!PruneUnused && !HSOpts.ModuleCacheSizeLimit)
+    return;
 
   // Walk the entire module cache, looking for unused module files and module
-  // indices.
+  // indices. Module files that are kept are recorded in case we need to evict
+  // some of them to honor the cache size limit.
+  std::vector<PrunableModuleFile> KeptModuleFiles;
+  uint64_t KeptModuleFilesSize = 0;
   std::error_code EC;
   SmallString<128> ModuleCachePathNative;
   llvm::sys::path::native(HSOpts.ModuleCachePath, ModuleCachePathNative);
@@ -1189,17 +1267,24 @@ static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
 
       // If the file has been used recently enough, leave it there.
       time_t FileAccessTime = StatBuf.st_atime;
-      if (CurrentTime - FileAccessTime <=
+      if (!PruneUnused ||
+          CurrentTime - FileAccessTime <=
               time_t(HSOpts.ModuleCachePruneAfter)) {
+        if (HSOpts.ModuleCacheSizeLimit && Extension == ".pcm") {
+          PrunableModuleFile Kept = { File->path(), uint64_t(StatBuf.st_size),
+                                      FileAccessTime };
+          KeptModuleFiles.push_back(Kept);
+          KeptModuleFilesSize += StatBuf.st_size;
+        }
         continue;
       }
 
-      // Remove the file.
-      llvm::sys::fs::remove(File->path());
-
-      // Remove the timestamp file.
-      std::string TimpestampFilename = File->path() + ".timestamp";
-      llvm::sys::fs::remove(TimpestampFilename);
+      // Remove the file, and if it is a module file, the files which refer
+      // to it.
+      if (Extension == ".pcm")
+        removeModuleFile(File->path());
+      else
+        llvm::sys::fs::remove(File->path());
     }
 
     // If we removed all of the files in the directory, remove the directory
@@ -1208,6 +1293,10 @@ static void pruneModuleCache(const HeaderSearchOptions &HSOpts) {
             llvm::sys::fs::directory_iterator() && !EC)
       llvm::sys::fs::remove(Dir->path());
   }
+
+  if (HSOpts.ModuleCacheSizeLimit)
+    pruneModuleCacheToSize(KeptModuleFiles, KeptModuleFilesSize,
+                           HSOpts.ModuleCacheSizeLimit);
 }
 
 void CompilerInstance::createModuleManager() {
@@ -1218,8 +1307,9 @@ void CompilerInstance::createModuleManager() {
     // If we're not recursively building a module, check whether we
     // need to prune the module cache.
     if (getSourceManager().getModuleBuildStack().empty() &&
-        getHeaderSearchOpts().ModuleCachePruneInterval > 0 &&
-        getHeaderSearchOpts().ModuleCachePruneAfter > 0) {
+        ((getHeaderSearchOpts().ModuleCachePruneInterval > 0 &&
+          getHeaderSearchOpts().ModuleCachePruneAfter > 0) ||
+         getHeaderSearchOpts().ModuleCacheSizeLimit > 0)) {
       pruneModuleCache(getHeaderSearchOpts());
     }
 
@@ -19,8 +19,11 @@
 #include "clang/Frontend/MultiplexConsumer.h"
 #include "clang/Frontend/Utils.h"
 #include "clang/Lex/HeaderSearch.h"
+#include "clang/Lex/PreprocessingRecord.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Parse/ParseAST.h"
+#include "clang/Sema/Sema.h"
+#include "clang/Sema/TemplateInstantiationProfiler.h"
 #include "clang/Serialization/ASTDeserializationListener.h"
 #include "clang/Serialization/ASTReader.h"
 #include "clang/Serialization/GlobalModuleIndex.h"
@@ -434,6 +437,62 @@ bool FrontendAction::Execute() {
   return true;
 }
 
+/// \brief Print the memory used by the main frontend data structures, one
+/// "category: bytes" line per category.
+static void printMemoryReport(CompilerInstance &CI, StringRef File) {
+  llvm::errs() << "\n*** Memory Report for '" << File << "':\n";
+  size_t Total = 0;
+  auto Report = [&Total](StringRef Category, size_t Bytes) {
+    llvm::errs() << "  " << Category << ": " << Bytes << "\n";
+    Total += Bytes;
+  };
+
+  if (CI.hasASTContext()) {
+    ASTContext &Ctx = CI.getASTContext();
+    size_t Decls = Ctx.getDeclAllocatedBytes();
+    size_t Types = Ctx.getTypeAllocatedBytes();
+    size_t Nodes = Ctx.getASTAllocatedBytes();
+    Report("ast.decls", Decls);
+    Report("ast.types", Types);
+    Report("ast.stmts-and-other",
+           Nodes > Decls + Types ? Nodes - Decls - Types : 0);
+    Report("ast.allocator-slack", Ctx.getASTAllocatedMemory() - Nodes);
+    Report("ast.side-tables", Ctx.getSideTableAllocatedMemory());
+    if (ExternalASTSource *Source = Ctx.getExternalSource()) {
+      ExternalASTSource::MemoryBufferSizes Sizes =
+          Source->getMemoryBufferSizes();
+      Report("external-ast-source.buffers.malloc", Sizes.malloc_bytes);
+      Report("external-ast-source.buffers.mmap", Sizes.mmap_bytes);
+    }
+  }
+
+  if (CI.hasSema())
+    Report("sema", CI.getSema().getTotalMemory());
+
+  if (CI.hasPreprocessor()) {
+    Preprocessor &PP = CI.getPreprocessor();
+    Report("preprocessor", PP.getTotalMemory());
+    Report("preprocessor.identifiers",
+           PP.getIdentifierTable().getAllocator().getTotalMemory());
+    Report("preprocessor.selectors", PP.getSelectorTable().getTotalMemory());
+    Report("preprocessor.header-search",
+           PP.getHeaderSearchInfo().getTotalMemory());
+    if (PreprocessingRecord *Record = PP.getPreprocessingRecord())
+      Report("preprocessor.preprocessing-record", Record->getTotalMemory());
+  }
+
+  if (CI.hasSourceManager()) {
+    SourceManager &SM = CI.getSourceManager();
+    SourceManager::MemoryBufferSizes Buffers = SM.getMemoryBufferSizes();
+    Report("source-manager.content-cache", SM.getContentCacheSize());
+    Report("source-manager.buffers.malloc", Buffers.malloc_bytes);
+    Report("source-manager.buffers.mmap", Buffers.mmap_bytes);
+    Report("source-manager.data-structures", SM.getDataStructureSizes());
+  }
+
+  llvm::errs() << "  total: " << Total << "\n";
+}
+
 void FrontendAction::EndSourceFile() {
   CompilerInstance &CI = getCompilerInstance();
 
@@ -447,6 +506,9 @@ void FrontendAction::EndSourceFile() {
   // Finalize the action.
   EndSourceFileAction();
 
+  if (CI.getFrontendOpts().ShowMemoryReport)
+    printMemoryReport(CI, getCurrentFile());
+
   // Sema references the ast consumer, so reset sema first.
   //
   // FIXME: There is more per-file stuff we could just drop here?
@@ -518,8 +580,19 @@ void ASTFrontendAction::ExecuteAction() {
   if (!CI.hasSema())
     CI.createSema(getTranslationUnitKind(), CompletionConsumer);
 
-  ParseAST(CI.getSema(), CI.getFrontendOpts().ShowStats,
-           CI.getFrontendOpts().SkipFunctionBodies);
+  Sema &S = CI.getSema();
+  if (CI.getFrontendOpts().ShowTemplateInstantiationProfile)
+    S.InstantiationProfiler.reset(
+        new sema::TemplateInstantiationProfiler(S.getASTContext()));
+
+  ParseAST(S, CI.getFrontendOpts().ShowStats,
+           CI.getFrontendOpts().SkipFunctionBodies,
+           CI.getFrontendOpts().LazyFunctionBodies);
+
+  if (S.InstantiationProfiler) {
+    S.InstantiationProfiler->printReport(llvm::errs());
+    S.InstantiationProfiler.reset();
+  }
 }
 
 void PluginASTAction::anchor() { }
@@ -0,0 +1,70 @@
+//===--- TimeTraceCallbacks.cpp - Trace the source files entered ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Frontend/Utils.h"
+#include "clang/Basic/SourceManager.h"
+#include "clang/Basic/TimeTrace.h"
+#include "clang/Lex/Preprocessor.h"
+using namespace clang;
+
+namespace {
+/// \brief Records the time spent in each source file entered by the
+/// preprocessor, headers included, in the current TimeTraceProfiler.
+class TimeTraceCallbacks : public PPCallbacks {
+  SourceManager &SM;
+
+  /// \brief The number of files this preprocessor entered and has not left.
+  ///
+  /// The preprocessor never leaves the main file, and the preprocessor of an
+  /// implicit module build shares the profiler of the importing compilation,
+  /// so the files still open are ended explicitly at the end of the main
+  /// file rather than left on the profiler's stack.
+  unsigned Depth;
+
+public:
+  explicit TimeTraceCallbacks(SourceManager &SM) : SM(SM), Depth(0) {}
+
+  void FileChanged(SourceLocation Loc, FileChangeReason Reason,
+                   SrcMgr::CharacteristicKind FileType,
+                   FileID PrevFID) override;
+
+  void EndOfMainFile() override;
+};
+}
+
+void clang::AttachTimeTraceCallbacks(Preprocessor &PP) {
+  PP.addPPCallbacks(new TimeTraceCallbacks(PP.getSourceManager()));
+}
+
+void TimeTraceCallbacks::FileChanged(SourceLocation Loc,
+                                     FileChangeReason Reason,
+                                     SrcMgr::CharacteristicKind FileType,
+                                     FileID PrevFID) {
+  TimeTraceProfiler *Profiler = TimeTraceProfiler::getCurrent();
+  if (!Profiler)
+    return;
+
+  // Line markers rename the current file: only the actual entries and exits
+  // are recorded, under the name of the buffer.
+  if (Reason == PPCallbacks::EnterFile) {
+    Profiler->enterFile(SM.getBufferName(Loc));
+    ++Depth;
+  } else if (Reason == PPCallbacks::ExitFile && Depth) {
+    Profiler->exitFile();
+    --Depth;
+  }
+}
+
+void TimeTraceCallbacks::EndOfMainFile() {
+  TimeTraceProfiler *Profiler = TimeTraceProfiler::getCurrent();
+  for (; Depth; --Depth) {
+    if (Profiler)
+      Profiler->exitFile();
+  }
+}
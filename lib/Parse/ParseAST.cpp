@@ -17,6 +17,7 @@
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/ExternalASTSource.h"
 #include "clang/AST/Stmt.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Parse/ParseDiagnostic.h"
 #include "clang/Parse/Parser.h"
 #include "clang/Sema/CodeCompleteConsumer.h"
@@ -97,7 +98,23 @@ void clang::ParseAST(Preprocessor &PP, ASTConsumer *Consumer,
   ParseAST(*S.get(), PrintStats, SkipFunctionBodies);
 }
 
-void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies) {
+/// \brief Parse the next top-level declaration, recording the time spent in
+/// the parser and in Sema for it.
+static bool parseTopLevelDecl(Parser &P, Parser::DeclGroupPtrTy &ADecl) {
+  TimeTraceScope Scope("ParseTopLevelDecl");
+  bool AtEOF = P.ParseTopLevelDecl(ADecl);
+  if (Scope.isEnabled() && ADecl) {
+    DeclGroupRef DG = ADecl.get();
+    if (const NamedDecl *ND = dyn_cast<NamedDecl>(*DG.begin()))
+      Scope.setDetail(ND->getQualifiedNameAsString());
+  }
+  return AtEOF;
+}
+
+void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies,
+                     bool LazyFunctionBodies) {
+  TimeTraceScope TimeScope("ParseAST");
+
   // Collect global stats on Decls/Stmts (until we have a module streamer).
   if (PrintStats) {
     Decl::EnableStatistics();
@@ -111,7 +128,8 @@ void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies) {
   ASTConsumer *Consumer = &S.getASTConsumer();
 
   std::unique_ptr<Parser> ParseOP(
-      new Parser(S.getPreprocessor(), S, SkipFunctionBodies));
+      new Parser(S.getPreprocessor(), S, SkipFunctionBodies,
+                 LazyFunctionBodies));
   Parser &P = *ParseOP.get();
 
   PrettyStackTraceParserEntry CrashInfo(P);
@@ -132,7 +150,7 @@ void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies) {
   if (External)
     External->StartTranslationUnit(Consumer);
 
-  if (P.ParseTopLevelDecl(ADecl)) {
+  if (parseTopLevelDecl(P, ADecl)) {
     if (!External && !S.getLangOpts().CPlusPlus)
       P.Diag(diag::ext_empty_translation_unit);
   } else {
@@ -142,7 +160,7 @@ void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies) {
       // skipping something.
       if (ADecl && !Consumer->HandleTopLevelDecl(ADecl.get()))
         return;
-    } while (!P.ParseTopLevelDecl(ADecl));
+    } while (!parseTopLevelDecl(P, ADecl));
   }
 
   // Process any TopLevelDecls generated by #pragma weak.
@@ -153,6 +171,15 @@ void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies) {
   
   Consumer->HandleTranslationUnit(S.getASTContext());
 
+  // The function bodies that were skipped in lazy-body mode and not parsed yet
+  // can still be asked for through FunctionDecl::getBody, so the parser must
+  // live as long as Sema does.
+  if (!S.LazyFunctionBodies.empty()) {
+    CleanupParser.unregister();
+    S.TakeLazyFunctionBodyParser(&Parser::DeleteLazyFunctionBodyParser);
+    ParseOP.release();
+  }
+
   std::swap(OldCollectStats, S.CollectStats);
   if (PrintStats) {
     llvm::errs() << "\nSTATISTICS:\n";
@@ -763,18 +763,30 @@ bool Parser::HandlePragmaLoopHint(LoopHint &Hint) {
                       .Case("vectorize", true)
                       .Case("interleave", true)
                       .Case("unroll", true)
+                      .Case("vectorize_predicate", true)
+                      .Case("distribute", true)
+                      .Case("unroll_and_jam", true)
+                      .Case("pipeline", true)
                       .Default(false);
 
   // Validate the argument.
   if (StateOption) {
-    bool OptionUnroll = OptionInfo->isStr("unroll");
+    // unroll is enabled with 'full', and pipelining can only be disabled.
+    enum { EnableKeyword, FullKeyword, DisableOnly } Keywords = EnableKeyword;
+    if (OptionInfo->isStr("unroll"))
+      Keywords = FullKeyword;
+    else if (OptionInfo->isStr("pipeline"))
+      Keywords = DisableOnly;
     SourceLocation StateLoc = Info->Value.getLocation();
     IdentifierInfo *StateInfo = Info->Value.getIdentifierInfo();
-    if (!StateInfo || ((OptionUnroll ? !StateInfo->isStr("full")
-                                     : !StateInfo->isStr("enable")) &&
-                       !StateInfo->isStr("disable"))) {
+    bool ValidState =
+        StateInfo &&
+        (StateInfo->isStr("disable") ||
+         (Keywords == EnableKeyword && StateInfo->isStr("enable")) ||
+         (Keywords == FullKeyword && StateInfo->isStr("full")));
+    if (!ValidState) {
       Diag(StateLoc, diag::err_pragma_invalid_keyword)
-          << /*MissingArgument=*/false << /*FullKeyword=*/OptionUnroll;
+          << /*MissingArgument=*/false << Keywords;
       return false;
     }
     Hint.StateLoc = IdentifierLoc::create(Actions.Context, StateLoc, StateInfo);
@@ -1851,6 +1863,12 @@ static bool ParseLoopHintValue(Preprocessor &PP, Token &Tok, Token PragmaName,
 ///    'vectorize_width' '(' loop-hint-value ')'
 ///    'interleave_count' '(' loop-hint-value ')'
 ///    'unroll_count' '(' loop-hint-value ')'
+///    'vectorize_predicate' '(' loop-hint-keyword ')'
+///    'distribute' '(' loop-hint-keyword ')'
+///    'unroll_and_jam' '(' loop-hint-keyword ')'
+///    'unroll_and_jam_count' '(' loop-hint-value ')'
+///    'pipeline' '(' 'disable' ')'
+///    'pipeline_initiation_interval' '(' loop-hint-value ')'
 ///
 ///  loop-hint-keyword:
 ///    'enable'
@@ -1878,6 +1896,16 @@ static bool ParseLoopHintValue(Preprocessor &PP, Token &Tok, Token PragmaName,
 /// unroll the loop completely, and unroll(disable) disables unrolling
 /// for the loop. Specifying unroll_count(_value_) instructs llvm to
 /// try to unroll the loop the number of times indicated by the value.
+///
+/// Specifying vectorize_predicate(enable) instructs llvm to vectorize the loop
+/// with predicated instructions instead of a scalar epilogue. Specifying
+/// distribute(enable) instructs llvm to try splitting the loop into multiple
+/// loops, so that some of them can be vectorized. Specifying
+/// unroll_and_jam(enable) or unroll_and_jam_count(_value_) instructs llvm to
+/// try unrolling the loop, which must contain inner loops, and fusing the
+/// copies of its inner loops. Specifying pipeline(disable) disables software
+/// pipelining of the loop, and pipeline_initiation_interval(_value_) requests
+/// the number of cycles between the starts of consecutive iterations.
 void PragmaLoopHintHandler::HandlePragma(Preprocessor &PP,
                                          PragmaIntroducerKind Introducer,
                                          Token &Tok) {
@@ -1904,6 +1932,12 @@ void PragmaLoopHintHandler::HandlePragma(Preprocessor &PP,
                            .Case("vectorize_width", true)
                            .Case("interleave_count", true)
                            .Case("unroll_count", true)
+                           .Case("vectorize_predicate", true)
+                           .Case("distribute", true)
+                           .Case("unroll_and_jam", true)
+                           .Case("unroll_and_jam_count", true)
+                           .Case("pipeline", true)
+                           .Case("pipeline_initiation_interval", true)
                            .Default(false);
     if (!OptionValid) {
       PP.Diag(Tok.getLocation(), diag::err_pragma_loop_invalid_option)
@@ -1842,6 +1842,15 @@ Decl *Parser::ParseFunctionStatementBody(Decl *Decl, ParseScope &BodyScope) {
   assert(Tok.is(tok::l_brace));
   SourceLocation LBraceLoc = Tok.getLocation();
 
+  if (LazyFunctionBodies && Actions.canParseFunctionBodyLazily(Decl)) {
+    CachedTokens Toks;
+    Toks.push_back(Tok);
+    ConsumeBrace();
+    ConsumeAndStoreUntil(tok::r_brace, Toks, /*StopAtSemi=*/false);
+    BodyScope.Exit();
+    return Actions.ActOnLazyFunctionBody(Decl, Toks);
+  }
+
   if (SkipFunctionBodies && (!Decl || Actions.canSkipFunctionBody(Decl)) &&
       trySkippingFunctionBody()) {
     BodyScope.Exit();
@@ -19,6 +19,7 @@
 #include "clang/Sema/DeclSpec.h"
 #include "clang/Sema/ParsedTemplate.h"
 #include "clang/Sema/Scope.h"
+#include "llvm/Support/SaveAndRestore.h"
 using namespace clang;
 
 /// \brief Parse a template declaration, explicit instantiation, or
@@ -1369,6 +1370,76 @@ void Parser::ParseLateTemplatedFuncDef(LateParsedTemplate &LPT) {
     delete *I;
 }
 
+void Parser::LazyFunctionBodyParserCallback(void *P,
+                                            LateParsedTemplate &LPT) {
+  ((Parser *)P)->ParseLazyFunctionBody(LPT);
+}
+
+void Parser::DeleteLazyFunctionBodyParser(void *P) {
+  delete (Parser *)P;
+}
+
+/// \brief Parse a function body that was skipped in lazy-body mode.
+void Parser::ParseLazyFunctionBody(LateParsedTemplate &LPT) {
+  FunctionDecl *FunD = LPT.D->getAsFunction();
+
+  // This body was asked for, so parse it even though we skip the others.
+  SaveAndRestore<bool> NoSkipping(SkipFunctionBodies, false);
+  SaveAndRestore<bool> NoLazyBodies(LazyFunctionBodies, false);
+
+  // To restore the context after parsing.
+  Sema::ContextRAII GlobalSavedContext(Actions, Actions.CurContext);
+
+  // ActOnEndOfTranslationUnit forgot the translation unit scope, which is
+  // still the current scope here; builtins and implicit declarations are
+  // added to it.
+  SaveAndRestore<Scope *> SavedTUScope(Actions.TUScope);
+  if (!Actions.TUScope)
+    Actions.TUScope = getCurScope();
+
+  // Reenter the lexical contexts of the function, from outermost to
+  // innermost, so that unqualified names in the body are found.
+  SmallVector<DeclContext *, 4> DeclContextsToReenter;
+  for (DeclContext *DC = FunD->getLexicalParent();
+       DC && !DC->isTranslationUnit(); DC = DC->getLexicalParent())
+    DeclContextsToReenter.push_back(DC);
+
+  SmallVector<ParseScope *, 4> ContextScopeStack;
+  for (SmallVectorImpl<DeclContext *>::reverse_iterator
+           I = DeclContextsToReenter.rbegin(),
+           E = DeclContextsToReenter.rend();
+       I != E; ++I) {
+    ContextScopeStack.push_back(new ParseScope(this, Scope::DeclScope));
+    Actions.PushDeclContext(Actions.getCurScope(), *I);
+  }
+
+  // Append the current token at the end of the new token stream so that it
+  // doesn't get lost.
+  LPT.Toks.push_back(Tok);
+  PP.EnterTokenStream(LPT.Toks.data(), LPT.Toks.size(), true, false);
+
+  // Consume the previously pushed token.
+  ConsumeAnyToken(/*ConsumeCodeCompletionTok=*/true);
+  assert(Tok.is(tok::l_brace) && "Lazy function body not starting with '{'");
+
+  ParseScope FnScope(this, Scope::FnScope|Scope::DeclScope);
+
+  // Recreate the containing function DeclContext.
+  Sema::ContextRAII FunctionSavedContext(Actions,
+                                         Actions.getContainingDC(FunD));
+
+  Actions.ActOnReenterLazyFunctionBody(getCurScope(), LPT.D);
+  ParseFunctionStatementBody(LPT.D, FnScope);
+
+  // Exit scopes.
+  FnScope.Exit();
+  for (SmallVectorImpl<ParseScope *>::reverse_iterator
+           I = ContextScopeStack.rbegin(),
+           E = ContextScopeStack.rend();
+       I != E; ++I)
+    delete *I;
+}
+
 /// \brief Lex a delayed template function for late parsing.
 void Parser::LexTemplateFunctionForLateParsing(CachedTokens &Toks) {
   tok::TokenKind kind = Tok.getKind();
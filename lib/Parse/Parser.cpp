@@ -48,12 +48,17 @@ IdentifierInfo *Parser::getSEHExceptKeyword() {
   return Ident__except;
 }
 
-Parser::Parser(Preprocessor &pp, Sema &actions, bool skipFunctionBodies)
+Parser::Parser(Preprocessor &pp, Sema &actions, bool skipFunctionBodies,
+               bool lazyFunctionBodies)
   : PP(pp), Actions(actions), Diags(PP.getDiagnostics()),
     GreaterThanIsOperator(true), ColonIsSacred(false), 
     InMessageExpression(false), TemplateParameterDepth(0),
     ParsingInObjCContainer(false) {
   SkipFunctionBodies = pp.isCodeCompletionEnabled() || skipFunctionBodies;
+  // In code-completion mode, bodies are skipped to get to the completion
+  // point quickly; nobody will ask for them later.
+  LazyFunctionBodies = skipFunctionBodies && lazyFunctionBodies &&
+                       !pp.isCodeCompletionEnabled();
   Tok.startToken();
   Tok.setKind(tok::eof);
   Actions.CurScope = nullptr;
@@ -414,6 +419,9 @@ Parser::~Parser() {
 
   PP.clearCodeCompletionHandler();
 
+  if (LazyFunctionBodies)
+    Actions.SetLazyFunctionBodyParser(nullptr, nullptr);
+
   assert(TemplateIds.empty() && "Still alive TemplateIdAnnotations around?");
 }
 
@@ -543,6 +551,9 @@ bool Parser::ParseTopLevelDecl(DeclGroupPtrTy &Result) {
     // Late template parsing can begin.
     if (getLangOpts().DelayedTemplateParsing)
       Actions.SetLateTemplateParser(LateTemplateParserCallback, this);
+    // So can parsing of lazily-skipped function bodies.
+    if (LazyFunctionBodies)
+      Actions.SetLazyFunctionBodyParser(LazyFunctionBodyParserCallback, this);
     if (!PP.isIncrementalProcessingEnabled())
       Actions.ActOnEndOfTranslationUnit();
     //else don't tell Sema that we ended parsing: more input might come.
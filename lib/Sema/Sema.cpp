@@ -25,6 +25,7 @@
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/PartialDiagnostic.h"
 #include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Lex/HeaderSearch.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Sema/CXXFieldCollector.h"
@@ -32,11 +33,13 @@
 #include "clang/Sema/ExternalSemaSource.h"
 #include "clang/Sema/MultiplexExternalSemaSource.h"
 #include "clang/Sema/ObjCMethodList.h"
+#include "clang/Sema/Overload.h"
 #include "clang/Sema/PrettyDeclStackTrace.h"
 #include "clang/Sema/Scope.h"
 #include "clang/Sema/ScopeInfo.h"
 #include "clang/Sema/SemaConsumer.h"
 #include "clang/Sema/TemplateDeduction.h"
+#include "clang/Sema/TemplateInstantiationProfiler.h"
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallSet.h"
@@ -88,7 +91,11 @@ Sema::Sema(Preprocessor &pp, ASTContext &ctxt, ASTConsumer &consumer,
     CodeSegStack(nullptr), CurInitSeg(nullptr), VisContext(nullptr),
     IsBuildingRecoveryCallExpr(false),
     ExprNeedsCleanups(false), LateTemplateParser(nullptr),
-    OpaqueParser(nullptr), IdResolver(pp), StdInitializerList(nullptr),
+    OpaqueParser(nullptr), LazyFunctionBodyParser(nullptr),
+    OpaqueLazyFunctionBodyParser(nullptr),
+    LazyFunctionBodyParserDeleter(nullptr),
+    DeferredUnusedDeclDiagnostics(false), IdResolver(pp),
+    StdInitializerList(nullptr),
     CXXTypeInfoDecl(nullptr), MSVCGuidDecl(nullptr),
     NSNumberDecl(nullptr),
     NSStringDecl(nullptr), StringWithUTF8StringMethod(nullptr),
@@ -120,6 +127,8 @@ Sema::Sema(Preprocessor &pp, ASTContext &ctxt, ASTConsumer &consumer,
   if (getLangOpts().CPlusPlus)
     FieldCollector.reset(new CXXFieldCollector());
 
+  OverloadCandidateAllocators.reset(new OverloadCandidateAllocatorPool());
+
   // Tell diagnostics how to render things from the AST library.
   PP.getDiagnostics().SetArgToStringFn(&FormatASTNodeDiagnosticArgument,
                                        &Context);
@@ -223,7 +232,12 @@ void Sema::Initialize() {
 }
 
 Sema::~Sema() {
+  // Destroy the parser that was kept to parse lazily-skipped function bodies
+  // first; it unregisters itself from this Sema.
+  if (LazyFunctionBodyParserDeleter)
+    LazyFunctionBodyParserDeleter(OpaqueLazyFunctionBodyParser);
   llvm::DeleteContainerSeconds(LateParsedTemplateMap);
+  llvm::DeleteContainerSeconds(LazyFunctionBodies);
   if (PackContext) FreePackedContext();
   if (VisContext) FreeVisContext();
   // Kill all the active scopes.
@@ -303,11 +317,17 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  OverloadCandidateAllocators->PrintStats();
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
 }
 
+size_t Sema::getTotalMemory() const {
+  return BumpAlloc.getTotalMemory() + TypoCorrectionNames.getTotalMemory() +
+         OverloadCandidateAllocators->getTotalMemory();
+}
+
 /// ImpCastExprToType - If Expr is not of type 'Type', insert an implicit cast.
 /// If there is already an implicit cast, merge into the existing one.
 /// The result is of the given category.
@@ -616,6 +636,7 @@ void Sema::emitAndClearUnusedLocalTypedefWarnings() {
 void Sema::ActOnEndOfTranslationUnit() {
   assert(DelayedDiagnostics.getCurrentPool() == nullptr
          && "reached end of translation unit with a pool attached?");
+  TimeTraceScope TimeScope("ActOnEndOfTranslationUnit");
 
   // If code completion is enabled, don't perform any end-of-translation-unit
   // work.
@@ -667,6 +688,13 @@ void Sema::ActOnEndOfTranslationUnit() {
     PerformPendingInstantiations();
 
     CheckDelayedMemberExceptionSpecs();
+  } else if (LangOpts.PCHInstantiateTemplates) {
+    // Instantiate what the prefix needs now, so that the instantiated
+    // definitions are serialized along with it instead of being redone by
+    // every translation unit that uses it. This moves the point of
+    // instantiation to the end of the prefix, so names declared after it are
+    // not found by these instantiations.
+    PerformPendingInstantiations();
   }
 
   // All delayed member exception specs should be checked or we end up accepting
@@ -786,6 +814,27 @@ void Sema::ActOnEndOfTranslationUnit() {
 
   }
 
+  // The bodies that were skipped in lazy-body mode can still use declarations
+  // that look unused now, so wait until they have all been parsed.
+  if (LazyFunctionBodies.empty())
+    DiagnoseUnusedDeclsAtEndOfTranslationUnit();
+  else
+    DeferredUnusedDeclDiagnostics = true;
+
+  // Check we've noticed that we're no longer parsing the initializer for every
+  // variable. If we miss cases, then at best we have a performance issue and
+  // at worst a rejects-valid bug.
+  assert(ParsingInitForAutoVars.empty() &&
+         "Didn't unmark var as having its initializer parsed");
+
+  TUScope = nullptr;
+}
+
+/// \brief Emit the end-of-translation-unit warnings about declarations that
+/// turned out to be unused, or used but never defined.
+void Sema::DiagnoseUnusedDeclsAtEndOfTranslationUnit() {
+  DeferredUnusedDeclDiagnostics = false;
+
   // If there were errors, disable 'unused' warnings since they will mostly be
   // noise.
   if (!Diags.hasErrorOccurred()) {
@@ -862,14 +911,6 @@ void Sema::ActOnEndOfTranslationUnit() {
       }
     }
   }
-
-  // Check we've noticed that we're no longer parsing the initializer for every
-  // variable. If we miss cases, then at best we have a performance issue and
-  // at worst a rejects-valid bug.
-  assert(ParsingInitForAutoVars.empty() &&
-         "Didn't unmark var as having its initializer parsed");
-
-  TUScope = nullptr;
 }
 
 
@@ -10252,6 +10252,109 @@ Decl *Sema::ActOnSkippedFunctionBody(Decl *Decl) {
   return ActOnFinishFunctionBody(Decl, nullptr);
 }
 
+bool Sema::canParseFunctionBodyLazily(Decl *D) {
+  // Only functions that are parsed exactly once can be parsed on demand:
+  // templates are instantiated from their bodies, and local functions need
+  // the enclosing function's scope.
+  FunctionDecl *FD = dyn_cast_or_null<FunctionDecl>(D);
+  return FD && !FD->isDependentContext() &&
+         !FD->getLexicalDeclContext()->isFunctionOrMethod() &&
+         canSkipFunctionBody(D);
+}
+
+namespace {
+/// \brief Parses the bodies that were skipped in lazy-body mode when
+/// FunctionDecl::getBody asks for them.
+class SemaLazyFunctionBodySource : public LazyFunctionBodySource {
+  Sema &S;
+
+public:
+  explicit SemaLazyFunctionBodySource(Sema &S) : S(S) {}
+
+  Stmt *ParseFunctionBody(FunctionDecl *FD) override {
+    S.ParseLazyFunctionBody(FD);
+    return FD->hasLazyBody() ? nullptr : FD->getBody();
+  }
+};
+}
+
+void Sema::SetLazyFunctionBodyParser(LateTemplateParserCB *LBP, void *P) {
+  LazyFunctionBodyParser = LBP;
+  OpaqueLazyFunctionBodyParser = P;
+  if (!LBP) {
+    LazyFunctionBodyParserDeleter = nullptr;
+    if (Context.getLazyFunctionBodySource() == LazyBodySource.get())
+      Context.setLazyFunctionBodySource(nullptr);
+    return;
+  }
+
+  if (!LazyBodySource)
+    LazyBodySource.reset(new SemaLazyFunctionBodySource(*this));
+  Context.setLazyFunctionBodySource(LazyBodySource.get());
+}
+
+Decl *Sema::ActOnLazyFunctionBody(Decl *D, CachedTokens &Toks) {
+  FunctionDecl *FD = cast<FunctionDecl>(D);
+  LateParsedTemplate *&LPT = LazyFunctionBodies[FD];
+  if (!LPT)
+    LPT = new LateParsedTemplate;
+  LPT->Toks.swap(Toks);
+  LPT->D = D;
+  D = ActOnFinishFunctionBody(D, nullptr);
+
+  // The function is a definition; getBody parses its body when asked.
+  FD->setHasLazyBody();
+  return D;
+}
+
+bool Sema::ParseLazyFunctionBody(FunctionDecl *FD) {
+  LateParsedTemplateMapT::iterator I = LazyFunctionBodies.find(FD);
+  if (I == LazyFunctionBodies.end() || !LazyFunctionBodyParser)
+    return false;
+
+  // Whatever happens, the body is not lazy anymore; this also keeps getBody
+  // from coming back here while the body is parsed.
+  std::unique_ptr<LateParsedTemplate> LPT(I->second);
+  LazyFunctionBodies.erase(I);
+  FD->setHasLazyBody(false);
+  LazyFunctionBodyParser(OpaqueLazyFunctionBodyParser, *LPT);
+
+  // The end of the translation unit has been reached, so do for the new body
+  // what was done there for the others: define the vtables and instantiate
+  // the templates it uses.
+  if (TUKind != TU_Prefix) {
+    DefineUsedVTables();
+    PerformPendingInstantiations();
+  } else if (LangOpts.PCHInstantiateTemplates) {
+    PerformPendingInstantiations();
+  }
+
+  // Once no body is left, nothing can use the declarations that look unused.
+  if (LazyFunctionBodies.empty() && DeferredUnusedDeclDiagnostics)
+    DiagnoseUnusedDeclsAtEndOfTranslationUnit();
+  return true;
+}
+
+Decl *Sema::ActOnReenterLazyFunctionBody(Scope *FnBodyScope, Decl *D) {
+  FunctionDecl *FD = cast<FunctionDecl>(D);
+  PushFunctionScope();
+  PushDeclContext(FnBodyScope, FD);
+
+  // The parameters and the tags of the prototype already belong to the
+  // function; only make them visible again.
+  for (auto Param : FD->params())
+    if (Param->getIdentifier())
+      PushOnScopeChains(Param, FnBodyScope, /*AddToContext=*/false);
+  for (NamedDecl *PD : FD->getDeclsInPrototypeScope()) {
+    if (!PD->getName().empty())
+      PushOnScopeChains(PD, FnBodyScope, /*AddToContext=*/false);
+    if (auto *ED = dyn_cast<EnumDecl>(PD))
+      for (auto *EI : ED->enumerators())
+        PushOnScopeChains(EI, FnBodyScope, /*AddToContext=*/false);
+  }
+  return D;
+}
+
 Decl *Sema::ActOnFinishFunctionBody(Decl *D, Stmt *BodyArg) {
   return ActOnFinishFunctionBody(D, BodyArg, false);
 }
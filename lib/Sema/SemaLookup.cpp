@@ -40,6 +40,7 @@
 #include "llvm/ADT/TinyPtrVector.h"
 #include "llvm/ADT/edit_distance.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/TimeValue.h"
 #include <algorithm>
 #include <iterator>
 #include <limits>
@@ -2457,7 +2458,8 @@ Sema::SpecialMemberOverloadResult *Sema::LookupSpecialMember(CXXRecordDecl *RD,
   // Now we perform lookup on the name we computed earlier and do overload
   // resolution. Lookup is only performed directly into the class since there
   // will always be a (possibly implicit) declaration to shadow any others.
-  OverloadCandidateSet OCS(RD->getLocation(), OverloadCandidateSet::CSK_Normal);
+  OverloadCandidateSet OCS(*this, RD->getLocation(),
+                           OverloadCandidateSet::CSK_Normal);
   DeclContext::lookup_result R = RD->lookup(Name);
   assert(!R.empty() &&
          "lookup for a constructor or assignment operator was empty");
@@ -4214,6 +4216,17 @@ TypoCorrection Sema::CorrectTypo(const DeclarationNameInfo &TypoName,
   TypoCorrectionConsumer Consumer(*this, TypoName, LookupKind, S, SS, CCC,
                                   MemberContext, EnteringContext);
 
+  // Stop gathering candidates once the time budget, if any, is exhausted.
+  // The candidate budget is a deterministic equivalent used by tests.
+  unsigned TimeBudget = getLangOpts().SpellCheckingTimeBudget;
+  unsigned CandidateBudget = getLangOpts().SpellCheckingCandidateBudget;
+  llvm::sys::TimeValue Deadline;
+  if (TimeBudget) {
+    Deadline.msec(TimeBudget);
+    Deadline += llvm::sys::TimeValue::now();
+  }
+  bool BudgetExhausted = false;
+
   // If a callback object considers an empty typo correction candidate to be
   // viable, assume it does not do any actual validation of the candidates.
   TypoCorrection EmptyCorrection;
@@ -4289,23 +4302,35 @@ TypoCorrection Sema::CorrectTypo(const DeclarationNameInfo &TypoName,
 
   if (IsUnqualifiedLookup || SearchNamespaces) {
     // For unqualified lookup, look through all of the names that we have
-    // seen in this translation unit.
-    // FIXME: Re-add the ability to skip very unlikely potential corrections.
-    for (const auto &I : Context.Idents)
-      Consumer.FoundName(I.getKey());
-
-    // Walk through identifiers in external identifier sources.
-    // FIXME: Re-add the ability to skip very unlikely potential corrections.
-    if (IdentifierInfoLookup *External
-                            = Context.Idents.getExternalIdentifierLookup()) {
-      std::unique_ptr<IdentifierIterator> Iter(External->getIdentifiers());
-      do {
-        StringRef Name = Iter->Next();
-        if (Name.empty())
+    // seen in this translation unit and in external identifier sources.
+    // Names whose length differs from the typo's by more than a third can
+    // never be accepted, so only look at the lengths in between.
+    ExternalASTSource *Source = Context.getExternalSource();
+    TypoCorrectionNames.update(Context.Idents,
+                               Source ? Source->getGeneration() : 0);
+    unsigned MaxLengthDifference = TypoLen / 3;
+    unsigned NumNamesSeen = 0;
+    SmallVector<ArrayRef<StringRef>, 2> Names;
+    for (unsigned Length = TypoLen - MaxLengthDifference,
+                  LastLength = TypoLen + MaxLengthDifference;
+         Length <= LastLength && !BudgetExhausted; ++Length) {
+      Names.clear();
+      TypoCorrectionNames.getNames(Length, Names);
+      for (ArrayRef<StringRef> Bucket : Names) {
+        for (StringRef Name : Bucket) {
+          Consumer.FoundName(Name);
+
+          // Checking the clock is not free; only do so every so often.
+          if (++NumNamesSeen == CandidateBudget ||
+              (TimeBudget && NumNamesSeen % 256 == 0 &&
+               llvm::sys::TimeValue::now() > Deadline)) {
+            BudgetExhausted = true;
+            break;
+          }
+        }
+        if (BudgetExhausted)
           break;
-
-        Consumer.FoundName(Name);
-      } while (true);
+      }
     }
   }
 
@@ -4324,8 +4349,8 @@ TypoCorrection Sema::CorrectTypo(const DeclarationNameInfo &TypoName,
                             IsUnqualifiedLookup);
 
   // Build the NestedNameSpecifiers for the KnownNamespaces, if we're going
-  // to search those namespaces.
-  if (SearchNamespaces) {
+  // to search those namespaces and there is time left to do so.
+  if (SearchNamespaces && !BudgetExhausted) {
     // Load any externally-known namespaces.
     if (ExternalSource && !LoadedExternalKnownNamespaces) {
       SmallVector<NamespaceDecl *, 4> ExternalKnownNamespaces;
@@ -4407,6 +4432,65 @@ TypoCorrection Sema::CorrectTypo(const DeclarationNameInfo &TypoName,
                           IsUnqualifiedLookup && !ValidatingCallback);
 }
 
+void TypoCorrectionNameIndex::addName(NameBuckets &Buckets, StringRef Name) {
+  if (Buckets.size() <= Name.size())
+    Buckets.resize(Name.size() + 1);
+  Buckets[Name.size()].push_back(Name);
+}
+
+void TypoCorrectionNameIndex::update(IdentifierTable &Idents,
+                                     uint32_t Generation) {
+  // Identifiers are never removed from the table, so the local names are up
+  // to date as long as its size did not change. The table cannot enumerate
+  // its identifiers in creation order, so when it grew, it is walked again;
+  // the buckets keep their storage, so this does not allocate once they are
+  // large enough.
+  if (Idents.size() != NumLocalIdentifiers) {
+    for (unsigned I = 0, N = LocalNames.size(); I != N; ++I)
+      LocalNames[I].clear();
+    for (const auto &I : Idents)
+      addName(LocalNames, I.getKey());
+    NumLocalIdentifiers = Idents.size();
+  }
+
+  IdentifierInfoLookup *External = Idents.getExternalIdentifierLookup();
+  if (!External || (HasExternalNames && Generation == ExternalGeneration))
+    return;
+
+  ExternalNames.clear();
+  ExternalNameStorage.Reset();
+  std::unique_ptr<IdentifierIterator> Iter(External->getIdentifiers());
+  do {
+    StringRef Name = Iter->Next();
+    if (Name.empty())
+      break;
+
+    char *Storage = ExternalNameStorage.Allocate<char>(Name.size());
+    std::copy(Name.begin(), Name.end(), Storage);
+    addName(ExternalNames, StringRef(Storage, Name.size()));
+  } while (true);
+
+  HasExternalNames = true;
+  ExternalGeneration = Generation;
+}
+
+void TypoCorrectionNameIndex::getNames(
+    unsigned Length, SmallVectorImpl<ArrayRef<StringRef> > &Names) const {
+  if (Length < LocalNames.size())
+    Names.push_back(LocalNames[Length]);
+  if (Length < ExternalNames.size())
+    Names.push_back(ExternalNames[Length]);
+}
+
+size_t TypoCorrectionNameIndex::getTotalMemory() const {
+  size_t Bytes = ExternalNameStorage.getTotalMemory();
+  for (unsigned I = 0, N = LocalNames.size(); I != N; ++I)
+    Bytes += LocalNames[I].capacity() * sizeof(StringRef);
+  for (unsigned I = 0, N = ExternalNames.size(); I != N; ++I)
+    Bytes += ExternalNames[I].capacity() * sizeof(StringRef);
+  return Bytes;
+}
+
 void TypoCorrection::addCorrectionDecl(NamedDecl *CDecl) {
   if (!CDecl) return;
 
@@ -792,13 +792,53 @@ void OverloadCandidateSet::destroyCandidates() {
   }
 }
 
+OverloadCandidateSet::OverloadCandidateSet(Sema &S, SourceLocation Loc,
+                                           CandidateSetKind CSK)
+    : AllocatorPool(S.OverloadCandidateAllocators.get()),
+      ConversionSequenceAllocator(nullptr), Loc(Loc), Kind(CSK),
+      NumInlineSequences(0) {}
+
 void OverloadCandidateSet::clear() {
   destroyCandidates();
+  if (ConversionSequenceAllocator) {
+    AllocatorPool->giveBack(ConversionSequenceAllocator);
+    ConversionSequenceAllocator = nullptr;
+  }
   NumInlineSequences = 0;
   Candidates.clear();
   Functions.clear();
 }
 
+OverloadCandidateAllocatorPool::~OverloadCandidateAllocatorPool() {
+  assert(FreeAllocators.size() == NumAllocatorsCreated &&
+         "candidate set outlived the allocator pool");
+  llvm::DeleteContainerPointers(FreeAllocators);
+}
+
+llvm::BumpPtrAllocator *OverloadCandidateAllocatorPool::borrow() {
+  ++NumAllocatorsBorrowed;
+  if (FreeAllocators.empty()) {
+    ++NumAllocatorsCreated;
+    return new llvm::BumpPtrAllocator();
+  }
+  return FreeAllocators.pop_back_val();
+}
+
+size_t OverloadCandidateAllocatorPool::getTotalMemory() const {
+  size_t Bytes = 0;
+  for (unsigned I = 0, N = FreeAllocators.size(); I != N; ++I)
+    Bytes += FreeAllocators[I]->getTotalMemory();
+  return Bytes;
+}
+
+void OverloadCandidateAllocatorPool::PrintStats() const {
+  llvm::errs() << NumResolutions << " overload resolutions considered "
+               << NumCandidates << " candidates.\n";
+  llvm::errs() << NumAllocatorsBorrowed
+               << " candidate sets needed out-of-line conversion storage, "
+               << "served by " << NumAllocatorsCreated << " allocators.\n";
+}
+
 namespace {
   class UnbridgedCastsSet {
     struct Entry {
@@ -1129,7 +1169,7 @@ TryUserDefinedConversion(Sema &S, Expr *From, QualType ToType,
   }
 
   // Attempt user-defined conversion.
-  OverloadCandidateSet Conversions(From->getExprLoc(),
+  OverloadCandidateSet Conversions(S, From->getExprLoc(),
                                    OverloadCandidateSet::CSK_Normal);
   OverloadingResult UserDefResult
     = IsUserDefinedConversion(S, From, ToType, ICS.UserDefined, Conversions,
@@ -3237,7 +3277,7 @@ IsUserDefinedConversion(Sema &S, Expr *From, QualType ToType,
 bool
 Sema::DiagnoseMultipleUserDefinedConversion(Expr *From, QualType ToType) {
   ImplicitConversionSequence ICS;
-  OverloadCandidateSet CandidateSet(From->getExprLoc(),
+  OverloadCandidateSet CandidateSet(*this, From->getExprLoc(),
                                     OverloadCandidateSet::CSK_Normal);
   OverloadingResult OvResult =
     IsUserDefinedConversion(*this, From, ToType, ICS.UserDefined,
@@ -4066,7 +4106,8 @@ FindConversionForRefInit(Sema &S, ImplicitConversionSequence &ICS,
   CXXRecordDecl *T2RecordDecl
     = dyn_cast<CXXRecordDecl>(T2->getAs<RecordType>()->getDecl());
 
-  OverloadCandidateSet CandidateSet(DeclLoc, OverloadCandidateSet::CSK_Normal);
+  OverloadCandidateSet CandidateSet(S, DeclLoc,
+                                    OverloadCandidateSet::CSK_Normal);
   std::pair<CXXRecordDecl::conversion_iterator,
             CXXRecordDecl::conversion_iterator>
     Conversions = T2RecordDecl->getVisibleConversionFunctions();
@@ -5424,7 +5465,8 @@ ExprResult Sema::PerformContextualImplicitConversion(
     // If one unique T is found:
     // First, build a candidate set from the previously recorded
     // potentially viable conversions.
-    OverloadCandidateSet CandidateSet(Loc, OverloadCandidateSet::CSK_Normal);
+    OverloadCandidateSet CandidateSet(*this, Loc,
+                                      OverloadCandidateSet::CSK_Normal);
     collectViableConversionCandidates(*this, From, ToType, ViableConversions,
                                       CandidateSet);
 
@@ -8439,6 +8481,8 @@ OverloadingResult
 OverloadCandidateSet::BestViableFunction(Sema &S, SourceLocation Loc,
                                          iterator &Best,
                                          bool UserDefinedConversion) {
+  S.OverloadCandidateAllocators->noteResolution(size());
+
   // Find the best viable function.
   Best = end();
   for (iterator Cand = begin(); Cand != end(); ++Cand) {
@@ -10404,7 +10448,7 @@ DiagnoseTwoPhaseLookup(Sema &SemaRef, SourceLocation FnLoc,
         return false;
       }
 
-      OverloadCandidateSet Candidates(FnLoc, CSK);
+      OverloadCandidateSet Candidates(SemaRef, FnLoc, CSK);
       for (LookupResult::iterator I = R.begin(), E = R.end(); I != E; ++I)
         AddOverloadedCallCandidate(SemaRef, I.getPair(),
                                    ExplicitTemplateArgs, Args,
@@ -10728,7 +10772,7 @@ ExprResult Sema::BuildOverloadedCallExpr(Scope *S, Expr *Fn,
                                          SourceLocation RParenLoc,
                                          Expr *ExecConfig,
                                          bool AllowTypoCorrection) {
-  OverloadCandidateSet CandidateSet(Fn->getExprLoc(),
+  OverloadCandidateSet CandidateSet(*this, Fn->getExprLoc(),
                                     OverloadCandidateSet::CSK_Normal);
   ExprResult result;
 
@@ -10814,7 +10858,8 @@ Sema::CreateOverloadedUnaryOp(SourceLocation OpLoc, unsigned OpcIn,
   }
 
   // Build an empty overload set.
-  OverloadCandidateSet CandidateSet(OpLoc, OverloadCandidateSet::CSK_Operator);
+  OverloadCandidateSet CandidateSet(*this, OpLoc,
+                                    OverloadCandidateSet::CSK_Operator);
 
   // Add the candidates from the given function set.
   AddFunctionCandidates(Fns, ArgsArray, CandidateSet, false);
@@ -11023,7 +11068,8 @@ Sema::CreateOverloadedBinOp(SourceLocation OpLoc,
     return CreateBuiltinBinOp(OpLoc, Opc, Args[0], Args[1]);
 
   // Build an empty overload set.
-  OverloadCandidateSet CandidateSet(OpLoc, OverloadCandidateSet::CSK_Operator);
+  OverloadCandidateSet CandidateSet(*this, OpLoc,
+                                    OverloadCandidateSet::CSK_Operator);
 
   // Add the candidates from the given function set.
   AddFunctionCandidates(Fns, Args, CandidateSet, false);
@@ -11256,7 +11302,8 @@ Sema::CreateOverloadedArraySubscriptExpr(SourceLocation LLoc,
     return ExprError();
 
   // Build an empty overload set.
-  OverloadCandidateSet CandidateSet(LLoc, OverloadCandidateSet::CSK_Operator);
+  OverloadCandidateSet CandidateSet(*this, LLoc,
+                                    OverloadCandidateSet::CSK_Operator);
 
   // Subscript can only be overloaded as a member function.
 
@@ -11483,7 +11530,7 @@ Sema::BuildCallToMemberFunction(Scope *S, Expr *MemExprE,
                             : UnresExpr->getBase()->Classify(Context);
 
     // Add overload candidates
-    OverloadCandidateSet CandidateSet(UnresExpr->getMemberLoc(),
+    OverloadCandidateSet CandidateSet(*this, UnresExpr->getMemberLoc(),
                                       OverloadCandidateSet::CSK_Normal);
 
     // FIXME: avoid copy.
@@ -11668,7 +11715,7 @@ Sema::BuildCallToObjectOfClassType(Scope *S, Expr *Obj,
   //  operators of T. The function call operators of T are obtained by
   //  ordinary lookup of the name operator() in the context of
   //  (E).operator().
-  OverloadCandidateSet CandidateSet(LParenLoc,
+  OverloadCandidateSet CandidateSet(*this, LParenLoc,
                                     OverloadCandidateSet::CSK_Operator);
   DeclarationName OpName = Context.DeclarationNames.getCXXOperatorName(OO_Call);
 
@@ -11950,7 +11997,8 @@ Sema::BuildOverloadedArrowExpr(Scope *S, Expr *Base, SourceLocation OpLoc,
   //   overload resolution mechanism (13.3).
   DeclarationName OpName =
     Context.DeclarationNames.getCXXOperatorName(OO_Arrow);
-  OverloadCandidateSet CandidateSet(Loc, OverloadCandidateSet::CSK_Operator);
+  OverloadCandidateSet CandidateSet(*this, Loc,
+                                    OverloadCandidateSet::CSK_Operator);
   const RecordType *BaseRecord = Base->getType()->getAs<RecordType>();
 
   if (RequireCompleteType(Loc, Base->getType(),
@@ -12052,7 +12100,7 @@ ExprResult Sema::BuildLiteralOperatorCall(LookupResult &R,
                                        TemplateArgumentListInfo *TemplateArgs) {
   SourceLocation UDSuffixLoc = SuffixInfo.getCXXLiteralOperatorNameLoc();
 
-  OverloadCandidateSet CandidateSet(UDSuffixLoc,
+  OverloadCandidateSet CandidateSet(*this, UDSuffixLoc,
                                     OverloadCandidateSet::CSK_Normal);
   AddFunctionCandidates(R.asUnresolvedSet(), Args, CandidateSet, true,
                         TemplateArgs);
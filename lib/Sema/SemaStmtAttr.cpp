@@ -84,6 +84,13 @@ static Attr *handleLoopHintAttr(Sema &S, Stmt *St, const AttributeList &A,
                  .Case("interleave_count", LoopHintAttr::InterleaveCount)
                  .Case("unroll", LoopHintAttr::Unroll)
                  .Case("unroll_count", LoopHintAttr::UnrollCount)
+                 .Case("vectorize_predicate", LoopHintAttr::VectorizePredicate)
+                 .Case("distribute", LoopHintAttr::Distribute)
+                 .Case("unroll_and_jam", LoopHintAttr::UnrollAndJam)
+                 .Case("unroll_and_jam_count", LoopHintAttr::UnrollAndJamCount)
+                 .Case("pipeline", LoopHintAttr::Pipeline)
+                 .Case("pipeline_initiation_interval",
+                       LoopHintAttr::PipelineInitiationInterval)
                  .Default(LoopHintAttr::Vectorize);
     Spelling = LoopHintAttr::Pragma_clang_loop;
   }
@@ -92,9 +99,7 @@ static Attr *handleLoopHintAttr(Sema &S, Stmt *St, const AttributeList &A,
   LoopHintAttr::LoopHintState State = LoopHintAttr::Default;
   if (PragmaNoUnroll) {
     State = LoopHintAttr::Disable;
-  } else if (Option == LoopHintAttr::VectorizeWidth ||
-             Option == LoopHintAttr::InterleaveCount ||
-             Option == LoopHintAttr::UnrollCount) {
+  } else if (LoopHintAttr::isNumericOption(Option)) {
     // FIXME: We should support template parameters for the loop hint value.
     // See bug report #19610.
     llvm::APSInt ValueAPS;
@@ -103,9 +108,7 @@ static Attr *handleLoopHintAttr(Sema &S, Stmt *St, const AttributeList &A,
       S.Diag(A.getLoc(), diag::err_pragma_loop_invalid_value);
       return nullptr;
     }
-  } else if (Option == LoopHintAttr::Vectorize ||
-             Option == LoopHintAttr::Interleave ||
-             Option == LoopHintAttr::Unroll) {
+  } else {
     // Default state is assumed if StateLoc is not specified, such as with
     // '#pragma unroll'.
     if (StateLoc && StateLoc->Ident) {
@@ -123,18 +126,23 @@ static Attr *handleLoopHintAttr(Sema &S, Stmt *St, const AttributeList &A,
 static void
 CheckForIncompatibleAttributes(Sema &S,
                                const SmallVectorImpl<const Attr *> &Attrs) {
-  // There are 3 categories of loop hints attributes: vectorize, interleave,
-  // and unroll. Each comes in two variants: a state form and a numeric form.
-  // The state form selectively defaults/enables/disables the transformation
-  // for the loop (for unroll, default indicates full unrolling rather than
-  // enabling the transformation).  The numeric form form provides an integer
-  // hint (for example, unroll count) to the transformer. The following array
-  // accumulates the hints encountered while iterating through the attributes
-  // to check for compatibility.
+  // There are 7 categories of loop hints attributes: vectorize, interleave,
+  // unroll, vectorize_predicate, distribute, unroll_and_jam and pipeline.
+  // Vectorize, interleave, unroll, unroll_and_jam and pipeline come in two
+  // variants: a state form and a numeric form. The state form selectively
+  // defaults/enables/disables the transformation for the loop (for unroll,
+  // default indicates full unrolling rather than enabling the
+  // transformation).  The numeric form form provides an integer hint (for
+  // example, unroll count) to the transformer. Vectorize_predicate and
+  // distribute only have the state form. The following array accumulates the
+  // hints encountered while iterating through the attributes to check for
+  // compatibility.
   struct {
     const LoopHintAttr *StateAttr;
     const LoopHintAttr *NumericAttr;
-  } HintAttrs[] = {{nullptr, nullptr}, {nullptr, nullptr}, {nullptr, nullptr}};
+  } HintAttrs[] = {{nullptr, nullptr}, {nullptr, nullptr}, {nullptr, nullptr},
+                   {nullptr, nullptr}, {nullptr, nullptr}, {nullptr, nullptr},
+                   {nullptr, nullptr}};
 
   for (const auto *I : Attrs) {
     const LoopHintAttr *LH = dyn_cast<LoopHintAttr>(I);
@@ -145,7 +153,15 @@ CheckForIncompatibleAttributes(Sema &S,
 
     int Option = LH->getOption();
     int Category;
-    enum { Vectorize, Interleave, Unroll };
+    enum {
+      Vectorize,
+      Interleave,
+      Unroll,
+      VectorizePredicate,
+      Distribute,
+      UnrollAndJam,
+      Pipeline
+    };
     switch (Option) {
     case LoopHintAttr::Vectorize:
     case LoopHintAttr::VectorizeWidth:
@@ -159,12 +175,25 @@ CheckForIncompatibleAttributes(Sema &S,
     case LoopHintAttr::UnrollCount:
       Category = Unroll;
       break;
+    case LoopHintAttr::VectorizePredicate:
+      Category = VectorizePredicate;
+      break;
+    case LoopHintAttr::Distribute:
+      Category = Distribute;
+      break;
+    case LoopHintAttr::UnrollAndJam:
+    case LoopHintAttr::UnrollAndJamCount:
+      Category = UnrollAndJam;
+      break;
+    case LoopHintAttr::Pipeline:
+    case LoopHintAttr::PipelineInitiationInterval:
+      Category = Pipeline;
+      break;
     };
 
     auto &CategoryState = HintAttrs[Category];
     const LoopHintAttr *PrevAttr;
-    if (Option == LoopHintAttr::Vectorize ||
-        Option == LoopHintAttr::Interleave || Option == LoopHintAttr::Unroll) {
+    if (!LoopHintAttr::isNumericOption(Option)) {
       // Enable|disable hint.  For example, vectorize(enable).
       PrevAttr = CategoryState.StateAttr;
       CategoryState.StateAttr = LH;
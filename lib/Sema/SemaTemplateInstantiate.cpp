@@ -18,11 +18,13 @@
 #include "clang/AST/DeclTemplate.h"
 #include "clang/AST/Expr.h"
 #include "clang/Basic/LangOptions.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Sema/DeclSpec.h"
 #include "clang/Sema/Initialization.h"
 #include "clang/Sema/Lookup.h"
 #include "clang/Sema/Template.h"
 #include "clang/Sema/TemplateDeduction.h"
+#include "clang/Sema/TemplateInstantiationProfiler.h"
 
 using namespace clang;
 using namespace sema;
@@ -222,6 +224,19 @@ void Sema::InstantiatingTemplate::Initialize(
     SemaRef.ActiveTemplateInstantiations.push_back(Inst);
     if (!Inst.isInstantiationRecord())
       ++SemaRef.NonInstantiationEntries;
+    if (SemaRef.InstantiationProfiler &&
+        Kind == ActiveTemplateInstantiation::TemplateInstantiation)
+      SemaRef.InstantiationProfiler->startInstantiation(Entity);
+    if (Kind == ActiveTemplateInstantiation::TemplateInstantiation)
+      if (TimeTraceProfiler *Profiler = TimeTraceProfiler::getCurrent()) {
+        std::string Name;
+        if (NamedDecl *ND = dyn_cast_or_null<NamedDecl>(Entity)) {
+          llvm::raw_string_ostream OS(Name);
+          ND->getNameForDiagnostic(OS, SemaRef.getPrintingPolicy(),
+                                   /*Qualified=*/true);
+        }
+        Profiler->begin("InstantiateTemplate", Name);
+      }
   }
 }
 
@@ -350,6 +365,14 @@ void Sema::InstantiatingTemplate::Clear() {
       assert(SemaRef.NonInstantiationEntries > 0);
       --SemaRef.NonInstantiationEntries;
     }
+    if (SemaRef.InstantiationProfiler &&
+        SemaRef.ActiveTemplateInstantiations.back().Kind ==
+            ActiveTemplateInstantiation::TemplateInstantiation)
+      SemaRef.InstantiationProfiler->finishInstantiation();
+    if (TimeTraceProfiler *Profiler = TimeTraceProfiler::getCurrent())
+      if (SemaRef.ActiveTemplateInstantiations.back().Kind ==
+          ActiveTemplateInstantiation::TemplateInstantiation)
+        Profiler->end();
     SemaRef.InNonInstantiationSFINAEContext
       = SavedInNonInstantiationSFINAEContext;
 
@@ -0,0 +1,162 @@
+//===--- TemplateInstantiationProfiler.cpp - Instantiation costs ----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the TemplateInstantiationProfiler, which attributes
+// the cost of template instantiation to the instantiated entities.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Sema/TemplateInstantiationProfiler.h"
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclTemplate.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+
+using namespace clang;
+using namespace sema;
+
+void TemplateInstantiationProfiler::startInstantiation(const Decl *Entity) {
+  ++NumInstantiations;
+
+  ActiveInstantiation Inst;
+  Inst.Entity = Entity;
+  Inst.Start = llvm::sys::TimeValue::now();
+  Inst.NestedSeconds = 0.0;
+  Inst.StartBytes = Context.getASTAllocatedBytes();
+  Inst.NestedBytes = 0;
+  Inst.StartInstantiations = NumInstantiations;
+  Stack.push_back(Inst);
+}
+
+void TemplateInstantiationProfiler::finishInstantiation() {
+  assert(!Stack.empty() && "No instantiation in progress");
+  ActiveInstantiation Inst = Stack.pop_back_val();
+
+  double Seconds = (llvm::sys::TimeValue::now() - Inst.Start).usec() / 1e6;
+  uint64_t Bytes = Context.getASTAllocatedBytes() - Inst.StartBytes;
+
+  Cost &C = Costs[Inst.Entity];
+  ++C.Instantiations;
+  C.NestedInstantiations += NumInstantiations - Inst.StartInstantiations;
+  C.Seconds += Seconds;
+  C.SelfSeconds += Seconds - Inst.NestedSeconds;
+  C.Bytes += Bytes;
+  C.SelfBytes += Bytes - Inst.NestedBytes;
+
+  if (!Stack.empty()) {
+    Stack.back().NestedSeconds += Seconds;
+    Stack.back().NestedBytes += Bytes;
+  }
+}
+
+/// \brief Retrieve the declaration that \p D was instantiated from, so that
+/// all specializations of a template are charged to the same entry.
+static const Decl *getInstantiationPattern(const Decl *D) {
+  if (const auto *Spec = dyn_cast<ClassTemplateSpecializationDecl>(D))
+    return Spec->getSpecializedTemplate();
+  if (const auto *Spec = dyn_cast<VarTemplateSpecializationDecl>(D))
+    return Spec->getSpecializedTemplate();
+  if (const auto *Record = dyn_cast<CXXRecordDecl>(D)) {
+    if (const CXXRecordDecl *Pattern = Record->getInstantiatedFromMemberClass())
+      return Pattern;
+  } else if (const auto *Function = dyn_cast<FunctionDecl>(D)) {
+    if (const FunctionTemplateDecl *Template = Function->getPrimaryTemplate())
+      return Template;
+    if (const FunctionDecl *Pattern =
+            Function->getInstantiatedFromMemberFunction())
+      return Pattern;
+  } else if (const auto *Var = dyn_cast<VarDecl>(D)) {
+    if (const VarDecl *Pattern = Var->getInstantiatedFromStaticDataMember())
+      return Pattern;
+  } else if (const auto *Enum = dyn_cast<EnumDecl>(D)) {
+    if (const EnumDecl *Pattern = Enum->getInstantiatedFromMemberEnum())
+      return Pattern;
+  }
+  return D;
+}
+
+static void printEntityName(raw_ostream &OS, const Decl *D,
+                            const PrintingPolicy &Policy) {
+  if (const auto *ND = dyn_cast<NamedDecl>(D))
+    ND->getNameForDiagnostic(OS, Policy, /*Qualified=*/true);
+  else
+    OS << "<unnamed " << D->getDeclKindName() << ">";
+}
+
+void TemplateInstantiationProfiler::printReport(raw_ostream &OS,
+                                                unsigned MaxEntries) const {
+  typedef std::pair<const Decl *, Cost> Entry;
+  const PrintingPolicy &Policy = Context.getPrintingPolicy();
+
+  OS << "\n*** Template Instantiation Profile:\n";
+  OS << NumInstantiations << " template instantiations of " << Costs.size()
+     << " entities.\n";
+
+  SmallVector<Entry, 64> Entities(Costs.begin(), Costs.end());
+  std::sort(Entities.begin(), Entities.end(),
+            [](const Entry &X, const Entry &Y) {
+    return X.second.Seconds > Y.second.Seconds;
+  });
+
+  OS << "\nMost expensive instantiations:\n";
+  OS << "   Total(s)    Self(s)  Count  Nested   AST bytes  Entity\n";
+  for (unsigned I = 0, N = Entities.size(); I != N; ++I) {
+    if (MaxEntries && I == MaxEntries)
+      break;
+    const Cost &C = Entities[I].second;
+    OS << llvm::format("%11.4f%11.4f%7u%8u%12llu  ", C.Seconds,
+                       C.SelfSeconds, C.Instantiations, C.NestedInstantiations,
+                       (unsigned long long)C.Bytes);
+    printEntityName(OS, Entities[I].first, Policy);
+    OS << "\n";
+  }
+
+  // Aggregate the self costs over the template each entity was instantiated
+  // from. Inclusive costs would count recursive instantiations of the same
+  // template more than once.
+  struct PatternCost {
+    PatternCost()
+      : Entities(0), Instantiations(0), SelfSeconds(0.0), SelfBytes(0) {}
+    unsigned Entities;
+    unsigned Instantiations;
+    double SelfSeconds;
+    uint64_t SelfBytes;
+  };
+  typedef std::pair<const Decl *, PatternCost> PatternEntry;
+
+  llvm::DenseMap<const Decl *, PatternCost> PatternCosts;
+  for (const Entry &E : Entities) {
+    PatternCost &C = PatternCosts[getInstantiationPattern(E.first)];
+    ++C.Entities;
+    C.Instantiations += E.second.Instantiations;
+    C.SelfSeconds += E.second.SelfSeconds;
+    C.SelfBytes += E.second.SelfBytes;
+  }
+
+  SmallVector<PatternEntry, 64> Patterns(PatternCosts.begin(),
+                                         PatternCosts.end());
+  std::sort(Patterns.begin(), Patterns.end(),
+            [](const PatternEntry &X, const PatternEntry &Y) {
+    return X.second.SelfSeconds > Y.second.SelfSeconds;
+  });
+
+  OS << "\nMost expensive templates:\n";
+  OS << "    Self(s)  Count  Entities   AST bytes  Template\n";
+  for (unsigned I = 0, N = Patterns.size(); I != N; ++I) {
+    if (MaxEntries && I == MaxEntries)
+      break;
+    const PatternCost &C = Patterns[I].second;
+    OS << llvm::format("%11.4f%7u%10u%12llu  ", C.SelfSeconds,
+                       C.Instantiations, C.Entities,
+                       (unsigned long long)C.SelfBytes);
+    printEntityName(OS, Patterns[I].first, Policy);
+    OS << "\n";
+  }
+}
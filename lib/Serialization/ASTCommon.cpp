@@ -89,6 +89,36 @@ unsigned serialization::ComputeHash(Selector Sel) {
   return R;
 }
 
+unsigned serialization::ComputeHash(DeclarationName Name) {
+  // This must agree with ASTDeclContextNameLookupTrait::ComputeHash.
+  llvm::FoldingSetNodeID ID;
+  ID.AddInteger(Name.getNameKind());
+
+  switch (Name.getNameKind()) {
+  case DeclarationName::Identifier:
+    ID.AddString(Name.getAsIdentifierInfo()->getName());
+    break;
+  case DeclarationName::CXXLiteralOperatorName:
+    ID.AddString(Name.getCXXLiteralIdentifier()->getName());
+    break;
+  case DeclarationName::ObjCZeroArgSelector:
+  case DeclarationName::ObjCOneArgSelector:
+  case DeclarationName::ObjCMultiArgSelector:
+    ID.AddInteger(ComputeHash(Name.getObjCSelector()));
+    break;
+  case DeclarationName::CXXOperatorName:
+    ID.AddInteger(Name.getCXXOverloadedOperator());
+    break;
+  case DeclarationName::CXXConstructorName:
+  case DeclarationName::CXXDestructorName:
+  case DeclarationName::CXXConversionFunctionName:
+  case DeclarationName::CXXUsingDirective:
+    break;
+  }
+
+  return ID.ComputeHash();
+}
+
 const DeclContext *
 serialization::getDefinitiveDeclContext(const DeclContext *DC) {
   switch (DC->getDeclKind()) {
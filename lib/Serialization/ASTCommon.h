@@ -65,6 +65,11 @@ TypeID MakeTypeID(ASTContext &Context, QualType T, IdxForTypeTy IdxForType) {
 
 unsigned ComputeHash(Selector Sel);
 
+/// \brief Compute the hash under which \p Name is stored in the on-disk
+/// lookup table of a declaration context. It only depends on the spelling of
+/// the name.
+unsigned ComputeHash(DeclarationName Name);
+
 /// \brief Retrieve the "definitive" declaration that provides all of the
 /// visible entries for the given declaration context, if there is one.
 ///
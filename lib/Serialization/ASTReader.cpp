@@ -46,6 +46,8 @@
 #include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Bitcode/BitstreamReader.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -56,6 +58,10 @@
 #include <cstdio>
 #include <iterator>
 #include <system_error>
+#if defined(LLVM_ON_UNIX)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
 
 using namespace clang;
 using namespace clang::serialization;
@@ -832,6 +838,8 @@ IdentifierInfo *ASTIdentifierLookupTrait::ReadData(const internal_key_type& k,
 
 unsigned 
 ASTDeclContextNameLookupTrait::ComputeHash(const DeclNameKey &Key) const {
+  // This must agree with serialization::ComputeHash(DeclarationName), which
+  // the global module index uses.
   llvm::FoldingSetNodeID ID;
   ID.AddInteger(Key.Kind);
 
@@ -1145,6 +1153,39 @@ resolveFileRelativeToOriginalDir(const std::string &Filename,
   return currPCHPath.str();
 }
 
+std::unique_ptr<llvm::MemoryBuffer>
+ASTReader::ReadSLocBufferBlob(BitstreamCursor &SLocEntryCursor,
+                              StringRef Name, bool Copy) {
+  RecordData Record;
+  StringRef Blob;
+  unsigned Code = SLocEntryCursor.ReadCode();
+  unsigned RecCode = SLocEntryCursor.readRecord(Code, Record, &Blob);
+
+  if (RecCode == SM_SLOC_BUFFER_BLOB) {
+    if (Copy)
+      return llvm::MemoryBuffer::getMemBufferCopy(Blob.drop_back(1), Name);
+    return llvm::MemoryBuffer::getMemBuffer(Blob.drop_back(1), Name);
+  }
+
+  if (RecCode == SM_SLOC_BUFFER_BLOB_COMPRESSED) {
+    if (!llvm::zlib::isAvailable()) {
+      Error("AST file contains compressed buffers, but zlib is not available");
+      return nullptr;
+    }
+
+    SmallString<0> Uncompressed;
+    if (llvm::zlib::uncompress(Blob, Uncompressed, Record[0]) !=
+        llvm::zlib::StatusOK) {
+      Error("could not decompress buffer in AST file");
+      return nullptr;
+    }
+    return llvm::MemoryBuffer::getMemBufferCopy(Uncompressed.str(), Name);
+  }
+
+  Error("AST record has invalid code");
+  return nullptr;
+}
+
 bool ASTReader::ReadSLocEntry(int ID) {
   if (ID == 0)
     return false;
@@ -1215,17 +1256,11 @@ bool ASTReader::ReadSLocEntry(int ID) {
                               /*isSystemFile=*/FileCharacter != SrcMgr::C_User);
     if (OverriddenBuffer && !ContentCache->BufferOverridden &&
         ContentCache->ContentsEntry == ContentCache->OrigEntry) {
-      unsigned Code = SLocEntryCursor.ReadCode();
-      Record.clear();
-      unsigned RecCode = SLocEntryCursor.readRecord(Code, Record, &Blob);
-      
-      if (RecCode != SM_SLOC_BUFFER_BLOB) {
-        Error("AST record has invalid code");
-        return true;
-      }
-      
+      // The override outlives the module file, so it cannot point into it.
       std::unique_ptr<llvm::MemoryBuffer> Buffer
-        = llvm::MemoryBuffer::getMemBuffer(Blob.drop_back(1), File->getName());
+        = ReadSLocBufferBlob(SLocEntryCursor, File->getName(), /*Copy=*/true);
+      if (!Buffer)
+        return true;
       SourceMgr.overrideFileContents(File, std::move(Buffer));
     }
 
@@ -1241,18 +1276,10 @@ bool ASTReader::ReadSLocEntry(int ID) {
     if (IncludeLoc.isInvalid() && F->Kind == MK_Module) {
       IncludeLoc = getImportLocation(F);
     }
-    unsigned Code = SLocEntryCursor.ReadCode();
-    Record.clear();
-    unsigned RecCode
-      = SLocEntryCursor.readRecord(Code, Record, &Blob);
-
-    if (RecCode != SM_SLOC_BUFFER_BLOB) {
-      Error("AST record has invalid code");
-      return true;
-    }
-
     std::unique_ptr<llvm::MemoryBuffer> Buffer =
-        llvm::MemoryBuffer::getMemBuffer(Blob.drop_back(1), Name);
+        ReadSLocBufferBlob(SLocEntryCursor, Name);
+    if (!Buffer)
+      return true;
     SourceMgr.createFileID(std::move(Buffer), FileCharacter, ID,
                            BaseOffset + Offset, IncludeLoc);
     break;
@@ -2072,6 +2099,27 @@ ASTReader::readInputFileInfo(ModuleFile &F, unsigned ID) {
   return R;
 }
 
+std::unique_ptr<llvm::MemoryBuffer>
+ASTReader::readInputFileContents(ModuleFile &F, unsigned ID, StringRef Name) {
+  BitstreamCursor &Cursor = F.InputFilesCursor;
+  SavedStreamPosition SavedPosition(Cursor);
+  Cursor.JumpToBit(F.InputFileOffsets[ID-1]);
+
+  // Skip the INPUT_FILE record; the contents, if any, directly follow it.
+  Cursor.skipRecord(Cursor.ReadCode());
+  unsigned Code = Cursor.ReadCode();
+  if (Code == llvm::bitc::END_BLOCK)
+    return nullptr;
+
+  RecordData Record;
+  StringRef Blob;
+  if (Cursor.readRecord(Code, Record, &Blob) != INPUT_FILE_CONTENTS)
+    return nullptr;
+
+  // The SourceManager keeps the buffer after the module file is released.
+  return llvm::MemoryBuffer::getMemBufferCopy(Blob.drop_back(1), Name);
+}
+
 std::string ASTReader::getInputFileName(ModuleFile &F, unsigned int ID) {
   return readInputFileInfo(F, ID).Filename;
 }
@@ -2099,8 +2147,15 @@ InputFile ASTReader::getInputFile(ModuleFile &F, unsigned ID, bool Complain) {
   bool Overridden = FI.Overridden;
   StringRef Filename = FI.Filename;
 
+  // If the AST file embeds the contents of this file, they are authoritative
+  // and the file system is not consulted at all.
+  std::unique_ptr<llvm::MemoryBuffer> Embedded;
+  if (Overridden)
+    Embedded = readInputFileContents(F, ID, Filename);
+
   const FileEntry *File
-    = Overridden? FileMgr.getVirtualFile(Filename, StoredSize, StoredTime)
+    = Overridden? FileMgr.getVirtualFile(Filename, StoredSize, StoredTime,
+                                         /*StatFile=*/!Embedded)
                 : FileMgr.getFile(Filename, /*OpenFile=*/false);
 
   // If we didn't find the file, resolve it relative to the
@@ -2150,6 +2205,10 @@ InputFile ASTReader::getInputFile(ModuleFile &F, unsigned ID, bool Complain) {
                             StoredSize, StoredTime);
   }
 
+  // Use the embedded contents instead of reading the file.
+  if (Embedded && !SM.isFileOverridden(File))
+    SM.overrideFileContents(File, std::move(Embedded));
+
   bool IsOutOfDate = false;
 
   // For an overridden file, there is nothing to validate.
@@ -3534,6 +3593,20 @@ static void updateModuleTimestamp(ModuleFile &MF) {
   OS << "Timestamp file\n";
 }
 
+static void updateModuleAccessTime(ModuleFile &MF) {
+#if defined(LLVM_ON_UNIX) && defined(UTIME_OMIT)
+  // Bump only the access time, so that the module file is not considered
+  // out of date, and so that we don't depend on the file system recording
+  // access times (e.g. when mounted with noatime).
+  struct timespec Times[2];
+  Times[0].tv_sec = 0;
+  Times[0].tv_nsec = UTIME_NOW;
+  Times[1].tv_sec = 0;
+  Times[1].tv_nsec = UTIME_OMIT;
+  ::utimensat(AT_FDCWD, MF.FileName.c_str(), Times, 0);
+#endif
+}
+
 ASTReader::ASTReadResult ASTReader::ReadAST(const std::string &FileName,
                                             ModuleKind Type,
                                             SourceLocation ImportLoc,
@@ -3715,6 +3788,16 @@ ASTReader::ASTReadResult ASTReader::ReadAST(const std::string &FileName,
     }
   }
 
+  if (PP.getHeaderSearchInfo().getHeaderSearchOpts().ModuleCacheSizeLimit) {
+    // Record that the modules we just loaded have been used, so that pruning
+    // the module cache down to its size limit evicts them last.
+    for (unsigned I = 0, N = Loaded.size(); I != N; ++I) {
+      ImportedModule &M = Loaded[I];
+      if (M.Mod->Kind == MK_Module)
+        updateModuleAccessTime(*M.Mod);
+    }
+  }
+
   return Success;
 }
 
@@ -6556,7 +6639,13 @@ ASTReader::FindExternalVisibleDeclsByName(const DeclContext *DC,
         (Definitive = getDefinitiveModuleFileFor(Contexts[0], *this))) {
       DeclContextNameLookupVisitor::visit(*Definitive, &Visitor);
     } else {
-      ModuleMgr.visit(&DeclContextNameLookupVisitor::visit, &Visitor);
+      // If there is a global index, look there first to determine which
+      // module files provably have no declarations with this name.
+      GlobalModuleIndex::HitSet Hits;
+      GlobalModuleIndex::HitSet *HitsPtr = nullptr;
+      if (!loadGlobalIndex() && GlobalIndex->lookupDeclName(Name, Hits))
+        HitsPtr = &Hits;
+      ModuleMgr.visit(&DeclContextNameLookupVisitor::visit, &Visitor, HitsPtr);
     }
   };
 
@@ -7105,10 +7194,20 @@ void ASTReader::ReadMethodPool(Selector Sel) {
   unsigned PriorGeneration = Generation;
   Generation = getGeneration();
   
+  // If there is a global index, look there first to determine which modules
+  // provably do not have any methods for this selector.
+  GlobalModuleIndex::HitSet Hits;
+  GlobalModuleIndex::HitSet *HitsPtr = nullptr;
+  if (!loadGlobalIndex()) {
+    if (GlobalIndex->lookupSelector(Sel, Hits)) {
+      HitsPtr = &Hits;
+    }
+  }
+
   // Search for methods defined with this selector.
   ++NumMethodPoolLookups;
   ReadMethodPoolVisitor Visitor(*this, Sel, PriorGeneration);
-  ModuleMgr.visit(&ReadMethodPoolVisitor::visit, &Visitor);
+  ModuleMgr.visit(&ReadMethodPoolVisitor::visit, &Visitor, HitsPtr);
   
   if (Visitor.getInstanceMethods().empty() &&
       Visitor.getFactoryMethods().empty())
@@ -44,8 +44,10 @@
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Bitcode/BitstreamWriter.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -878,6 +880,7 @@ void ASTWriter::WriteBlockInfoBlock() {
 
   BLOCK(INPUT_FILES_BLOCK);
   RECORD(INPUT_FILE);
+  RECORD(INPUT_FILE_CONTENTS);
 
   // AST Top-Level Block.
   BLOCK(AST_BLOCK);
@@ -936,6 +939,7 @@ void ASTWriter::WriteBlockInfoBlock() {
   RECORD(SM_SLOC_BUFFER_ENTRY);
   RECORD(SM_SLOC_BUFFER_BLOB);
   RECORD(SM_SLOC_EXPANSION_ENTRY);
+  RECORD(SM_SLOC_BUFFER_BLOB_COMPRESSED);
 
   // Preprocessor Block.
   BLOCK(PREPROCESSOR_BLOCK);
@@ -1367,6 +1371,7 @@ namespace  {
   /// \brief An input file.
   struct InputFileEntry {
     const FileEntry *File;
+    const SrcMgr::ContentCache *Content;
     bool IsSystemFile;
     bool BufferOverridden;
   };
@@ -1390,6 +1395,16 @@ void ASTWriter::WriteInputFiles(SourceManager &SourceMgr,
   IFAbbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // File name
   unsigned IFAbbrevCode = Stream.EmitAbbrev(IFAbbrev);
 
+  // Create input-file-contents abbreviation.
+  bool EmbedAllFiles = HSOpts.ModulesEmbedAllFiles;
+  unsigned IFContentsAbbrevCode = 0;
+  if (EmbedAllFiles) {
+    BitCodeAbbrev *IFContentsAbbrev = new BitCodeAbbrev();
+    IFContentsAbbrev->Add(BitCodeAbbrevOp(INPUT_FILE_CONTENTS));
+    IFContentsAbbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // Contents
+    IFContentsAbbrevCode = Stream.EmitAbbrev(IFContentsAbbrev);
+  }
+
   // Get all ContentCache objects for files, sorted by whether the file is a
   // system one or not. System files go at the back, users files at the front.
   std::deque<InputFileEntry> SortedFiles;
@@ -1407,6 +1422,7 @@ void ASTWriter::WriteInputFiles(SourceManager &SourceMgr,
 
     InputFileEntry Entry;
     Entry.File = Cache->OrigEntry;
+    Entry.Content = Cache;
     Entry.IsSystemFile = Cache->IsSystemFile;
     Entry.BufferOverridden = Cache->BufferOverridden;
     if (Cache->IsSystemFile)
@@ -1442,8 +1458,10 @@ void ASTWriter::WriteInputFiles(SourceManager &SourceMgr,
     Record.push_back(Entry.File->getSize());
     Record.push_back(Entry.File->getModificationTime());
 
-    // Whether this file was overridden.
-    Record.push_back(Entry.BufferOverridden);
+    // Whether this file was overridden. Embedded files are treated as
+    // overridden by their embedded contents.
+    bool EmbedContents = EmbedAllFiles && !Entry.BufferOverridden;
+    Record.push_back(Entry.BufferOverridden || EmbedContents);
 
     // Turn the file name into an absolute path, if it isn't already.
     const char *Filename = Entry.File->getName();
@@ -1461,6 +1479,19 @@ void ASTWriter::WriteInputFiles(SourceManager &SourceMgr,
     Filename = adjustFilenameForRelocatablePCH(Filename, isysroot);
 
     Stream.EmitRecordWithBlob(IFAbbrevCode, Record, Filename);
+
+    // Embed the contents of the file. We add one to the size so that we
+    // capture the trailing NULL that is required by
+    // llvm::MemoryBuffer::getMemBuffer (on the reader side).
+    if (EmbedContents) {
+      const llvm::MemoryBuffer *Buffer
+        = Entry.Content->getBuffer(SourceMgr.getDiagnostics(), SourceMgr);
+      Record.clear();
+      Record.push_back(INPUT_FILE_CONTENTS);
+      Stream.EmitRecordWithBlob(IFContentsAbbrevCode, Record,
+                                StringRef(Buffer->getBufferStart(),
+                                          Buffer->getBufferSize() + 1));
+    }
   }  
 
   Stream.ExitBlock();
@@ -1528,6 +1559,53 @@ static unsigned CreateSLocBufferBlobAbbrev(llvm::BitstreamWriter &Stream) {
   return Stream.EmitAbbrev(Abbrev);
 }
 
+/// \brief Create an abbreviation for the SLocEntry that refers to a
+/// buffer's compressed blob.
+static unsigned CreateSLocBufferBlobCompressedAbbrev(
+    llvm::BitstreamWriter &Stream) {
+  using namespace llvm;
+  BitCodeAbbrev *Abbrev = new BitCodeAbbrev();
+  Abbrev->Add(BitCodeAbbrevOp(SM_SLOC_BUFFER_BLOB_COMPRESSED));
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::VBR, 8)); // Uncompressed size
+  Abbrev->Add(BitCodeAbbrevOp(BitCodeAbbrevOp::Blob)); // Compressed blob
+  return Stream.EmitAbbrev(Abbrev);
+}
+
+/// \brief Buffers smaller than this are never worth compressing.
+static const unsigned MinCompressedBufferSize = 1024;
+
+/// \brief Emit the blob record holding the contents of a buffer.
+///
+/// \param Contents The buffer contents, including the trailing NULL.
+///
+/// \param Compress Whether to store the contents compressed, if zlib is
+/// available and the buffer is large enough to make it worthwhile.
+static void EmitSLocBufferBlob(llvm::BitstreamWriter &Stream,
+                               StringRef Contents, bool Compress,
+                               unsigned SLocBufferBlobAbbrv,
+                               unsigned SLocBufferBlobCompressedAbbrv) {
+  ASTWriter::RecordData Record;
+  if (Compress && Contents.size() >= MinCompressedBufferSize &&
+      llvm::zlib::isAvailable()) {
+    // The trailing NULL is re-added by the reader when it decompresses the
+    // buffer, so there is no point in storing it.
+    SmallString<0> CompressedBuffer;
+    if (llvm::zlib::compress(Contents.drop_back(1), CompressedBuffer,
+                             llvm::zlib::BestSpeedCompression) ==
+            llvm::zlib::StatusOK &&
+        CompressedBuffer.size() < Contents.size()) {
+      Record.push_back(SM_SLOC_BUFFER_BLOB_COMPRESSED);
+      Record.push_back(Contents.size() - 1);
+      Stream.EmitRecordWithBlob(SLocBufferBlobCompressedAbbrv, Record,
+                                CompressedBuffer.str());
+      return;
+    }
+  }
+
+  Record.push_back(SM_SLOC_BUFFER_BLOB);
+  Stream.EmitRecordWithBlob(SLocBufferBlobAbbrv, Record, Contents);
+}
+
 /// \brief Create an abbreviation for the SLocEntry that refers to a macro
 /// expansion.
 static unsigned CreateSLocExpansionAbbrev(llvm::BitstreamWriter &Stream) {
@@ -1746,7 +1824,10 @@ void ASTWriter::WriteSourceManagerBlock(SourceManager &SourceMgr,
   unsigned SLocFileAbbrv = CreateSLocFileAbbrev(Stream);
   unsigned SLocBufferAbbrv = CreateSLocBufferAbbrev(Stream);
   unsigned SLocBufferBlobAbbrv = CreateSLocBufferBlobAbbrev(Stream);
+  unsigned SLocBufferBlobCompressedAbbrv =
+      CreateSLocBufferBlobCompressedAbbrev(Stream);
   unsigned SLocExpansionAbbrv = CreateSLocExpansionAbbrev(Stream);
+  bool CompressBuffers = PP.getPreprocessorOpts().CompressASTFileBuffers;
 
   // Write out the source location entry table. We skip the first
   // entry, which is always the same dummy entry.
@@ -1807,13 +1888,13 @@ void ASTWriter::WriteSourceManagerBlock(SourceManager &SourceMgr,
         Stream.EmitRecordWithAbbrev(SLocFileAbbrv, Record);
         
         if (Content->BufferOverridden) {
-          Record.clear();
-          Record.push_back(SM_SLOC_BUFFER_BLOB);
           const llvm::MemoryBuffer *Buffer
             = Content->getBuffer(PP.getDiagnostics(), PP.getSourceManager());
-          Stream.EmitRecordWithBlob(SLocBufferBlobAbbrv, Record,
-                                    StringRef(Buffer->getBufferStart(),
-                                              Buffer->getBufferSize() + 1));          
+          EmitSLocBufferBlob(Stream,
+                             StringRef(Buffer->getBufferStart(),
+                                       Buffer->getBufferSize() + 1),
+                             CompressBuffers, SLocBufferBlobAbbrv,
+                             SLocBufferBlobCompressedAbbrv);
         }
       } else {
         // The source location entry is a buffer. The blob associated
@@ -1827,11 +1908,11 @@ void ASTWriter::WriteSourceManagerBlock(SourceManager &SourceMgr,
         const char *Name = Buffer->getBufferIdentifier();
         Stream.EmitRecordWithBlob(SLocBufferAbbrv, Record,
                                   StringRef(Name, strlen(Name) + 1));
-        Record.clear();
-        Record.push_back(SM_SLOC_BUFFER_BLOB);
-        Stream.EmitRecordWithBlob(SLocBufferBlobAbbrv, Record,
-                                  StringRef(Buffer->getBufferStart(),
-                                                  Buffer->getBufferSize() + 1));
+        EmitSLocBufferBlob(Stream,
+                           StringRef(Buffer->getBufferStart(),
+                                     Buffer->getBufferSize() + 1),
+                           CompressBuffers, SLocBufferBlobAbbrv,
+                           SLocBufferBlobCompressedAbbrv);
 
         if (strcmp(Name, "<built-in>") == 0) {
           PreloadSLocs.push_back(SLocEntryOffsets.size());
@@ -2941,10 +3022,15 @@ void ASTWriter::WriteSelectors(Sema &SemaRef) {
     ASTMethodPoolTrait Trait(*this);
 
     // Create the on-disk hash table representation. We walk through every
-    // selector we've seen and look it up in the method pool.
+    // selector we've seen and look it up in the method pool. Visit them in
+    // selector ID order rather than in the (address-dependent) order of the
+    // DenseMap, so that the emitted table is byte-for-byte reproducible.
     SelectorOffsets.resize(NextSelectorID - FirstSelectorID);
-    for (llvm::DenseMap<Selector, SelectorID>::iterator
-             I = SelectorIDs.begin(), E = SelectorIDs.end();
+    SmallVector<std::pair<Selector, SelectorID>, 64> Selectors(
+        SelectorIDs.begin(), SelectorIDs.end());
+    std::sort(Selectors.begin(), Selectors.end(), llvm::less_second());
+    for (SmallVectorImpl<std::pair<Selector, SelectorID> >::iterator
+             I = Selectors.begin(), E = Selectors.end();
          I != E; ++I) {
       Selector S = I->first;
       Sema::GlobalMethodPool::iterator F = SemaRef.MethodPool.find(S);
@@ -3416,10 +3502,15 @@ void ASTWriter::WriteIdentifierTable(Preprocessor &PP,
       getIdentifierRef(ID->second);
 
     // Create the on-disk hash table representation. We only store offsets
-    // for identifiers that appear here for the first time.
+    // for identifiers that appear here for the first time. Insert them in
+    // identifier ID order: the DenseMap order depends on the addresses of the
+    // IdentifierInfos, and would make the bucket layout vary between runs.
     IdentifierOffsets.resize(NextIdentID - FirstIdentID);
-    for (llvm::DenseMap<const IdentifierInfo *, IdentID>::iterator
-           ID = IdentifierIDs.begin(), IDEnd = IdentifierIDs.end();
+    SmallVector<std::pair<const IdentifierInfo *, IdentID>, 256> Identifiers(
+        IdentifierIDs.begin(), IdentifierIDs.end());
+    std::sort(Identifiers.begin(), Identifiers.end(), llvm::less_second());
+    for (SmallVectorImpl<std::pair<const IdentifierInfo *, IdentID> >::iterator
+           ID = Identifiers.begin(), IDEnd = Identifiers.end();
          ID != IDEnd; ++ID) {
       assert(ID->first && "NULL identifier in identifier table");
       if (!Chain || !ID->first->isFromAST() || 
@@ -3522,32 +3613,7 @@ public:
   explicit ASTDeclContextNameLookupTrait(ASTWriter &Writer) : Writer(Writer) { }
 
   hash_value_type ComputeHash(DeclarationName Name) {
-    llvm::FoldingSetNodeID ID;
-    ID.AddInteger(Name.getNameKind());
-
-    switch (Name.getNameKind()) {
-    case DeclarationName::Identifier:
-      ID.AddString(Name.getAsIdentifierInfo()->getName());
-      break;
-    case DeclarationName::ObjCZeroArgSelector:
-    case DeclarationName::ObjCOneArgSelector:
-    case DeclarationName::ObjCMultiArgSelector:
-      ID.AddInteger(serialization::ComputeHash(Name.getObjCSelector()));
-      break;
-    case DeclarationName::CXXConstructorName:
-    case DeclarationName::CXXDestructorName:
-    case DeclarationName::CXXConversionFunctionName:
-      break;
-    case DeclarationName::CXXOperatorName:
-      ID.AddInteger(Name.getCXXOverloadedOperator());
-      break;
-    case DeclarationName::CXXLiteralOperatorName:
-      ID.AddString(Name.getCXXLiteralIdentifier()->getName());
-    case DeclarationName::CXXUsingDirective:
-      break;
-    }
-
-    return ID.ComputeHash();
+    return serialization::ComputeHash(Name);
   }
 
   std::pair<unsigned,unsigned>
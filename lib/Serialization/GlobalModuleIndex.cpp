@@ -11,6 +11,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "ASTCommon.h"
 #include "ASTReaderInternals.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Lex/HeaderSearch.h"
@@ -49,7 +50,11 @@ namespace {
     /// \brief Describes a module, including its file name and dependencies.
     MODULE,
     /// \brief The index for identifiers.
-    IDENTIFIER_INDEX
+    IDENTIFIER_INDEX,
+    /// \brief The index for selectors in the global method pool.
+    SELECTOR_INDEX,
+    /// \brief The index for names in declaration context lookup tables.
+    DECL_NAME_INDEX
   };
 }
 
@@ -57,7 +62,7 @@ namespace {
 static const char * const IndexFileName = "modules.idx";
 
 /// \brief The global index file version.
-static const unsigned CurrentVersion = 1;
+static const unsigned CurrentVersion = 3;
 
 //----------------------------------------------------------------------------//
 // Global module index reader.
@@ -120,12 +125,69 @@ public:
 typedef llvm::OnDiskIterableChainedHashTable<IdentifierIndexReaderTrait>
     IdentifierIndexTable;
 
+/// \brief Trait used to read the selector and declaration name indexes from
+/// the on-disk hash table.
+///
+/// Selectors and names are keyed by their serialization hash, which depends
+/// only on their spelling and can therefore be computed by the index builder
+/// without deserializing the module's identifiers.
+class HashIndexReaderTrait {
+public:
+  typedef unsigned external_key_type;
+  typedef unsigned internal_key_type;
+  typedef SmallVector<unsigned, 2> data_type;
+  typedef unsigned hash_value_type;
+  typedef unsigned offset_type;
+
+  static bool EqualKey(internal_key_type a, internal_key_type b) {
+    return a == b;
+  }
+
+  static hash_value_type ComputeHash(internal_key_type a) { return a; }
+
+  static std::pair<unsigned, unsigned>
+  ReadKeyDataLength(const unsigned char*& d) {
+    using namespace llvm::support;
+    unsigned KeyLen = endian::readNext<uint16_t, little, unaligned>(d);
+    unsigned DataLen = endian::readNext<uint16_t, little, unaligned>(d);
+    return std::make_pair(KeyLen, DataLen);
+  }
+
+  static const internal_key_type&
+  GetInternalKey(const external_key_type& x) { return x; }
+
+  static internal_key_type ReadKey(const unsigned char* d, unsigned n) {
+    using namespace llvm::support;
+    return endian::readNext<uint32_t, little, unaligned>(d);
+  }
+
+  static data_type ReadData(internal_key_type k,
+                            const unsigned char* d,
+                            unsigned DataLen) {
+    using namespace llvm::support;
+
+    data_type Result;
+    while (DataLen > 0) {
+      unsigned ID = endian::readNext<uint32_t, little, unaligned>(d);
+      Result.push_back(ID);
+      DataLen -= 4;
+    }
+
+    return Result;
+  }
+};
+
+typedef llvm::OnDiskChainedHashTable<HashIndexReaderTrait> HashIndexTable;
+
 }
 
 GlobalModuleIndex::GlobalModuleIndex(std::unique_ptr<llvm::MemoryBuffer> Buffer,
                                      llvm::BitstreamCursor Cursor)
-    : Buffer(std::move(Buffer)), IdentifierIndex(), NumIdentifierLookups(),
-      NumIdentifierLookupHits() {
+    : Buffer(std::move(Buffer)), IdentifierIndex(), SelectorIndex(),
+      DeclNameIndex(), NumIdentifierLookups(), NumIdentifierLookupHits(),
+      NumSelectorLookups(), NumSelectorLookupHits(),
+      NumSelectorModuleFilesSkipped(), NumDeclNameLookups(),
+      NumDeclNameLookupHits(), NumDeclNameModuleFilesSkipped() {
   // Read the global index.
   bool InGlobalIndexBlock = false;
   bool Done = false;
@@ -223,12 +285,32 @@ GlobalModuleIndex::GlobalModuleIndex(std::unique_ptr<llvm::MemoryBuffer> Buffer,
             (const unsigned char *)Blob.data(), IdentifierIndexReaderTrait());
       }
       break;
+
+    case SELECTOR_INDEX:
+      // Wire up the selector index.
+      if (Record[0]) {
+        SelectorIndex = HashIndexTable::Create(
+            (const unsigned char *)Blob.data() + Record[0],
+            (const unsigned char *)Blob.data(), HashIndexReaderTrait());
+      }
+      break;
+
+    case DECL_NAME_INDEX:
+      // Wire up the declaration name index.
+      if (Record[0]) {
+        DeclNameIndex = HashIndexTable::Create(
+            (const unsigned char *)Blob.data() + Record[0],
+            (const unsigned char *)Blob.data(), HashIndexReaderTrait());
+      }
+      break;
     }
   }
 }
 
 GlobalModuleIndex::~GlobalModuleIndex() {
   delete static_cast<IdentifierIndexTable *>(IdentifierIndex);
+  delete static_cast<HashIndexTable *>(SelectorIndex);
+  delete static_cast<HashIndexTable *>(DeclNameIndex);
 }
 
 std::pair<GlobalModuleIndex *, GlobalModuleIndex::ErrorCode>
@@ -316,6 +398,51 @@ bool GlobalModuleIndex::lookupIdentifier(StringRef Name, HitSet &Hits) {
   return true;
 }
 
+bool GlobalModuleIndex::lookupHash(void *Index, unsigned Hash,
+                                   llvm::SmallPtrSetImpl<ModuleFile *> &Hits) {
+  HashIndexTable &Table = *static_cast<HashIndexTable *>(Index);
+  HashIndexTable::iterator Known = Table.find(Hash);
+  if (Known == Table.end())
+    return false;
+
+  SmallVector<unsigned, 2> ModuleIDs = *Known;
+  for (unsigned I = 0, N = ModuleIDs.size(); I != N; ++I) {
+    if (ModuleFile *MF = Modules[ModuleIDs[I]].File)
+      Hits.insert(MF);
+  }
+  return true;
+}
+
+bool GlobalModuleIndex::lookupSelector(Selector Sel, HitSet &Hits) {
+  Hits.clear();
+
+  // If there's no selector index, there is nothing we can do.
+  if (!SelectorIndex)
+    return false;
+
+  // Look into the selector index.
+  ++NumSelectorLookups;
+  if (lookupHash(SelectorIndex, serialization::ComputeHash(Sel), Hits))
+    ++NumSelectorLookupHits;
+  NumSelectorModuleFilesSkipped += ModulesByFile.size() - Hits.size();
+  return true;
+}
+
+bool GlobalModuleIndex::lookupDeclName(DeclarationName Name, HitSet &Hits) {
+  Hits.clear();
+
+  // If there's no name index, there is nothing we can do.
+  if (!DeclNameIndex)
+    return false;
+
+  // Look into the name index.
+  ++NumDeclNameLookups;
+  if (lookupHash(DeclNameIndex, serialization::ComputeHash(Name), Hits))
+    ++NumDeclNameLookupHits;
+  NumDeclNameModuleFilesSkipped += ModulesByFile.size() - Hits.size();
+  return true;
+}
+
 bool GlobalModuleIndex::loadedModuleFile(ModuleFile *File) {
   // Look for the module in the global module index based on the module name.
   StringRef Name = File->ModuleName;
@@ -350,6 +477,20 @@ void GlobalModuleIndex::printStats() {
             NumIdentifierLookupHits, NumIdentifierLookups,
             (double)NumIdentifierLookupHits*100.0/NumIdentifierLookups);
   }
+  if (NumSelectorLookups) {
+    fprintf(stderr, "  %u / %u selector lookups succeeded (%f%%)\n",
+            NumSelectorLookupHits, NumSelectorLookups,
+            (double)NumSelectorLookupHits*100.0/NumSelectorLookups);
+    fprintf(stderr, "  %u module files skipped by selector lookups\n",
+            NumSelectorModuleFilesSkipped);
+  }
+  if (NumDeclNameLookups) {
+    fprintf(stderr, "  %u / %u declaration name lookups succeeded (%f%%)\n",
+            NumDeclNameLookupHits, NumDeclNameLookups,
+            (double)NumDeclNameLookupHits*100.0/NumDeclNameLookups);
+    fprintf(stderr, "  %u module files skipped by declaration name lookups\n",
+            NumDeclNameModuleFilesSkipped);
+  }
   std::fprintf(stderr, "\n");
 }
 
@@ -398,10 +539,31 @@ namespace {
     /// \brief A mapping from all interesting identifiers to the set of module
     /// files in which those identifiers are considered interesting.
     InterestingIdentifierMap InterestingIdentifiers;
+
+    /// \brief Mapping from selector or declaration name hashes to the list
+    /// of module file IDs in whose hash tables they were seen.
+    typedef llvm::MapVector<unsigned, SmallVector<unsigned, 2> > HashIndexMap;
+
+    /// \brief The selector hashes of all the method pool entries we've seen.
+    HashIndexMap Selectors;
+
+    /// \brief The hashes of all the names in the declaration context lookup
+    /// tables we've seen.
+    HashIndexMap DeclNames;
     
     /// \brief Write the block-info block for the global module index file.
     void emitBlockInfoBlock(llvm::BitstreamWriter &Stream);
 
+    /// \brief Add the hashes of the entries of the on-disk hash table in
+    /// \p Blob, whose buckets are at \p BucketOffset, to \p Index as seen in
+    /// module file \p ID.
+    static void addOnDiskHashes(HashIndexMap &Index, unsigned ID,
+                                StringRef Blob, uint64_t BucketOffset);
+
+    /// \brief Write \p Index as an on-disk hash table in a \p Code record.
+    static void writeHashIndex(llvm::BitstreamWriter &Stream, unsigned Code,
+                               const HashIndexMap &Index);
+
     /// \brief Retrieve the module file information for the given file.
     ModuleFileInfo &getModuleFileInfo(const FileEntry *File) {
       llvm::MapVector<const FileEntry *, ModuleFileInfo>::iterator Known
@@ -464,6 +626,8 @@ GlobalModuleIndexBuilder::emitBlockInfoBlock(llvm::BitstreamWriter &Stream) {
   RECORD(INDEX_METADATA);
   RECORD(MODULE);
   RECORD(IDENTIFIER_INDEX);
+  RECORD(SELECTOR_INDEX);
+  RECORD(DECL_NAME_INDEX);
 #undef RECORD
 #undef BLOCK
 
@@ -491,6 +655,47 @@ namespace {
   };
 }
 
+/// \brief Walk every entry of the on-disk hash table rooted at \p Buckets and
+/// report the hash value stored with it.
+///
+/// The method pool keys refer to identifiers by their module-local IDs, which
+/// we cannot resolve here. The stored hash, however, only depends on the
+/// selector spelling, so it is enough to build a (conservative) index.
+static void collectOnDiskHashes(const unsigned char *Buckets,
+                                const unsigned char *Base,
+                                SmallVectorImpl<unsigned> &Hashes) {
+  using namespace llvm::support;
+  uint32_t NumBuckets = endian::readNext<uint32_t, little, aligned>(Buckets);
+  (void)endian::readNext<uint32_t, little, aligned>(Buckets); // NumEntries
+  for (uint32_t B = 0; B != NumBuckets; ++B) {
+    uint32_t Offset = endian::readNext<uint32_t, little, aligned>(Buckets);
+    if (!Offset)
+      continue;
+
+    const unsigned char *Items = Base + Offset;
+    unsigned NumItems = endian::readNext<uint16_t, little, unaligned>(Items);
+    for (unsigned I = 0; I != NumItems; ++I) {
+      Hashes.push_back(endian::readNext<uint32_t, little, unaligned>(Items));
+      unsigned KeyLen = endian::readNext<uint16_t, little, unaligned>(Items);
+      unsigned DataLen = endian::readNext<uint16_t, little, unaligned>(Items);
+      Items += KeyLen + DataLen;
+    }
+  }
+}
+
+void GlobalModuleIndexBuilder::addOnDiskHashes(HashIndexMap &Index,
+                                               unsigned ID, StringRef Blob,
+                                               uint64_t BucketOffset) {
+  SmallVector<unsigned, 64> Hashes;
+  collectOnDiskHashes((const unsigned char *)Blob.data() + BucketOffset,
+                      (const unsigned char *)Blob.data(), Hashes);
+  for (unsigned I = 0, N = Hashes.size(); I != N; ++I) {
+    SmallVectorImpl<unsigned> &IDs = Index[Hashes[I]];
+    if (IDs.empty() || IDs.back() != ID)
+      IDs.push_back(ID);
+  }
+}
+
 bool GlobalModuleIndexBuilder::loadModuleFile(const FileEntry *File) {
   // Open the module file.
 
@@ -521,7 +726,7 @@ bool GlobalModuleIndexBuilder::loadModuleFile(const FileEntry *File) {
   unsigned ID = getModuleFileInfo(File).ID;
 
   // Search for the blocks and records we care about.
-  enum { Other, ControlBlock, ASTBlock } State = Other;
+  enum { Other, ControlBlock, ASTBlock, DeclTypesBlock } State = Other;
   bool Done = false;
   while (!Done) {
     llvm::BitstreamEntry Entry = InStream.advance();
@@ -559,13 +764,22 @@ bool GlobalModuleIndexBuilder::loadModuleFile(const FileEntry *File) {
         continue;
       }
 
+      if (State == ASTBlock && Entry.ID == DECLTYPES_BLOCK_ID) {
+        if (InStream.EnterSubBlock(DECLTYPES_BLOCK_ID))
+          return true;
+
+        // Found the block holding the declaration context lookup tables.
+        State = DeclTypesBlock;
+        continue;
+      }
+
       if (InStream.SkipBlock())
         return true;
 
       continue;
 
     case llvm::BitstreamEntry::EndBlock:
-      State = Other;
+      State = State == DeclTypesBlock ? ASTBlock : Other;
       continue;
     }
 
@@ -634,6 +848,17 @@ bool GlobalModuleIndexBuilder::loadModuleFile(const FileEntry *File) {
       }
     }
 
+    // Handle the global method pool.
+    if (State == ASTBlock && Code == METHOD_POOL && Record[0] > 0)
+      addOnDiskHashes(Selectors, ID, Blob, Record[0]);
+
+    // Handle the declaration context lookup tables, and the updates to those
+    // of other module files.
+    if (State == DeclTypesBlock && Code == DECL_CONTEXT_VISIBLE)
+      addOnDiskHashes(DeclNames, ID, Blob, Record[0]);
+    if (State == ASTBlock && Code == UPDATE_VISIBLE)
+      addOnDiskHashes(DeclNames, ID, Blob, Record[1]);
+
     // We don't care about this record.
   }
 
@@ -680,6 +905,80 @@ public:
   }
 };
 
+/// \brief Trait used to generate the selector and declaration name indexes as
+/// on-disk hash tables.
+class HashIndexWriterTrait {
+public:
+  typedef unsigned key_type;
+  typedef unsigned key_type_ref;
+  typedef SmallVector<unsigned, 2> data_type;
+  typedef const SmallVector<unsigned, 2> &data_type_ref;
+  typedef unsigned hash_value_type;
+  typedef unsigned offset_type;
+
+  static hash_value_type ComputeHash(key_type_ref Key) { return Key; }
+
+  std::pair<unsigned,unsigned>
+  EmitKeyDataLength(raw_ostream& Out, key_type_ref Key, data_type_ref Data) {
+    using namespace llvm::support;
+    endian::Writer<little> LE(Out);
+    unsigned KeyLen = 4;
+    unsigned DataLen = Data.size() * 4;
+    LE.write<uint16_t>(KeyLen);
+    LE.write<uint16_t>(DataLen);
+    return std::make_pair(KeyLen, DataLen);
+  }
+
+  void EmitKey(raw_ostream& Out, key_type_ref Key, unsigned KeyLen) {
+    using namespace llvm::support;
+    endian::Writer<little>(Out).write<uint32_t>(Key);
+  }
+
+  void EmitData(raw_ostream& Out, key_type_ref Key, data_type_ref Data,
+                unsigned DataLen) {
+    using namespace llvm::support;
+    for (unsigned I = 0, N = Data.size(); I != N; ++I)
+      endian::Writer<little>(Out).write<uint32_t>(Data[I]);
+  }
+};
+
+}
+
+void GlobalModuleIndexBuilder::writeHashIndex(llvm::BitstreamWriter &Stream,
+                                              unsigned Code,
+                                              const HashIndexMap &Index) {
+  llvm::OnDiskChainedHashTableGenerator<HashIndexWriterTrait> Generator;
+  HashIndexWriterTrait Trait;
+
+  // Populate the hash table.
+  for (HashIndexMap::const_iterator I = Index.begin(), IEnd = Index.end();
+       I != IEnd; ++I) {
+    Generator.insert(I->first, I->second, Trait);
+  }
+
+  // Create the on-disk hash table in a buffer.
+  SmallString<4096> Table;
+  uint32_t BucketOffset;
+  {
+    using namespace llvm::support;
+    llvm::raw_svector_ostream Out(Table);
+    // Make sure that no bucket is at offset 0
+    endian::Writer<little>(Out).write<uint32_t>(0);
+    BucketOffset = Generator.Emit(Out, Trait);
+  }
+
+  // Create a blob abbreviation
+  llvm::BitCodeAbbrev *Abbrev = new llvm::BitCodeAbbrev();
+  Abbrev->Add(llvm::BitCodeAbbrevOp(Code));
+  Abbrev->Add(llvm::BitCodeAbbrevOp(llvm::BitCodeAbbrevOp::Fixed, 32));
+  Abbrev->Add(llvm::BitCodeAbbrevOp(llvm::BitCodeAbbrevOp::Blob));
+  unsigned TableAbbrev = Stream.EmitAbbrev(Abbrev);
+
+  // Write the table
+  SmallVector<uint64_t, 2> Record;
+  Record.push_back(Code);
+  Record.push_back(BucketOffset);
+  Stream.EmitRecordWithBlob(TableAbbrev, Record, Table.str());
 }
 
 void GlobalModuleIndexBuilder::writeIndex(llvm::BitstreamWriter &Stream) {
@@ -759,6 +1058,12 @@ void GlobalModuleIndexBuilder::writeIndex(llvm::BitstreamWriter &Stream) {
     Stream.EmitRecordWithBlob(IDTableAbbrev, Record, IdentifierTable.str());
   }
 
+  // Write the selector -> module file mapping.
+  writeHashIndex(Stream, SELECTOR_INDEX, Selectors);
+
+  // Write the declaration name -> module file mapping.
+  writeHashIndex(Stream, DECL_NAME_INDEX, DeclNames);
+
   Stream.ExitBlock();
 }
 
@@ -118,9 +118,16 @@ ModuleManager::addModule(StringRef FileName, ModuleKind Type,
         // ModuleManager it must be the same underlying file.
         // FIXME: Because FileManager::getFile() doesn't guarantee that it will
         // give us an open file, this may not be 100% reliable.
+        //
+        // The bitstream reader never looks past the end of the buffer, so we
+        // don't need a null terminator. Dropping that requirement lets the
+        // AST file always be memory-mapped rather than copied onto the heap
+        // when its size happens to be a multiple of the page size, so that
+        // every process importing the module shares the same clean pages.
         New->Buffer = FileMgr.getBufferForFile(New->File, &ErrorStr,
                                                /*IsVolatile*/ false,
-                                               /*ShouldClose*/ false);
+                                               /*ShouldClose*/ false,
+                                               /*RequiresNullTerminator*/false);
       }
       
       if (!New->Buffer)
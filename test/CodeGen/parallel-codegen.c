@@ -0,0 +1,50 @@
+// REQUIRES: x86-registered-target, native, shell
+// UNSUPPORTED: system-darwin, system-windows
+//
+// The pieces of the module are combined by the host 'ld'.
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -fparallel-codegen=2 \
+// RUN:   -emit-obj -o %t1.o %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -fparallel-codegen=2 \
+// RUN:   -emit-obj -o %t2.o %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux -fparallel-codegen=2 \
+// RUN:   -DSCALE=5 -emit-obj -o %t3.o %s
+// RUN: llvm-nm %t1.o %t2.o %t3.o | FileCheck %s
+
+#ifndef SCALE
+#define SCALE 3
+#endif
+
+static int counter;
+
+// The declaration of 'helper' is created while 'f' is emitted, so the
+// functions are partitioned in the order f, helper, g: 'f' and 'g' go to the
+// first piece, and 'helper' to the second one. 'helper' is called from the
+// first piece and uses 'counter', which lives in the first piece with the
+// other globals, so both get hidden global names with a suffix unique to the
+// contents of the object file.
+static int helper(int x) { return x * SCALE + counter++; }
+
+int f(int x) { return helper(x) + 1; }
+
+int g(int x) { return helper(x) - 1; }
+
+// The same source gives the same names.
+// CHECK: parallel-codegen.c.tmp1.o:
+// CHECK: B counter.pcg.[[SUFFIX:[0-9a-f]+]]
+// CHECK: T f
+// CHECK: T g
+// CHECK: T helper.pcg.[[SUFFIX]]
+// CHECK: parallel-codegen.c.tmp2.o:
+// CHECK: B counter.pcg.[[SUFFIX]]
+// CHECK: T f
+// CHECK: T g
+// CHECK: T helper.pcg.[[SUFFIX]]
+
+// Different contents give different names.
+// CHECK: parallel-codegen.c.tmp3.o:
+// CHECK-NOT: .pcg.[[SUFFIX]]
+// CHECK: B counter.pcg.{{[0-9a-f]+}}
+// CHECK: T f
+// CHECK: T g
+// CHECK-NOT: .pcg.[[SUFFIX]]
+// CHECK: T helper.pcg.{{[0-9a-f]+}}
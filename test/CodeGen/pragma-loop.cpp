@@ -74,6 +74,39 @@ void for_define_test(int *List, int Length, int Value) {
   }
 }
 
+// Verify distribute, vectorize_predicate and pipeline generate metadata.
+void distribute_test(int *List, int *Other, int Length) {
+#pragma clang loop distribute(enable) vectorize_predicate(enable) pipeline(disable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br i1 {{.*}}, label {{.*}}, label {{.*}}, !llvm.loop ![[LOOP_9:.*]]
+    List[i + 1] = List[i] + 1;
+    Other[i] = i * 2;
+  }
+}
+
+// Verify unroll_and_jam_count and pipeline_initiation_interval are attached
+// to the outer loop.
+void unroll_and_jam_test(int *List, int Length) {
+#pragma clang loop unroll_and_jam_count(4) pipeline_initiation_interval(10)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br i1 {{.*}}, label {{.*}}, label {{.*}}, !llvm.loop ![[LOOP_10:.*]]
+    for (int j = 0; j < Length; j++) {
+      // CHECK: br i1 {{.*}}, label {{.*}}, label {{.*}}
+      // CHECK-NOT: !llvm.loop
+      List[i * Length + j] = j;
+    }
+  }
+}
+
+// Verify disabling unroll_and_jam and distribute generates correct metadata.
+void unroll_and_jam_disable_test(int *List, int Length) {
+#pragma clang loop unroll_and_jam(disable) distribute(disable)
+  for (int i = 0; i < Length; i++) {
+    // CHECK: br i1 {{.*}}, label {{.*}}, label {{.*}}, !llvm.loop ![[LOOP_11:.*]]
+    List[i] = i * 2;
+  }
+}
+
 // Verify metadata is generated when template is used.
 template <typename A>
 void for_template_test(A *List, int Length, A Value) {
@@ -124,6 +157,16 @@ void template_test(double *List, int Length) {
 // CHECK: ![[LOOP_5]] = metadata !{metadata ![[LOOP_5]], metadata ![[UNROLL_DISABLE:.*]], metadata ![[WIDTH_1:.*]]}
 // CHECK: ![[WIDTH_1]] = metadata !{metadata !"llvm.loop.vectorize.width", i32 1}
 // CHECK: ![[LOOP_6]] = metadata !{metadata ![[LOOP_6]], metadata ![[UNROLL_8:.*]], metadata ![[INTERLEAVE_2:.*]], metadata ![[WIDTH_2:.*]]}
+// CHECK: ![[LOOP_9]] = metadata !{metadata ![[LOOP_9]], metadata ![[PIPELINE_DISABLE:.*]], metadata ![[PREDICATE_ENABLE:.*]], metadata ![[DISTRIBUTE_ENABLE:.*]]}
+// CHECK: ![[PIPELINE_DISABLE]] = metadata !{metadata !"llvm.loop.pipeline.disable", i1 true}
+// CHECK: ![[PREDICATE_ENABLE]] = metadata !{metadata !"llvm.loop.vectorize.predicate.enable", i1 true}
+// CHECK: ![[DISTRIBUTE_ENABLE]] = metadata !{metadata !"llvm.loop.distribute.enable", i1 true}
+// CHECK: ![[LOOP_10]] = metadata !{metadata ![[LOOP_10]], metadata ![[II_10:.*]], metadata ![[UAJ_4:.*]]}
+// CHECK: ![[II_10]] = metadata !{metadata !"llvm.loop.pipeline.initiationinterval", i32 10}
+// CHECK: ![[UAJ_4]] = metadata !{metadata !"llvm.loop.unroll_and_jam.count", i32 4}
+// CHECK: ![[LOOP_11]] = metadata !{metadata ![[LOOP_11]], metadata ![[DISTRIBUTE_DISABLE:.*]], metadata ![[UAJ_DISABLE:.*]]}
+// CHECK: ![[DISTRIBUTE_DISABLE]] = metadata !{metadata !"llvm.loop.distribute.enable", i1 false}
+// CHECK: ![[UAJ_DISABLE]] = metadata !{metadata !"llvm.loop.unroll_and_jam.disable"}
 // CHECK: ![[LOOP_7]] = metadata !{metadata ![[LOOP_7]], metadata ![[UNROLL_8:.*]], metadata ![[INTERLEAVE_8:.*]], metadata ![[WIDTH_8:.*]]}
 // CHECK: ![[INTERLEAVE_8]] = metadata !{metadata !"llvm.loop.interleave.count", i32 8}
 // CHECK: ![[LOOP_8]] = metadata !{metadata ![[LOOP_8]], metadata ![[UNROLL_8:.*]], metadata ![[INTERLEAVE_2:.*]], metadata ![[WIDTH_2:.*]]}
@@ -0,0 +1,89 @@
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -emit-llvm \
+// RUN:   -discard-emitted-function-bodies %s -o - | FileCheck %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -emit-llvm \
+// RUN:   -discard-emitted-function-bodies -print-stats %s -o /dev/null 2>&1 \
+// RUN:   | FileCheck -check-prefix=STATS %s
+// RUN: %clang_cc1 -std=c++11 -triple x86_64-unknown-linux-gnu -emit-llvm \
+// RUN:   -print-stats %s -o /dev/null 2>&1 \
+// RUN:   | FileCheck -check-prefix=NO-DISCARD %s
+
+// square, N::twice, cfun, counter, A::member and use are emitted as soon as
+// they are seen, and nothing needs their bodies afterwards.
+// STATS: 6 function bodies discarded
+// NO-DISCARD-NOT: function bodies discarded
+
+// CHECK-LABEL: define i32 @_Z6squarei(
+// CHECK: mul nsw i32
+int square(int x) {
+  int y = x * x;
+  return y;
+}
+
+namespace N {
+// CHECK-LABEL: define i32 @_ZN1N5twiceEi(
+// CHECK: add nsw i32
+int twice(int x) { return x + x; }
+}
+
+// CHECK-LABEL: define i32 @cfun(
+extern "C" int cfun(int x) {
+  if (x)
+    return 1;
+  return 0;
+}
+
+// CHECK-LABEL: define i32 @_Z7counterv(
+// CHECK: @_ZZ7countervE1n
+int counter() {
+  static int n = 0;
+  return ++n;
+}
+
+// Bodies that can still be needed are kept: inline functions are emitted
+// where they are used, constexpr functions evaluated and templates
+// instantiated.
+inline int kept_inline(int x) { return x - 1; }
+constexpr int kept_constexpr(int x) { return x + 1; }
+template <typename T> T kept_template(T t) { return t; }
+
+// Constructors are emitted in several variants.
+struct A {
+  A();
+  int member();
+};
+A::A() {}
+
+// CHECK-LABEL: define i32 @_ZN1A6memberEv(
+int A::member() { return 3; }
+
+// Lambdas, local classes and static temporaries can be referenced from
+// outside the body.
+// CHECK-LABEL: define i32 @_Z11with_lambdav(
+int with_lambda() { return [] { return 1; }(); }
+
+// CHECK-LABEL: define i32 @_Z16with_local_classv(
+int with_local_class() {
+  struct S {
+    int f() { return 2; }
+  };
+  return S().f();
+}
+
+// CHECK-LABEL: define i32 @_Z11with_staticv(
+int with_static() {
+  static const int &r = 5;
+  return r;
+}
+
+static_assert(kept_constexpr(1) == 2, "");
+
+// CHECK-LABEL: define i32 @_Z3usev(
+// CHECK: call i32 @_Z13kept_templateIiET_S0_(
+// CHECK: call i32 @_Z11kept_inlinei(
+// CHECK: call i32 @_Z6squarei(
+int use() {
+  return kept_constexpr(1) + kept_template(2) + kept_inline(3) + square(4);
+}
+
+// CHECK-DAG: define linkonce_odr i32 @_Z11kept_inlinei(
+// CHECK-DAG: define linkonce_odr i32 @_Z13kept_templateIiET_S0_(
@@ -0,0 +1,10 @@
+// RUN: %clang -target x86_64-unknown-linux -fparallel-codegen=4 -c %s -### 2>&1 \
+// RUN:   | FileCheck %s
+// CHECK: "-cc1"
+// CHECK: "-fparallel-codegen=4"
+// CHECK: "-parallel-codegen-linker" "{{[^"]*}}ld"
+
+// RUN: %clang -target x86_64-unknown-linux -c %s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix=NO-PARALLEL %s
+// NO-PARALLEL-NOT: "-fparallel-codegen
+// NO-PARALLEL-NOT: "-parallel-codegen-linker"
@@ -0,0 +1,21 @@
+// RUN: %clang_cc1 -fsyntax-only -print-memory-report %s 2>&1 | FileCheck %s
+
+struct S { int a, b; };
+int f(struct S *s) { return s->a + s->b; }
+
+// CHECK: *** Memory Report for '{{.*}}print-memory-report.c':
+// CHECK-NEXT: ast.decls: {{[1-9][0-9]*}}
+// CHECK-NEXT: ast.types: {{[1-9][0-9]*}}
+// CHECK-NEXT: ast.stmts-and-other: {{[0-9]+}}
+// CHECK-NEXT: ast.allocator-slack: {{[0-9]+}}
+// CHECK-NEXT: ast.side-tables: {{[0-9]+}}
+// CHECK-NEXT: sema: {{[0-9]+}}
+// CHECK-NEXT: preprocessor: {{[0-9]+}}
+// CHECK-NEXT: preprocessor.identifiers: {{[1-9][0-9]*}}
+// CHECK-NEXT: preprocessor.selectors: {{[0-9]+}}
+// CHECK-NEXT: preprocessor.header-search: {{[0-9]+}}
+// CHECK-NEXT: source-manager.content-cache: {{[0-9]+}}
+// CHECK-NEXT: source-manager.buffers.malloc: {{[0-9]+}}
+// CHECK-NEXT: source-manager.buffers.mmap: {{[0-9]+}}
+// CHECK-NEXT: source-manager.data-structures: {{[0-9]+}}
+// CHECK-NEXT: total: {{[1-9][0-9]*}}
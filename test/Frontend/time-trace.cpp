@@ -0,0 +1,25 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -I %S/Inputs -ftime-trace=%t.json -ftime-trace-granularity=0 -emit-obj -o %t.o %s
+// RUN: FileCheck %s < %t.json
+// RUN: not %clang_cc1 -fsyntax-only -ftime-trace=%t-missing/out.json %s 2>&1 | FileCheck -check-prefix=ERROR %s
+// REQUIRES: x86-registered-target
+
+#include "test.h"
+
+template <typename T> struct Box { T Value; };
+
+int get(Box<int> *B) { return B->Value; }
+
+// CHECK: {"traceEvents":[
+// CHECK-DAG: "tid":1,"ph":"X",{{.*}}"name":"Source","args":{"detail":"{{.*}}test.h"}
+// CHECK-DAG: "tid":0,"ph":"X",{{.*}}"name":"InstantiateTemplate","args":{"detail":"Box<int>"}
+// CHECK-DAG: "tid":0,"ph":"X",{{.*}}"name":"ParseTopLevelDecl","args":{"detail":"get"}
+// CHECK-DAG: "tid":0,"ph":"X",{{.*}}"name":"EmitTopLevelDecl","args":{"detail":"get"}
+// CHECK-DAG: "tid":0,"ph":"X",{{.*}}"name":"ActOnEndOfTranslationUnit"}
+// CHECK-DAG: "tid":0,"ph":"X",{{.*}}"name":"Backend"}
+// CHECK-DAG: "tid":0,"ph":"X",{{.*}}"name":"ParseAST"}
+// CHECK-DAG: "tid":0,"ph":"X",{{.*}}"name":"ExecuteCompiler"}
+// CHECK: "name":"thread_name","args":{"name":"Compilation"}
+// CHECK: "name":"thread_name","args":{"name":"Source files"}
+// CHECK: ]}
+
+// ERROR: error: unable to open output file '{{.*}}out.json'
@@ -0,0 +1,23 @@
+// RUN: %clang_cc1 -std=c++11 -lazy-function-bodies -Wunused-function -verify \
+// RUN:   -ast-dump %s | FileCheck %s
+
+// Dumping the AST asks for every body, so the lazily-skipped bodies are all
+// parsed, and the unused functions are diagnosed once nothing else can use
+// them.
+
+static int used() { return 0; }
+static int unused() { return 1; } // expected-warning {{unused function 'unused'}}
+
+int f() { return used(); }
+
+// CHECK:      FunctionDecl {{.*}} used 'int
+// CHECK-NEXT:   CompoundStmt
+// CHECK-NEXT:     ReturnStmt
+// CHECK:      FunctionDecl {{.*}} unused 'int
+// CHECK-NEXT:   CompoundStmt
+// CHECK-NEXT:     ReturnStmt
+// CHECK:      FunctionDecl {{.*}} f 'int
+// CHECK-NEXT:   CompoundStmt
+// CHECK-NEXT:     ReturnStmt
+// CHECK-NEXT:       CallExpr
+// CHECK:              DeclRefExpr {{.*}} 'used'
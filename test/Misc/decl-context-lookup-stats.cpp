@@ -0,0 +1,16 @@
+// RUN: %clang_cc1 -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+namespace N {
+  int a, b, c, d, e, f, g, h;
+}
+
+int x = N::a + N::h;
+
+struct S {
+  int m;
+  int get() { return m; }
+};
+
+// CHECK: *** DeclContext Lookup Stats:
+// CHECK-DAG: {{[1-9][0-9]*}} Namespace lookups, {{[1-9][0-9]*}} lookup table builds
+// CHECK-DAG: {{[1-9][0-9]*}} CXXRecord lookups
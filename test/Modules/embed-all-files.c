@@ -0,0 +1,23 @@
+// Test that module files built with -fmodules-embed-all-files are loaded
+// without consulting the original headers.
+
+// RUN: rm -rf %t
+// RUN: mkdir -p %t/include
+// RUN: echo 'module Embedded { header "embedded.h" export * }' > %t/include/module.modulemap
+// RUN: echo 'int embedded_value(void);' > %t/include/embedded.h
+// RUN: %clang_cc1 -fmodules -fmodules-cache-path=%t/cache -fmodules-embed-all-files -I %t/include -fsyntax-only %s -verify
+
+// Changing the header must not invalidate the module: the embedded copy is
+// authoritative, so the module is not rebuilt from the new contents.
+// RUN: echo '#error the original header should not be read' > %t/include/embedded.h
+// RUN: %clang_cc1 -fmodules -fmodules-cache-path=%t/cache -fmodules-embed-all-files -I %t/include -fsyntax-only %s -verify
+
+// Without the option, the module has a different hash and is built from the
+// headers on disk.
+// RUN: not %clang_cc1 -fmodules -fmodules-cache-path=%t/cache -I %t/include -fsyntax-only %s 2>&1 | FileCheck %s
+// CHECK: error: the original header should not be read
+
+// expected-no-diagnostics
+@import Embedded;
+
+int f(void) { return embedded_value(); }
@@ -13,7 +13,13 @@
 @import Module;
 
 // CHECK: *** Global Module Index Statistics:
+// CHECK: selector lookups succeeded
+// CHECK: {{[1-9][0-9]*}} module files skipped by selector lookups
 
 int *get_sub() {
   return Module_Sub;
 }
+
+const char *get_version(id obj) {
+  return [obj version];
+}
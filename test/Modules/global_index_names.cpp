@@ -0,0 +1,18 @@
+// RUN: rm -rf %t
+// Run and create the global module index
+// RUN: %clang_cc1 -x objective-c++ -fmodules-cache-path=%t -fdisable-module-hash -fmodules -I %S/Inputs/global-index-names %s -verify
+// RUN: ls %t|grep modules.idx
+// Run and use the global module index
+// RUN: %clang_cc1 -x objective-c++ -fmodules-cache-path=%t -fdisable-module-hash -fmodules -I %S/Inputs/global-index-names %s -verify -print-stats 2>&1 | FileCheck %s
+
+// expected-no-diagnostics
+@import A;
+@import B;
+
+// CHECK: *** Global Module Index Statistics:
+// CHECK: declaration name lookups succeeded
+// CHECK: {{[1-9][0-9]*}} module files skipped by declaration name lookups
+
+int f() {
+  return N::a();
+}
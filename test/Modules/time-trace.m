@@ -0,0 +1,14 @@
+// RUN: rm -rf %t
+// RUN: %clang_cc1 -fmodules -fmodules-cache-path=%t -F %S/Inputs -ftime-trace=%t.json -ftime-trace-granularity=0 -fsyntax-only %s
+// RUN: FileCheck %s < %t.json
+
+// The files entered while building a module are ended with the module build,
+// and do not take the place of the files of the importing compilation.
+
+@import DependsOnModule;
+
+// CHECK: {"traceEvents":[
+// CHECK-DAG: "tid":1,"ph":"X",{{.*}}"name":"Source","args":{"detail":"{{.*}}DependsOnModule.h"}
+// CHECK-DAG: "tid":1,"ph":"X",{{.*}}"name":"Source","args":{"detail":"{{.*}}Module.h"}
+// CHECK-DAG: "tid":1,"ph":"X",{{.*}}"name":"Source","args":{"detail":"{{.*}}time-trace.m"}
+// CHECK: ]}
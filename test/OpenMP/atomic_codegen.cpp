@@ -0,0 +1,116 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+int x, v;
+short sx;
+float fx;
+double dv;
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}reads{{.*}}()
+void reads() {
+// CHECK: [[X:%.+]] = load atomic i32* @x monotonic
+// CHECK-NEXT: store i32 [[X]], i32* @v
+#pragma omp atomic read
+  v = x;
+// CHECK: [[FX:%.+]] = load atomic i32* bitcast (float* @fx to i32*) seq_cst
+// CHECK-NEXT: [[FX_VAL:%.+]] = bitcast i32 [[FX]] to float
+// CHECK-NEXT: [[CONV:%.+]] = fpext float [[FX_VAL]] to double
+// CHECK-NEXT: store double [[CONV]], double* @dv
+#pragma omp atomic read seq_cst
+  dv = fx;
+// CHECK: ret void
+}
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}writes{{.*}}()
+void writes() {
+// CHECK: [[V:%.+]] = load i32* @v
+// CHECK-NEXT: [[ADD:%.+]] = add nsw i32 [[V]], 1
+// CHECK-NEXT: store atomic i32 [[ADD]], i32* @x monotonic
+#pragma omp atomic write
+  x = v + 1;
+// CHECK: store atomic i32 {{%.+}}, i32* bitcast (float* @fx to i32*) monotonic
+#pragma omp atomic write
+  fx = dv;
+// CHECK: ret void
+}
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}updates{{.*}}()
+void updates() {
+// Integer additions, subtractions and bitwise operations are atomicrmw
+// instructions.
+// CHECK: atomicrmw add i32* @x, i32 1 monotonic
+#pragma omp atomic
+  ++x;
+// CHECK: [[V:%.+]] = load i32* @v
+// CHECK-NEXT: atomicrmw add i32* @x, i32 [[V]] monotonic
+#pragma omp atomic update
+  x += v;
+// CHECK: [[V:%.+]] = load i32* @v
+// CHECK-NEXT: [[V_TRUNC:%.+]] = trunc i32 [[V]] to i16
+// CHECK-NEXT: atomicrmw sub i16* @sx, i16 [[V_TRUNC]] monotonic
+#pragma omp atomic
+  sx = sx - v;
+// CHECK: atomicrmw or i32* @x, i32 4 seq_cst
+#pragma omp atomic seq_cst
+  x |= 4;
+
+// Other updates are compare-and-exchange loops.
+// CHECK: [[V:%.+]] = load i32* @v
+// CHECK-NEXT: [[OLD:%.+]] = load atomic i32* @x monotonic
+// CHECK-NEXT: br label %[[CONT:.+]]
+// CHECK: [[CONT]]:
+// CHECK-NEXT: [[X:%.+]] = phi i32 [ [[OLD]], %{{.+}} ], [ [[PREV:%.+]], %[[CONT]] ]
+// CHECK-NEXT: [[NEW:%.+]] = sub i32 [[V]], [[X]]
+// CHECK-NEXT: [[PAIR:%.+]] = cmpxchg i32* @x, i32 [[X]], i32 [[NEW]] monotonic monotonic
+// CHECK-NEXT: [[PREV]] = extractvalue { i32, i1 } [[PAIR]], 0
+// CHECK-NEXT: [[OK:%.+]] = extractvalue { i32, i1 } [[PAIR]], 1
+// CHECK-NEXT: br i1 [[OK]], label %{{.+}}, label %[[CONT]]
+#pragma omp atomic
+  x = v - x;
+// CHECK: [[OLD:%.+]] = load atomic i32* bitcast (float* @fx to i32*) monotonic
+// CHECK: [[FX:%.+]] = phi i32 [ [[OLD]], %{{.+}} ]
+// CHECK-NEXT: [[FX_VAL:%.+]] = bitcast i32 [[FX]] to float
+// CHECK-NEXT: [[FX_CONV:%.+]] = fpext float [[FX_VAL]] to double
+// CHECK-NEXT: [[MUL:%.+]] = fmul double [[FX_CONV]], {{.+}}
+// CHECK-NEXT: [[NEW:%.+]] = fptrunc double [[MUL]] to float
+// CHECK-NEXT: [[NEW_INT:%.+]] = bitcast float [[NEW]] to i32
+// CHECK-NEXT: cmpxchg i32* bitcast (float* @fx to i32*), i32 [[FX]], i32 [[NEW_INT]] monotonic monotonic
+#pragma omp atomic
+  fx *= dv;
+// CHECK: ret void
+}
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}captures{{.*}}()
+void captures() {
+// CHECK: [[OLD:%.+]] = atomicrmw add i32* @x, i32 1 monotonic
+// CHECK-NEXT: add i32 [[OLD]], 1
+// CHECK-NEXT: store i32 [[OLD]], i32* @v
+#pragma omp atomic capture
+  v = x++;
+// CHECK: [[OLD:%.+]] = atomicrmw sub i32* @x, i32 1 monotonic
+// CHECK-NEXT: [[NEW:%.+]] = sub i32 [[OLD]], 1
+// CHECK-NEXT: store i32 [[NEW]], i32* @v
+#pragma omp atomic capture
+  v = --x;
+// CHECK: [[OLD:%.+]] = atomicrmw xchg i32* @x, i32 5 monotonic
+// CHECK-NEXT: store i32 [[OLD]], i32* @v
+#pragma omp atomic capture
+  {
+    v = x;
+    x = 5;
+  }
+// CHECK: [[NEW:%.+]] = fadd float {{%.+}}, 1.000000e+00
+// CHECK: cmpxchg i32* bitcast (float* @fx to i32*)
+// CHECK: [[CONV:%.+]] = fpext float [[NEW]] to double
+// CHECK-NEXT: store double [[CONV]], double* @dv
+#pragma omp atomic capture
+  {
+    fx += 1.0f;
+    dv = fx;
+  }
+// CHECK: ret void
+}
+
+#endif
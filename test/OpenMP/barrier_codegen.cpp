@@ -0,0 +1,17 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+// CHECK-DAG: [[IDENT_T_TY:%.+]] = type { i32, i32, i32, i32, i8* }
+// CHECK-DAG: [[EXPLICIT_BARRIER_LOC:@.+]] = private unnamed_addr constant [[IDENT_T_TY]] { i32 0, i32 34, i32 0, i32 0, i8*
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}barrier{{.*}}()
+void barrier() {
+// CHECK: [[GTID:%.+]] = call i32 @__kmpc_global_thread_num([[IDENT_T_TY]]* {{@[^,]+}})
+// CHECK: call void @__kmpc_barrier([[IDENT_T_TY]]* [[EXPLICIT_BARRIER_LOC]], i32 [[GTID]])
+#pragma omp barrier
+// CHECK: ret void
+}
+
+#endif
@@ -0,0 +1,180 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+// CHECK-DAG: [[IDENT_T_TY:%.+]] = type { i32, i32, i32, i32, i8* }
+// CHECK-DAG: [[BARRIER_LOC:@.+]] = private unnamed_addr constant [[IDENT_T_TY]] { i32 0, i32 66, i32 0, i32 0, i8*
+
+// CHECK-LABEL: define {{.*void}} @{{.*}}without_schedule_clause{{.*}}(float* {{.+}}, float* {{.+}}, float* {{.+}}, float* {{.+}})
+void without_schedule_clause(float *a, float *b, float *c, float *d) {
+// CHECK: [[GTID:%.+]] = call i32 @__kmpc_global_thread_num([[IDENT_T_TY]]* [[DEFAULT_LOC:@[^,]+]])
+#pragma omp for
+// CHECK: call void @__kmpc_for_static_init_4u([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i32 34, i32* [[IS_LAST:%[^,]+]], i32* [[OMP_LB:%[^,]+]], i32* [[OMP_UB:%[^,]+]], i32* [[OMP_ST:%[^,]+]], i32 1, i32 1)
+// UB = min(UB, GlobalUB)
+// CHECK-NEXT: [[UB:%.+]] = load i32* [[OMP_UB]]
+// CHECK-NEXT: [[UBCMP:%.+]] = icmp ugt i32 [[UB]], 4571423
+// CHECK-NEXT: [[UB_MIN:%.+]] = select i1 [[UBCMP]], i32 4571423, i32 [[UB]]
+// CHECK-NEXT: [[LB:%.+]] = load i32* [[OMP_LB]]
+// CHECK-NEXT: store i32 [[LB]], i32* [[OMP_IV:%[^,]+]]
+// CHECK-NEXT: br label %[[LOOP:.+]]
+// CHECK: [[LOOP]]:
+// CHECK-NEXT: [[IV:%.+]] = load i32* [[OMP_IV]]
+// CHECK-NEXT: [[CMP:%.+]] = icmp ule i32 [[IV]], [[UB_MIN]]
+// CHECK-NEXT: br i1 [[CMP]], label %[[BODY:.+]], label %[[END:.+]]
+// CHECK: [[BODY]]:
+// i = 33 + IV * 7
+// CHECK-NEXT: [[MUL:%.+]] = mul i32 [[IV]], 7
+// CHECK-NEXT: [[CALC:%.+]] = add i32 33, [[MUL]]
+// CHECK-NEXT: store i32 [[CALC]], i32* [[I:%[^,]+]]
+// CHECK: br label %[[INC:.+]]
+// CHECK: [[INC]]:
+// CHECK-NEXT: [[IV2:%.+]] = load i32* [[OMP_IV]]
+// CHECK-NEXT: [[ADD:%.+]] = add i32 [[IV2]], 1
+// CHECK-NEXT: store i32 [[ADD]], i32* [[OMP_IV]]
+// CHECK-NEXT: br label %[[LOOP]]
+// CHECK: [[END]]:
+// CHECK-NEXT: call void @__kmpc_for_static_fini([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]])
+// CHECK: call void @__kmpc_barrier([[IDENT_T_TY]]* [[BARRIER_LOC]], i32 [[GTID]])
+// CHECK: ret void
+  for (int i = 33; i < 32000000; i += 7) {
+    a[i] = b[i] * c[i] * d[i];
+  }
+}
+
+// CHECK-LABEL: define {{.*void}} @{{.*}}dynamic1{{.*}}(float* {{.+}}, float* {{.+}}, float* {{.+}}, float* {{.+}})
+void dynamic1(float *a, float *b, float *c, float *d) {
+// CHECK: [[GTID:%.+]] = call i32 @__kmpc_global_thread_num([[IDENT_T_TY]]* [[DEFAULT_LOC:@[^,]+]])
+#pragma omp for schedule(dynamic, 7) nowait
+// CHECK: call void @__kmpc_dispatch_init_8u([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i32 35, i64 {{%.+}}, i64 {{%.+}}, i64 {{%.+}}, i64 7)
+// CHECK: [[HASWORK:%.+]] = call i32 @__kmpc_dispatch_next_8u([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i32* [[IS_LAST:%[^,]+]], i64* [[OMP_LB:%[^,]+]], i64* [[OMP_UB:%[^,]+]], i64* [[OMP_ST:%[^,]+]])
+// CHECK-NEXT: [[O_CMP:%.+]] = icmp ne i32 [[HASWORK]], 0
+// CHECK-NEXT: br i1 [[O_CMP]], label %[[O_LOOP1_BODY:[^,]+]], label %[[O_LOOP1_END:[^,]+]]
+// CHECK: [[O_LOOP1_BODY]]:
+// CHECK-NEXT: [[UB:%.+]] = load i64* [[OMP_UB]]
+// CHECK-NEXT: [[LB:%.+]] = load i64* [[OMP_LB]]
+// CHECK-NEXT: store i64 [[LB]], i64* [[OMP_IV:%[^,]+]]
+// CHECK-NEXT: br label %[[LOOP:.+]]
+// CHECK: [[LOOP]]:
+// CHECK-NEXT: [[IV:%.+]] = load i64* [[OMP_IV]]
+// CHECK-NEXT: [[CMP:%.+]] = icmp ule i64 [[IV]], [[UB]]
+// CHECK-NEXT: br i1 [[CMP]], label %[[BODY:.+]], label %[[END:.+]]
+// CHECK: [[BODY]]:
+// i = 131071 + IV * 127
+// CHECK-NEXT: [[MUL:%.+]] = mul i64 [[IV]], 127
+// CHECK-NEXT: [[CALC:%.+]] = add i64 131071, [[MUL]]
+// CHECK-NEXT: store i64 [[CALC]], i64* [[I:%[^,]+]]
+// CHECK: [[END]]:
+// CHECK-NEXT: br label %[[O_LOOP1_COND:.+]]
+// CHECK: [[O_LOOP1_END]]:
+// CHECK-NOT: __kmpc_barrier
+// CHECK: ret void
+  for (unsigned long long i = 131071; i <= 2147483647; i += 127) {
+    a[i] = b[i] * c[i] * d[i];
+  }
+}
+
+// CHECK-LABEL: define {{.*i32}} @{{.*}}static_chunked_lastprivate{{.*}}(float* {{.+}})
+int static_chunked_lastprivate(float *a) {
+// CHECK: store i32 0, i32* [[I:%[^,]+]]
+  int i = 0;
+#pragma omp for schedule(static, 5) lastprivate(i)
+// CHECK: call void @__kmpc_for_static_init_4u([[IDENT_T_TY]]* {{@[^,]+}}, i32 [[GTID:%[^,]+]], i32 33, i32* [[IS_LAST:%[^,]+]], i32* [[OMP_LB:%[^,]+]], i32* [[OMP_UB:%[^,]+]], i32* [[OMP_ST:%[^,]+]], i32 1, i32 5)
+// CHECK-NEXT: br label %[[O_LOOP_COND:.+]]
+// CHECK: [[O_LOOP_COND]]:
+// CHECK-NEXT: [[LB:%.+]] = load i32* [[OMP_LB]]
+// CHECK-NEXT: [[HAS_CHUNK:%.+]] = icmp ule i32 [[LB]], 9
+// CHECK-NEXT: br i1 [[HAS_CHUNK]], label %[[O_LOOP_BODY:[^,]+]], label %[[O_LOOP_END:[^,]+]]
+// CHECK: [[O_LOOP_BODY]]:
+// CHECK-NEXT: [[UB:%.+]] = load i32* [[OMP_UB]]
+// CHECK-NEXT: [[UBCMP:%.+]] = icmp ugt i32 [[UB]], 9
+// CHECK-NEXT: [[UB_MIN:%.+]] = select i1 [[UBCMP]], i32 9, i32 [[UB]]
+// Next chunk: LB += ST, UB += ST
+// CHECK: [[ST:%.+]] = load i32* [[OMP_ST]]
+// CHECK-NEXT: [[LB2:%.+]] = load i32* [[OMP_LB]]
+// CHECK-NEXT: [[LB3:%.+]] = add i32 [[LB2]], [[ST]]
+// CHECK-NEXT: store i32 [[LB3]], i32* [[OMP_LB]]
+// CHECK-NEXT: [[UB2:%.+]] = load i32* [[OMP_UB]]
+// CHECK-NEXT: [[UB3:%.+]] = add i32 [[UB2]], [[ST]]
+// CHECK-NEXT: store i32 [[UB3]], i32* [[OMP_UB]]
+// CHECK-NEXT: br label %[[O_LOOP_COND]]
+// CHECK: [[O_LOOP_END]]:
+// CHECK-NEXT: call void @__kmpc_for_static_fini([[IDENT_T_TY]]* {{@[^,]+}}, i32 [[GTID]])
+// The last iteration sets 'i' to its value after the sequential loop.
+// CHECK-NEXT: [[LAST:%.+]] = load i32* [[IS_LAST]]
+// CHECK-NEXT: [[IS_LAST_CMP:%.+]] = icmp ne i32 [[LAST]], 0
+// CHECK-NEXT: br i1 [[IS_LAST_CMP]], label %[[LAST_THEN:[^,]+]], label %[[LAST_DONE:[^,]+]]
+// CHECK: [[LAST_THEN]]:
+// CHECK-NEXT: store i32 10, i32* [[I_PRIV:%[^,]+]]
+// CHECK-NEXT: [[VAL:%.+]] = load i32* [[I_PRIV]]
+// CHECK-NEXT: store i32 [[VAL]], i32* [[I]]
+// CHECK: call void @__kmpc_barrier([[IDENT_T_TY]]* [[BARRIER_LOC]], i32 [[GTID]])
+  for (i = 0; i < 10; i++)
+    a[i] = 0;
+  return i;
+}
+
+// CHECK-LABEL: define {{.*void}} @{{.*}}collapsed{{.*}}(float* {{.+}})
+void collapsed(float *a) {
+#pragma omp for collapse(2) schedule(runtime)
+// CHECK: call void @__kmpc_dispatch_init_8u([[IDENT_T_TY]]* {{@[^,]+}}, i32 {{%[^,]+}}, i32 37, i64 {{%.+}}, i64 {{%.+}}, i64 {{%.+}}, i64 1)
+// CHECK: [[IV:%.+]] = load i64* [[OMP_IV:%[^,]+]]
+// CHECK-NEXT: [[CMP:%.+]] = icmp ule i64 [[IV]],
+// CHECK-NEXT: br i1 [[CMP]], label %[[BODY:.+]], label %{{.+}}
+// CHECK: [[BODY]]:
+// j = (IV % 20) * 1, i = (IV / 20) * 1
+// CHECK-NEXT: [[J_IDX:%.+]] = urem i64 [[IV]], 20
+// CHECK-NEXT: [[I_IDX:%.+]] = udiv i64 [[IV]], 20
+// CHECK-NEXT: [[J_MUL:%.+]] = mul i64 [[J_IDX]], 1
+// CHECK-NEXT: [[J_ADD:%.+]] = add i64 0, [[J_MUL]]
+// CHECK-NEXT: [[J_VAL:%.+]] = trunc i64 [[J_ADD]] to i32
+// CHECK-NEXT: store i32 [[J_VAL]], i32* {{%[^,]+}}
+// CHECK-NEXT: [[I_MUL:%.+]] = mul i64 [[I_IDX]], 1
+// CHECK-NEXT: [[I_ADD:%.+]] = add i64 0, [[I_MUL]]
+// CHECK-NEXT: [[I_VAL:%.+]] = trunc i64 [[I_ADD]] to i32
+// CHECK-NEXT: store i32 [[I_VAL]], i32* {{%[^,]+}}
+// CHECK: call void @__kmpc_barrier(
+  for (int i = 0; i < 10; ++i)
+    for (int j = 0; j < 20; ++j)
+      a[i * 20 + j] = 0;
+}
+
+// CHECK-LABEL: define {{.*void}} @{{.*}}parallel_guided{{.*}}(float* {{.+}})
+void parallel_guided(float *a) {
+// CHECK: call void {{.+}} @__kmpc_fork_call(
+#pragma omp parallel for schedule(guided)
+  for (int i = 0; i < 100; ++i)
+    a[i] = 0;
+}
+// CHECK: define internal void @__captured_stmt{{.*}}(i32* %.global_tid., i32* %.bound_tid., {{.+}})
+// CHECK: [[GTID:%.+]] = load i32* %.global_tid.
+// CHECK: call void @__kmpc_dispatch_init_4u([[IDENT_T_TY]]* {{@[^,]+}}, i32 [[GTID]], i32 36, i32 {{%.+}}, i32 {{%.+}}, i32 {{%.+}}, i32 1)
+// CHECK: call i32 @__kmpc_dispatch_next_4u([[IDENT_T_TY]]* {{@[^,]+}}, i32 [[GTID]],
+// CHECK-NOT: __kmpc_barrier
+// CHECK: ret void
+
+// CHECK-LABEL: define {{.*void}} @{{.*}}whole_range{{.*}}(float* {{.+}}, i32 {{.+}})
+void whole_range(float *a, int n) {
+// 'i <= 4294967295u' runs 2^32 times, which does not fit in 32 bits.
+// CHECK: call void @__kmpc_for_static_init_8u({{.+}}, i64* {{%[^,]+}}, i64* {{%[^,]+}}, i64* {{%[^,]+}}, i64 1, i64 1)
+#pragma omp for nowait
+  for (unsigned i = 0; i <= 4294967295u; ++i)
+    a[i % 16] = 0;
+// So may 'i <= n' for a variable 'n'.
+// CHECK: call void @__kmpc_for_static_init_8u({{.+}}, i64* {{%[^,]+}}, i64* {{%[^,]+}}, i64* {{%[^,]+}}, i64 1, i64 1)
+#pragma omp for nowait
+  for (int i = 0; i <= n; ++i)
+    a[i] = 0;
+// But not 'i <= 100' or 'i < n'.
+// CHECK: call void @__kmpc_for_static_init_4u({{.+}}, i32* {{%[^,]+}}, i32* {{%[^,]+}}, i32* {{%[^,]+}}, i32 1, i32 1)
+#pragma omp for nowait
+  for (int i = 0; i <= 100; ++i)
+    a[i] = 0;
+// CHECK: call void @__kmpc_for_static_init_4u({{.+}}, i32* {{%[^,]+}}, i32* {{%[^,]+}}, i32* {{%[^,]+}}, i32 1, i32 1)
+#pragma omp for nowait
+  for (int i = 0; i < n; ++i)
+    a[i] = 0;
+// CHECK: ret void
+}
+
+#endif // HEADER
@@ -0,0 +1,28 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+// CHECK-DAG: [[IDENT_T_TY:%.+]] = type { i32, i32, i32, i32, i8* }
+
+void foo(int);
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}master{{.*}}()
+void master() {
+// CHECK: [[GTID:%.+]] = call i32 @__kmpc_global_thread_num([[IDENT_T_TY]]* [[DEFAULT_LOC:@[^,]+]])
+// CHECK: [[RES:%.+]] = call i32 @__kmpc_master([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]])
+// CHECK-NEXT: [[IS_MASTER:%.+]] = icmp ne i32 [[RES]], 0
+// CHECK-NEXT: br i1 [[IS_MASTER]], label %[[THEN:.+]], label %[[END:.+]]
+// CHECK: [[THEN]]:
+// CHECK-NEXT: call void {{.*}}foo{{.*}}(i32 1)
+// CHECK-NEXT: call void @__kmpc_end_master([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]])
+// CHECK-NEXT: br label %[[END]]
+// CHECK: [[END]]:
+// There is no barrier at the end of the region.
+// CHECK-NOT: __kmpc_barrier
+// CHECK: ret void
+#pragma omp master
+  foo(1);
+}
+
+#endif
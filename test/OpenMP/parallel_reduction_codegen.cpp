@@ -0,0 +1,125 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+// CHECK-DAG: [[IDENT_T_TY:%.+]] = type { i32, i32, i32, i32, i8* }
+// CHECK-DAG: [[REDUCTION_LOCK:@.+]] = common global [8 x i32] zeroinitializer
+
+void foo(int);
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}sum{{.*}}(i32 {{.*}}%n)
+void sum(int n) {
+  int s = 0, p = 1;
+// CHECK: call void {{.*}}@__kmpc_fork_call(
+#pragma omp parallel reduction(+ : s) firstprivate(n) private(p)
+  {
+    p = n;
+    s += p;
+  }
+}
+
+// The private copy of 's' starts at 0, and that of 'n' is a copy of 'n'.
+// CHECK: define internal void @__captured_stmt(i32* %.global_tid., i32* %.bound_tid., {{.+}})
+// CHECK-DAG: [[S_PRIV:%s[0-9]*]] = alloca i32,
+// CHECK-DAG: [[N_PRIV:%n[0-9]*]] = alloca i32,
+// CHECK-DAG: [[P_PRIV:%p[0-9]*]] = alloca i32,
+// CHECK: store i32 0, i32* [[S_PRIV]]
+// CHECK: load i32* [[N_PRIV]]
+// CHECK: store i32 {{%.+}}, i32* [[P_PRIV]]
+// CHECK: [[RES:%.+]] = call i32 @__kmpc_reduce_nowait([[IDENT_T_TY]]* {{@[^,]+}}, i32 {{%.+}}, i32 1, i64 8, i8* {{%.+}}, void (i8*, i8*)* [[REDUCTION_FUNC:@[^,]+]], [8 x i32]* [[REDUCTION_LOCK]])
+// CHECK: switch i32 [[RES]], label %[[DONE:.+]] [
+// CHECK-NEXT: i32 1, label %[[CASE1:.+]]
+// CHECK-NEXT: i32 2, label %[[CASE2:.+]]
+// CHECK-NEXT: ]
+// CHECK: [[CASE1]]:
+// CHECK: add i32
+// CHECK: call void @__kmpc_end_reduce_nowait([[IDENT_T_TY]]* {{@[^,]+}}, i32 {{%.+}}, [8 x i32]* [[REDUCTION_LOCK]])
+// CHECK: br label %[[DONE]]
+// CHECK: [[CASE2]]:
+// CHECK: [[S_VAL:%.+]] = load i32* [[S_PRIV]]
+// CHECK-NEXT: atomicrmw add i32* {{%.+}}, i32 [[S_VAL]] monotonic
+// CHECK-NOT: __kmpc_end_reduce
+// CHECK: br label %[[DONE]]
+// CHECK: [[DONE]]:
+// CHECK: ret void
+
+// The reduction function combines the lists of private copies of two threads.
+// CHECK: define internal void [[REDUCTION_FUNC]](i8*, i8*)
+// CHECK: bitcast i8* {{%.+}} to [1 x i8*]*
+// CHECK: bitcast i8* {{%.+}} to [1 x i8*]*
+// CHECK: add i32
+// CHECK: ret void
+
+// CHECK-LABEL: define {{.*}}float @{{.*}}maximum{{.*}}(float* {{.*}}%a, i32 {{.*}}%n)
+float maximum(float *a, int n) {
+  float m = a[0];
+// CHECK: call void {{.*}}@__kmpc_fork_call(
+#pragma omp parallel for reduction(max : m)
+  for (int i = 0; i < n; ++i)
+    if (a[i] > m)
+      m = a[i];
+  return m;
+}
+
+// There is no atomic instruction for floating-point 'max': only the
+// reduction function and the combining with the original are used.
+// CHECK: define internal void @__captured_stmt{{[0-9]+}}(i32* %.global_tid., i32* %.bound_tid., {{.+}})
+// CHECK: store float 0xC7EFFFFFE0000000, float* [[M_PRIV:%.+]]
+// CHECK: call void @__kmpc_for_static_init_4u(
+// CHECK: call void @__kmpc_for_static_fini(
+// CHECK: [[RES:%.+]] = call i32 @__kmpc_reduce_nowait(
+// CHECK: switch i32 [[RES]], label %[[DONE:.+]] [
+// CHECK-NEXT: i32 1, label %[[CASE1:.+]]
+// CHECK-NEXT: ]
+// CHECK: [[CASE1]]:
+// CHECK: fcmp ogt float
+// CHECK: select i1
+// CHECK: call void @__kmpc_end_reduce_nowait(
+// CHECK: [[DONE]]:
+// CHECK: ret void
+
+// CHECK-LABEL: define {{.*}}i32 @{{.*}}count{{.*}}(i32 {{.*}}%n)
+int count(int n) {
+  int c = 0;
+#pragma omp parallel
+  {
+#pragma omp for reduction(+ : c)
+    for (int i = 0; i < n; ++i)
+      ++c;
+    foo(c);
+  }
+  return c;
+}
+
+// Without 'nowait', the end of the reduction of the loop is a barrier.
+// CHECK: define internal void @__captured_stmt{{[0-9]+}}(i32* %.global_tid., i32* %.bound_tid., {{.+}})
+// CHECK: call void @__kmpc_for_static_fini(
+// CHECK: call i32 @__kmpc_reduce(
+// CHECK: call void @__kmpc_end_reduce(
+// CHECK: atomicrmw add
+// CHECK: call void @__kmpc_end_reduce(
+// CHECK: call void {{.*}}foo
+// CHECK: ret void
+
+// CHECK-LABEL: define {{.*}}i32 @{{.*}}simd_sum{{.*}}(i32* {{.*}}%a, i32 {{.*}}%n)
+int simd_sum(int *a, int n) {
+  int s = 0;
+// A 'simd' loop is executed by a single thread: its private copy of 's' is
+// combined with 's' without calling the runtime.
+// CHECK: [[S:%s]] = alloca i32,
+// CHECK: [[S_PRIV:%s[0-9]+]] = alloca i32,
+// CHECK: store i32 0, i32* [[S_PRIV]]
+// CHECK-NOT: __kmpc_reduce
+// CHECK: [[S_VAL:%.+]] = load i32* [[S]]
+// CHECK-NEXT: [[S_PRIV_VAL:%.+]] = load i32* [[S_PRIV]]
+// CHECK-NEXT: [[SUM:%.+]] = add i32 [[S_VAL]], [[S_PRIV_VAL]]
+// CHECK-NEXT: store i32 [[SUM]], i32* [[S]]
+#pragma omp simd reduction(+ : s)
+  for (int i = 0; i < n; ++i)
+    s += a[i];
+// CHECK: ret i32
+  return s;
+}
+
+#endif
@@ -0,0 +1,123 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}linear{{.*}}(float* {{.*}}%a, float* {{.*}}%b, i32 {{.*}}%n)
+void linear(float *a, float *b, int n) {
+  int j = 0;
+  float *p = b;
+// CHECK: [[J:%j]] = alloca i32,
+// CHECK: [[P:%p]] = alloca float*,
+// CHECK: [[I_PRIV:%i]] = alloca i32,
+// CHECK: [[J_PRIV:%j[0-9]+]] = alloca i32,
+// CHECK: [[P_PRIV:%p[0-9]+]] = alloca float*,
+// CHECK: [[J_START:%.+]] = load i32* [[J]]
+// CHECK: [[P_START:%.+]] = load float** [[P]]
+// CHECK: br i1 {{%.+}}, label %omp.precond.then, label %omp.precond.end
+// CHECK: omp.inner.for.cond:
+// CHECK: [[IV:%.+]] = load i32* %omp.iv
+// CHECK: omp.inner.for.body:
+// The counter and the 'linear' variables are all computed from the
+// iteration number.
+// CHECK: [[I_OFF:%.+]] = mul i32 [[IV]], 1
+// CHECK-NEXT: [[I_VAL:%.+]] = add i32 0, [[I_OFF]]
+// CHECK-NEXT: store i32 [[I_VAL]], i32* [[I_PRIV]]
+// CHECK-NEXT: [[J_OFF:%.+]] = mul i32 [[IV]], 2
+// CHECK-NEXT: [[J_VAL:%.+]] = add i32 [[J_START]], [[J_OFF]]
+// CHECK-NEXT: store i32 [[J_VAL]], i32* [[J_PRIV]]
+// CHECK-NEXT: [[P_OFF:%.+]] = mul i32 [[IV]], 1
+// CHECK-NEXT: [[P_VAL:%.+]] = getelementptr float* [[P_START]], i32 [[P_OFF]]
+// CHECK-NEXT: store float* [[P_VAL]], float** [[P_PRIV]]
+// CHECK: store float {{.+}}, float* {{.+}}, !llvm.mem.parallel_loop_access [[LOOP:![0-9]+]]
+// CHECK: br label %omp.inner.for.cond, !llvm.loop [[LOOP]]
+// CHECK: omp.inner.for.end:
+// The original variables get their values after the last iteration.
+// CHECK: [[J_LAST:%.+]] = load i32* [[J_PRIV]]
+// CHECK-NEXT: store i32 [[J_LAST]], i32* [[J]]
+// CHECK-NEXT: [[P_LAST:%.+]] = load float** [[P_PRIV]]
+// CHECK-NEXT: store float* [[P_LAST]], float** [[P]]
+// CHECK: omp.precond.end:
+#pragma omp simd linear(j : 2) linear(p)
+  for (int i = 0; i < n; ++i)
+    a[i] = *p + j;
+// CHECK: ret void
+}
+
+// CHECK-LABEL: define {{.*}}i64 @{{.*}}linear_long{{.*}}(float* {{.*}}%a, i32 {{.*}}%n, i64 {{.*}}%start)
+long linear_long(float *a, int n, long start) {
+  long l = start;
+// CHECK: [[L:%l]] = alloca i64,
+// CHECK: [[L_PRIV:%l[0-9]+]] = alloca i64,
+// CHECK: [[L_START:%.+]] = load i64* [[L]]
+// CHECK: omp.inner.for.body:
+// A 'linear' variable wider than the iteration number is computed in its
+// own type, from the zero-extended iteration number and its signed step.
+// CHECK: [[IDX:%.+]] = zext i32 {{%.+}} to i64
+// CHECK-NEXT: [[L_OFF:%.+]] = mul i64 [[IDX]], -3
+// CHECK-NEXT: [[L_VAL:%.+]] = add i64 [[L_START]], [[L_OFF]]
+// CHECK-NEXT: store i64 [[L_VAL]], i64* [[L_PRIV]]
+// CHECK: omp.inner.for.end:
+// CHECK: [[L_LAST:%.+]] = load i64* [[L_PRIV]]
+// CHECK-NEXT: store i64 [[L_LAST]], i64* [[L]]
+#pragma omp simd linear(l : -3)
+  for (int i = 0; i < n; ++i)
+    a[i] = l;
+// CHECK: ret i64
+  return l;
+}
+
+// CHECK-LABEL: define {{.*}}i32 @{{.*}}collapse{{.*}}(float* {{.*}}%a, i32 {{.*}}%n, i32 {{.*}}%m)
+int collapse(float *a, int n, int m) {
+  int i, j, last = 0, k;
+// CHECK: [[I:%i]] = alloca i32,
+// CHECK: [[J:%j]] = alloca i32,
+// CHECK: [[LAST:%last]] = alloca i32,
+// CHECK: [[I_PRIV:%i[0-9]+]] = alloca i32,
+// CHECK: [[J_PRIV:%j[0-9]+]] = alloca i32,
+// CHECK: [[K_PRIV:%k[0-9]+]] = alloca i32,
+// CHECK: [[LAST_PRIV:%last[0-9]+]] = alloca i32,
+// CHECK: [[IV_ADDR:%omp.iv]] = alloca i64,
+// CHECK: omp.inner.for.cond:
+// CHECK: [[IV:%.+]] = load i64* [[IV_ADDR]]
+// CHECK: omp.inner.for.body:
+// The counter of the inner loop varies fastest.
+// CHECK: [[J_IDX:%.+]] = urem i64 [[IV]], [[M_COUNT:%.+]]
+// CHECK-NEXT: [[I_IDX:%.+]] = udiv i64 [[IV]], [[M_COUNT]]
+// CHECK: store i32 {{%.+}}, i32* [[J_PRIV]]
+// CHECK: store i32 {{%.+}}, i32* [[I_PRIV]]
+// CHECK: store i32 {{%.+}}, i32* [[K_PRIV]]
+// CHECK: store i32 {{%.+}}, i32* [[LAST_PRIV]]
+// CHECK: omp.inner.for.end:
+// CHECK: store i32 {{%.+}}, i32* [[I_PRIV]]
+// CHECK: store i32 {{%.+}}, i32* [[J_PRIV]]
+// CHECK: [[I_LAST:%.+]] = load i32* [[I_PRIV]]
+// CHECK-NEXT: store i32 [[I_LAST]], i32* [[I]]
+// CHECK-NEXT: [[J_LAST:%.+]] = load i32* [[J_PRIV]]
+// CHECK-NEXT: store i32 [[J_LAST]], i32* [[J]]
+// CHECK-NEXT: [[LAST_LAST:%.+]] = load i32* [[LAST_PRIV]]
+// CHECK-NEXT: store i32 [[LAST_LAST]], i32* [[LAST]]
+#pragma omp simd collapse(2) lastprivate(last) private(k)
+  for (i = 0; i < n; ++i)
+    for (j = 0; j < m; ++j) {
+      k = i * m + j;
+      a[k] = 0;
+      last = k;
+    }
+// CHECK: ret i32
+  return i + j + last;
+}
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}aligned{{.*}}(float* {{.*}}%a, i32 {{.*}}%n)
+void aligned(float *a, int n) {
+// 'aligned' does not change the loop.
+// CHECK: omp.inner.for.body:
+// CHECK: store float 0.000000e+00, float* {{.+}}, !llvm.mem.parallel_loop_access
+// CHECK: omp.inner.for.end:
+#pragma omp simd aligned(a : 32)
+  for (int i = 0; i < n; ++i)
+    a[i] = 0;
+// CHECK: ret void
+}
+
+#endif
@@ -0,0 +1,37 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+// CHECK-DAG: [[IDENT_T_TY:%.+]] = type { i32, i32, i32, i32, i8* }
+// CHECK-DAG: [[SINGLE_BARRIER_LOC:@.+]] = private unnamed_addr constant [[IDENT_T_TY]] { i32 0, i32 322, i32 0, i32 0, i8*
+
+void foo(int);
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}single{{.*}}(i32 {{.*}}%n)
+void single(int n) {
+// CHECK: [[GTID:%.+]] = call i32 @__kmpc_global_thread_num([[IDENT_T_TY]]* [[DEFAULT_LOC:@[^,]+]])
+// CHECK: [[RES:%.+]] = call i32 @__kmpc_single([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]])
+// CHECK-NEXT: [[IS_SINGLE:%.+]] = icmp ne i32 [[RES]], 0
+// CHECK-NEXT: br i1 [[IS_SINGLE]], label %[[THEN:.+]], label %[[END:.+]]
+// CHECK: [[THEN]]:
+// CHECK-NEXT: [[N_VAL:%.+]] = load i32* [[N_ADDR:%.+]]
+// CHECK-NEXT: store i32 [[N_VAL]], i32* [[N_PRIV:%.+]]
+// CHECK-NEXT: [[N:%.+]] = load i32* [[N_PRIV]]
+// CHECK-NEXT: call void {{.*}}foo{{.*}}(i32 [[N]])
+// CHECK-NEXT: call void @__kmpc_end_single([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]])
+// CHECK-NEXT: br label %[[END]]
+// CHECK: [[END]]:
+// CHECK-NEXT: call void @__kmpc_barrier([[IDENT_T_TY]]* [[SINGLE_BARRIER_LOC]], i32 [[GTID]])
+#pragma omp single firstprivate(n)
+  foo(n);
+
+// CHECK: call i32 @__kmpc_single(
+// CHECK: call void @__kmpc_end_single(
+// CHECK-NOT: __kmpc_barrier
+// CHECK: ret void
+#pragma omp single nowait
+  foo(2);
+}
+
+#endif
@@ -0,0 +1,68 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm %s -o - | FileCheck %s
+// expected-no-diagnostics
+#ifndef HEADER
+#define HEADER
+
+// CHECK-DAG: [[IDENT_T_TY:%.+]] = type { i32, i32, i32, i32, i8* }
+// CHECK-DAG: [[KMP_TASK_T_TY:%.+]] = type { i8*, i32 (i32, i8*)*, i32 }
+
+void foo(int);
+
+// CHECK-LABEL: define {{.*}}void @{{.*}}tasks{{.*}}(i32 {{.*}}%n)
+void tasks(int n) {
+  int a = 0, b = 0;
+// CHECK: [[GTID:%.+]] = call i32 @__kmpc_global_thread_num([[IDENT_T_TY]]* [[DEFAULT_LOC:@[^,]+]])
+
+// 'n' is firstprivate by default: it is copied into the task, which is tied.
+// CHECK: [[TASK1:%.+]] = call i8* @__kmpc_omp_task_alloc([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i32 1, i64 32, i64 16, i32 (i32, i8*)* [[TASK_ENTRY1:@[^)]+]])
+// CHECK: call void @llvm.memcpy
+// CHECK: [[N_PRIV:%.+]] = getelementptr inbounds { i32 }* {{%.+}}, i32 0, i32 0
+// CHECK: [[N_VAL:%.+]] = load i32* {{%.+}}
+// CHECK-NEXT: store i32 [[N_VAL]], i32* [[N_PRIV]]
+// CHECK: store i32* [[N_PRIV]], i32** {{%.+}}
+// CHECK: call i32 @__kmpc_omp_task([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i8* [[TASK1]])
+#pragma omp task shared(a)
+  a = n;
+
+// CHECK: [[FINAL:%.+]] = select i1 {{%.+}}, i32 2, i32 0
+// CHECK-NEXT: [[FLAGS:%.+]] = or i32 0, [[FINAL]]
+// CHECK: [[TASK2:%.+]] = call i8* @__kmpc_omp_task_alloc([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i32 [[FLAGS]], i64 {{[0-9]+}}, i64 {{[0-9]+}}, i32 (i32, i8*)* [[TASK_ENTRY2:@[^)]+]])
+// CHECK: br i1 {{%.+}}, label %[[IF_THEN:.+]], label %[[IF_ELSE:.+]]
+// CHECK: [[IF_THEN]]:
+// CHECK-NEXT: call i32 @__kmpc_omp_task([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i8* [[TASK2]])
+// CHECK: [[IF_ELSE]]:
+// CHECK-NEXT: call void @__kmpc_omp_task_begin_if0([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i8* [[TASK2]])
+// CHECK-NEXT: call i32 [[TASK_ENTRY2]](i32 [[GTID]], i8* [[TASK2]])
+// CHECK-NEXT: call void @__kmpc_omp_task_complete_if0([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i8* [[TASK2]])
+#pragma omp task untied final(n > 10) if (n) shared(a, b)
+  a += b;
+
+// A task with a constant false 'if' clause is always executed immediately.
+// CHECK: [[TASK3:%.+]] = call i8* @__kmpc_omp_task_alloc([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i32 1, i64 32, i64 8, i32 (i32, i8*)* [[TASK_ENTRY3:@[^)]+]])
+// CHECK-NOT: call i32 @__kmpc_omp_task(
+// CHECK: call void @__kmpc_omp_task_begin_if0([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i8* [[TASK3]])
+// CHECK-NEXT: call i32 [[TASK_ENTRY3]](i32 [[GTID]], i8* [[TASK3]])
+// CHECK-NEXT: call void @__kmpc_omp_task_complete_if0([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i8* [[TASK3]])
+#pragma omp task private(b) if (0)
+  {
+    b = 1;
+    foo(b);
+  }
+
+// CHECK: call i32 @__kmpc_omp_taskwait([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]])
+#pragma omp taskwait
+// CHECK: call i32 @__kmpc_omp_taskyield([[IDENT_T_TY]]* [[DEFAULT_LOC]], i32 [[GTID]], i32 0)
+#pragma omp taskyield
+// CHECK: ret void
+}
+
+// The task entry runs the outlined region with the shareds of the task.
+// CHECK: define internal i32 [[TASK_ENTRY1]](i32, i8*)
+// CHECK: [[TASK_T:%.+]] = bitcast i8* {{%.+}} to [[KMP_TASK_T_TY]]*
+// CHECK-NEXT: [[SHAREDS_REF:%.+]] = getelementptr inbounds [[KMP_TASK_T_TY]]* [[TASK_T]], i32 0, i32 0
+// CHECK-NEXT: [[SHAREDS:%.+]] = load i8** [[SHAREDS_REF]]
+// CHECK-NEXT: [[CTX:%.+]] = bitcast i8* [[SHAREDS]] to %{{.+}}*
+// CHECK-NEXT: call void @__captured_stmt{{.*}}(%{{.+}}* [[CTX]])
+// CHECK: ret i32 0
+
+#endif
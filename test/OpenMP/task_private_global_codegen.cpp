@@ -0,0 +1,27 @@
+// RUN: %clang_cc1 -verify -fopenmp=libiomp5 -x c++ -triple x86_64-unknown-unknown -emit-llvm-only %s
+
+// Variables with global storage are not captured by the task region, so
+// privatizing them is reported instead of leaving them silently shared.
+
+int g;
+
+void shared_global() {
+#pragma omp task shared(g)
+  ++g;
+}
+
+void private_global() {
+#pragma omp task private(g) // expected-error {{cannot compile this private variable with global storage yet}}
+  ++g;
+}
+
+void firstprivate_global() {
+#pragma omp task firstprivate(g) // expected-error {{cannot compile this private variable with global storage yet}}
+  ++g;
+}
+
+void private_static_local() {
+  static int s;
+#pragma omp task private(s) // expected-error {{cannot compile this private variable with global storage yet}}
+  ++s;
+}
@@ -0,0 +1,38 @@
+// Test that the PCHs built for -chain-include headers are cached and reused.
+
+// RUN: rm -rf %t
+// RUN: %clang_cc1 -fsyntax-only -verify %s -chain-include %s -chain-include %s -chain-include-cache-path %t
+// RUN: ls %t | count 2
+// RUN: %clang_cc1 -fsyntax-only -verify %s -chain-include %s -chain-include %s -chain-include-cache-path %t
+// RUN: ls %t | count 2
+
+// Command-line macros are not applied to chained includes, so translation
+// units that differ only in -D options share the cache entries.
+// RUN: %clang_cc1 -fsyntax-only -verify %s -chain-include %s -chain-include %s -chain-include-cache-path %t -DUNRELATED
+// RUN: ls %t | count 2
+
+// Different language options get their own entries.
+// RUN: %clang_cc1 -fsyntax-only -verify %s -chain-include %s -chain-include %s -chain-include-cache-path %t -std=c++11
+// RUN: ls %t | count 4
+
+// expected-no-diagnostics
+
+#ifndef HEADER1
+#define HEADER1
+
+int f(int);
+struct S { int x; };
+
+#elif !defined(HEADER2)
+#define HEADER2
+
+inline int g(S s) { return f(s.x); }
+
+#else
+
+int h() {
+  S s = { 1 };
+  return g(s);
+}
+
+#endif
@@ -0,0 +1,31 @@
+// Test that buffers embedded in a PCH can be stored compressed and are
+// restored when they are needed for diagnostics.
+
+// REQUIRES: zlib
+
+// RUN: %clang_cc1 -emit-pch -fcompress-ast-file-buffers \
+// RUN:   -DBAD_CONVERSION='(int *)1.0' -o %t %s
+// RUN: llvm-bcanalyzer -dump %t | FileCheck --check-prefix=COMPRESSED %s
+// RUN: not %clang_cc1 -include-pch %t -DBAD_CONVERSION='(int *)1.0' \
+// RUN:   -fsyntax-only %s 2>&1 | FileCheck %s
+//
+// Without the flag, the buffers are stored uncompressed.
+// RUN: %clang_cc1 -emit-pch -DBAD_CONVERSION='(int *)1.0' -o %t.plain %s
+// RUN: llvm-bcanalyzer -dump %t.plain | FileCheck --check-prefix=PLAIN %s
+
+// COMPRESSED: <SM_SLOC_BUFFER_BLOB_COMPRESSED
+// PLAIN-NOT: <SM_SLOC_BUFFER_BLOB_COMPRESSED
+
+#ifndef HEADER
+#define HEADER
+
+int *first = 0;
+
+#else
+
+int *p = BAD_CONVERSION;
+// CHECK: error: {{.*}}
+// CHECK: note: expanded from macro 'BAD_CONVERSION'
+// CHECK-NEXT: #define BAD_CONVERSION (int *)1.0
+
+#endif
@@ -0,0 +1,28 @@
+// Test that -fpch-instantiate-templates performs the pending instantiations
+// when building the PCH, so that users of the PCH don't redo them.
+
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -x c++-header -emit-pch -o %t.pch %s
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -include-pch %t.pch -fsyntax-only -print-template-instantiation-profile %s 2>&1 | FileCheck %s --check-prefix=DEFAULT
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -include-pch %t.pch -emit-llvm -o - %s | FileCheck %s
+
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -x c++-header -emit-pch -fpch-instantiate-templates -o %t.inst.pch %s
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -include-pch %t.inst.pch -fsyntax-only -print-template-instantiation-profile %s 2>&1 | FileCheck %s --check-prefix=INSTANTIATED
+// RUN: %clang_cc1 -triple x86_64-unknown-unknown -include-pch %t.inst.pch -emit-llvm -o - %s | FileCheck %s
+
+#ifndef HEADER
+#define HEADER
+
+template<typename T> T add(T a, T b) { return a + b; }
+
+inline int use() { return add(1, 2); }
+
+#else
+
+int main() { return use(); }
+
+// DEFAULT: 1 template instantiations of 1 entities.
+// INSTANTIATED: 0 template instantiations of 0 entities.
+
+// CHECK: define linkonce_odr i32 @_Z3addIiET_S0_S0_(
+
+#endif
@@ -0,0 +1,11 @@
+// RUN: %clang_cc1 -fsyntax-only -std=c++11 -lazy-function-bodies -Wmissing-prototypes -verify %s
+
+// The definition is checked, but its body is only kept as tokens.
+int f(int x) { return undeclared(x); } // expected-warning {{no previous prototype for function 'f'}}
+
+struct S {
+  int get() { return undeclared(); }
+};
+
+// The bodies of constexpr functions are always parsed.
+constexpr int square(int x) { return x * undeclared; } // expected-error {{use of undeclared identifier 'undeclared'}}
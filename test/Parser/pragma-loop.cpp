@@ -37,6 +37,18 @@ void test(int *List, int Length) {
     List[i] = i;
   }
 
+#pragma clang loop vectorize_predicate(enable) distribute(enable)
+#pragma clang loop unroll_and_jam(enable) pipeline(disable)
+  while (i - 3 < Length) {
+    List[i] = i;
+  }
+
+#pragma clang loop vectorize_predicate(disable) distribute(disable)
+#pragma clang loop unroll_and_jam_count(4) pipeline_initiation_interval(10)
+  while (i - 3 < Length) {
+    List[i] = i;
+  }
+
   int VList[Length];
 #pragma clang loop vectorize(disable) interleave(disable) unroll(disable)
   for (int j : VList) {
@@ -72,6 +84,8 @@ void test(int *List, int Length) {
 /* expected-error {{invalid argument; expected a positive integer value}} */ #pragma clang loop vectorize_width(0)
 /* expected-error {{invalid argument; expected a positive integer value}} */ #pragma clang loop interleave_count(0)
 /* expected-error {{invalid argument; expected a positive integer value}} */ #pragma clang loop unroll_count(0)
+/* expected-error {{invalid argument; expected a positive integer value}} */ #pragma clang loop unroll_and_jam_count(0)
+/* expected-error {{invalid argument; expected a positive integer value}} */ #pragma clang loop pipeline_initiation_interval(0)
   while (i-5 < Length) {
     List[i] = i;
   }
@@ -96,6 +110,9 @@ void test(int *List, int Length) {
 /* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop vectorize(badidentifier)
 /* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop interleave(badidentifier)
 /* expected-error {{invalid argument; expected 'full' or 'disable'}} */ #pragma clang loop unroll(badidentifier)
+/* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop distribute(full)
+/* expected-error {{invalid argument; expected 'enable' or 'disable'}} */ #pragma clang loop unroll_and_jam(badidentifier)
+/* expected-error {{invalid argument; expected 'disable'}} */ #pragma clang loop pipeline(enable)
   while (i-7 < Length) {
     List[i] = i;
   }
@@ -131,6 +148,10 @@ void test(int *List, int Length) {
 #pragma clang loop interleave(disable)
 /* expected-error {{incompatible directives 'unroll(disable)' and 'unroll_count(4)'}} */ #pragma clang loop unroll_count(4)
 #pragma clang loop unroll(disable)
+/* expected-error {{incompatible directives 'unroll_and_jam(disable)' and 'unroll_and_jam_count(4)'}} */ #pragma clang loop unroll_and_jam_count(4)
+#pragma clang loop unroll_and_jam(disable)
+/* expected-error {{incompatible directives 'pipeline(disable)' and 'pipeline_initiation_interval(4)'}} */ #pragma clang loop pipeline_initiation_interval(4)
+#pragma clang loop pipeline(disable)
   while (i-8 < Length) {
     List[i] = i;
   }
@@ -141,6 +162,8 @@ void test(int *List, int Length) {
 #pragma clang loop interleave(disable)
 /* expected-error {{duplicate directives 'unroll(disable)' and 'unroll(full)'}} */ #pragma clang loop unroll(full)
 #pragma clang loop unroll(disable)
+/* expected-error {{duplicate directives 'distribute(disable)' and 'distribute(enable)'}} */ #pragma clang loop distribute(enable)
+#pragma clang loop distribute(disable)
   while (i-9 < Length) {
     List[i] = i;
   }
@@ -0,0 +1,29 @@
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -std=c++11 -fsyntax-only -DSTATS -print-stats %s 2>&1 \
+// RUN:   | FileCheck %s
+
+// Without memoization, this takes far more steps than the default limit.
+constexpr unsigned long long fib(unsigned n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+static_assert(fib(90) == 2880067194370816120ull, "");
+static_assert(fib(89) + fib(88) == fib(90), "");
+
+constexpr double halve(double d, int n) {
+  return n == 0 ? d : halve(d / 2, n - 1);
+}
+static_assert(halve(-0.0, 3) == 0.0, "");
+static_assert(halve(64.0, 3) == 8.0, "");
+
+#ifndef STATS
+// Failed evaluations are not memoized, so each one is diagnosed.
+constexpr int divide(int n) {
+  return 10 / n; // expected-note 2{{division by zero}}
+}
+static_assert(divide(0), ""); // expected-error {{constant expression}} \
+                              // expected-note {{in call to 'divide(0)'}}
+static_assert(divide(0), ""); // expected-error {{constant expression}} \
+                              // expected-note {{in call to 'divide(0)'}}
+#endif
+
+// CHECK: {{[1-9][0-9]*}} memoized constexpr call results, {{[1-9][0-9]*}} reused
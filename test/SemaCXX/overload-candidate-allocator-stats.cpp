@@ -0,0 +1,17 @@
+// RUN: %clang_cc1 -fsyntax-only -print-stats %s 2>&1 | FileCheck %s
+
+// Candidate sets whose conversion sequences don't fit in their inline storage
+// share the allocators lent to them by Sema.
+
+void f(int, int, int, int, int, int, int, int, int, int);
+void f(long, long, long, long, long, long, long, long, long, long);
+
+void g() {
+  f(0, 1, 2, 3, 4, 5, 6, 7, 8, 9);
+  f(0L, 1L, 2L, 3L, 4L, 5L, 6L, 7L, 8L, 9L);
+  f(0, 1, 2, 3, 4, 5, 6, 7, 8, 9);
+}
+
+// CHECK: *** Semantic Analysis Stats:
+// CHECK: 3 overload resolutions considered 6 candidates.
+// CHECK: 3 candidate sets needed out-of-line conversion storage, served by 1 allocators.
@@ -0,0 +1,12 @@
+// RUN: %clang_cc1 -fsyntax-only -verify -fspell-checking-candidate-budget=1 %s
+
+// Once the budget is exhausted, the search stops before the known namespaces
+// are searched, so 'ns::counterValue' is not suggested. The candidate budget
+// stands in for the time budget, which cannot be exhausted deterministically.
+namespace ns {
+  int counterValue;
+}
+
+int g() {
+  return counterValeu; // expected-error {{use of undeclared identifier 'counterValeu'}}
+}
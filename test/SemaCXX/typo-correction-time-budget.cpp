@@ -0,0 +1,16 @@
+// RUN: %clang_cc1 -fsyntax-only -verify %s
+// RUN: %clang_cc1 -fsyntax-only -verify -fspell-checking-time-budget=10000 %s
+
+namespace ns {
+  int counterValue; // expected-note {{'ns::counterValue' declared here}}
+}
+
+int totalCount; // expected-note {{'totalCount' declared here}}
+
+int f() {
+  return totalCoutn; // expected-error {{use of undeclared identifier 'totalCoutn'; did you mean 'totalCount'?}}
+}
+
+int g() {
+  return counterValeu; // expected-error {{use of undeclared identifier 'counterValeu'; did you mean 'ns::counterValue'?}}
+}
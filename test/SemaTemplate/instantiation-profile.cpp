@@ -0,0 +1,23 @@
+// RUN: %clang_cc1 -fsyntax-only -print-template-instantiation-profile %s 2>&1 | FileCheck %s
+
+template<unsigned N> struct Fib {
+  static const unsigned value = Fib<N - 1>::value + Fib<N - 2>::value;
+};
+template<> struct Fib<1> { static const unsigned value = 1; };
+template<> struct Fib<0> { static const unsigned value = 0; };
+
+template<typename T> T twice(T t) { return t + t; }
+
+unsigned f() { return twice(Fib<4>::value); }
+
+// CHECK: *** Template Instantiation Profile:
+// CHECK: template instantiations of {{[0-9]+}} entities.
+// CHECK: Most expensive instantiations:
+// CHECK: Total(s) Self(s) Count Nested AST bytes Entity
+// CHECK-DAG: {{[0-9.]+ +[0-9.]+ +1 +[0-9]+ +[0-9]+}} Fib<4>
+// CHECK-DAG: {{[0-9.]+ +[0-9.]+ +1 +0 +[0-9]+}} Fib<2>
+// CHECK-DAG: {{[0-9.]+ +[0-9.]+ +1 +[0-9]+ +[0-9]+}} twice<unsigned int>
+// CHECK: Most expensive templates:
+// CHECK: Self(s) Count Entities AST bytes Template
+// CHECK-DAG: {{[0-9.]+ +3 +3 +[0-9]+}} Fib
+// CHECK-DAG: {{[0-9.]+ +1 +1 +[0-9]+}} twice
@@ -14,6 +14,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Option/Arg.h"
+#include "clang/Basic/TimeTrace.h"
 #include "clang/Driver/DriverDiagnostic.h"
 #include "clang/Driver/Options.h"
 #include "clang/Frontend/CompilerInstance.h"
@@ -28,6 +29,7 @@
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/OptTable.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/TargetSelect.h"
@@ -106,8 +108,33 @@ int cc1_main(ArrayRef<const char *> Argv, const char *Argv0, void *MainAddr) {
   if (!Success)
     return 1;
 
+  // Record where the time of the compilation goes, if requested.
+  const FrontendOptions &FrontendOpts = Clang->getFrontendOpts();
+  std::unique_ptr<TimeTraceProfiler> Profiler;
+  if (!FrontendOpts.TimeTraceFile.empty()) {
+    Profiler.reset(new TimeTraceProfiler(FrontendOpts.TimeTraceGranularity));
+    TimeTraceProfiler::setCurrent(Profiler.get());
+  }
+
   // Execute the frontend actions.
-  Success = ExecuteCompilerInvocation(Clang.get());
+  {
+    TimeTraceScope Scope("ExecuteCompiler");
+    Success = ExecuteCompilerInvocation(Clang.get());
+  }
+
+  if (Profiler) {
+    TimeTraceProfiler::setCurrent(nullptr);
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(FrontendOpts.TimeTraceFile, EC,
+                            llvm::sys::fs::F_Text);
+    if (EC) {
+      Clang->getDiagnostics().Report(diag::err_fe_unable_to_open_output)
+          << FrontendOpts.TimeTraceFile << EC.message();
+      Success = false;
+    } else {
+      Profiler->write(OS);
+    }
+  }
 
   // If any timers were active but haven't been destroyed yet, print their
   // results now.  This happens in -disable-free mode.
@@ -0,0 +1,240 @@
+//=== unittests/Sema/LazyFunctionBodiesTest.cpp - Lazy function body tests ===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/DeclCXX.h"
+#include "clang/Frontend/ASTUnit.h"
+#include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/FrontendAction.h"
+#include "clang/Parse/ParseAST.h"
+#include "clang/Sema/Sema.h"
+#include "clang/Sema/SemaConsumer.h"
+#include "clang/Tooling/Tooling.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+
+using namespace clang;
+using namespace clang::tooling;
+
+namespace {
+
+// \brief The names of the functions whose bodies were skipped, and of those
+// whose bodies were then parsed on demand.
+struct LazyBodyResults {
+  std::vector<std::string> Skipped;
+  std::vector<std::string> Parsed;
+  unsigned WarningsWhileParsing;
+
+  LazyBodyResults() : WarningsWhileParsing(0) {}
+};
+
+// \brief Collects the functions whose bodies were skipped and, at the end of
+// the translation unit, parses the bodies of those whose name is in
+// BodiesToParse.
+class LazyBodyConsumer : public SemaConsumer {
+  Sema *CurrentSema;
+  std::vector<std::string> BodiesToParse;
+  LazyBodyResults &Results;
+
+  void collectSkippedFunctions(DeclContext *DC) {
+    for (DeclContext::decl_iterator I = DC->decls_begin(),
+                                    E = DC->decls_end();
+         I != E; ++I) {
+      if (FunctionDecl *FD = dyn_cast<FunctionDecl>(*I)) {
+        if (FD->hasLazyBody())
+          Results.Skipped.push_back(FD->getQualifiedNameAsString());
+      } else if (CXXRecordDecl *RD = dyn_cast<CXXRecordDecl>(*I)) {
+        collectSkippedFunctions(RD);
+      }
+    }
+  }
+
+  void parseRequestedBodies(DeclContext *DC) {
+    for (DeclContext::decl_iterator I = DC->decls_begin(),
+                                    E = DC->decls_end();
+         I != E; ++I) {
+      if (FunctionDecl *FD = dyn_cast<FunctionDecl>(*I)) {
+        std::string Name = FD->getQualifiedNameAsString();
+        if (!FD->hasLazyBody() ||
+            std::find(BodiesToParse.begin(), BodiesToParse.end(), Name) ==
+                BodiesToParse.end())
+          continue;
+        EXPECT_TRUE(FD->hasBody()) << Name;
+        DiagnosticsEngine &Diags = CurrentSema->getDiagnostics();
+        unsigned NumWarnings = Diags.getNumWarnings();
+        if (FD->getBody())
+          Results.Parsed.push_back(Name);
+        Results.WarningsWhileParsing += Diags.getNumWarnings() - NumWarnings;
+        EXPECT_FALSE(FD->hasLazyBody()) << Name;
+        EXPECT_TRUE(FD->hasBody()) << Name;
+      } else if (CXXRecordDecl *RD = dyn_cast<CXXRecordDecl>(*I)) {
+        parseRequestedBodies(RD);
+      }
+    }
+  }
+
+public:
+  LazyBodyConsumer(const std::vector<std::string> &BodiesToParse,
+                   LazyBodyResults &Results)
+      : CurrentSema(nullptr), BodiesToParse(BodiesToParse), Results(Results) {}
+
+  virtual void InitializeSema(Sema &S) { CurrentSema = &S; }
+
+  virtual void ForgetSema() { CurrentSema = nullptr; }
+
+  virtual void HandleTranslationUnit(ASTContext &Context) {
+    ASSERT_TRUE(CurrentSema != nullptr);
+    collectSkippedFunctions(Context.getTranslationUnitDecl());
+    parseRequestedBodies(Context.getTranslationUnitDecl());
+  }
+};
+
+// \brief Parses the input with lazily-skipped function bodies.
+class LazyBodyAction : public ASTFrontendAction {
+  std::vector<std::string> BodiesToParse;
+  LazyBodyResults &Results;
+
+protected:
+  virtual std::unique_ptr<ASTConsumer>
+  CreateASTConsumer(CompilerInstance &Compiler, llvm::StringRef /* dummy */) {
+    return std::unique_ptr<ASTConsumer>(
+        new LazyBodyConsumer(BodiesToParse, Results));
+  }
+
+  virtual void ExecuteAction() {
+    CompilerInstance &CI = getCompilerInstance();
+    ASSERT_FALSE(CI.hasSema());
+    CI.createSema(getTranslationUnitKind(), nullptr);
+    ParseAST(CI.getSema(), /*PrintStats=*/false, /*SkipFunctionBodies=*/true,
+             /*LazyFunctionBodies=*/true);
+  }
+
+public:
+  LazyBodyAction(const std::vector<std::string> &BodiesToParse,
+                 LazyBodyResults &Results)
+      : BodiesToParse(BodiesToParse), Results(Results) {}
+};
+
+const char *const LazyBodiesCode =
+    "int helper(int x) { return x + 1; }\n"
+    "struct S {\n"
+    "  int get() { return helper(Value); }\n"
+    "  int out();\n"
+    "  int Value;\n"
+    "};\n"
+    "int S::out() { return get() * 2; }\n"
+    "template <typename T> T id(T t) { return t; }\n"
+    "constexpr int square(int x) { return x * x; }\n";
+
+TEST(LazyFunctionBodies, BodiesAreSkipped) {
+  LazyBodyResults Results;
+  std::vector<std::string> Args(1, "-std=c++11");
+  ASSERT_TRUE(runToolOnCodeWithArgs(
+      new LazyBodyAction(std::vector<std::string>(), Results), LazyBodiesCode,
+      Args));
+  // Templates and constexpr functions are never skipped.
+  ASSERT_EQ(3u, Results.Skipped.size());
+  EXPECT_EQ("helper", Results.Skipped[0]);
+  EXPECT_EQ("S::get", Results.Skipped[1]);
+  EXPECT_EQ("S::out", Results.Skipped[2]);
+  EXPECT_TRUE(Results.Parsed.empty());
+}
+
+TEST(LazyFunctionBodies, BodiesParsedOnDemand) {
+  LazyBodyResults Results;
+  std::vector<std::string> BodiesToParse;
+  BodiesToParse.push_back("S::get");
+  BodiesToParse.push_back("S::out");
+  std::vector<std::string> Args(1, "-std=c++11");
+  ASSERT_TRUE(runToolOnCodeWithArgs(
+      new LazyBodyAction(BodiesToParse, Results), LazyBodiesCode, Args));
+  ASSERT_EQ(2u, Results.Parsed.size());
+  EXPECT_EQ("S::get", Results.Parsed[0]);
+  EXPECT_EQ("S::out", Results.Parsed[1]);
+}
+
+TEST(LazyFunctionBodies, ErrorsReportedWhenParsed) {
+  LazyBodyResults Results;
+  std::vector<std::string> Args(1, "-std=c++11");
+  // The body is never parsed, so the error in it goes unnoticed.
+  EXPECT_TRUE(runToolOnCodeWithArgs(
+      new LazyBodyAction(std::vector<std::string>(), Results),
+      "void f() { undeclared(); }", Args));
+
+  std::vector<std::string> BodiesToParse(1, "f");
+  EXPECT_FALSE(runToolOnCodeWithArgs(
+      new LazyBodyAction(BodiesToParse, Results),
+      "void f() { undeclared(); }", Args));
+}
+
+TEST(LazyFunctionBodies, DefinitionNotCheckedAgain) {
+  LazyBodyResults Results;
+  std::vector<std::string> Args;
+  Args.push_back("-std=c++11");
+  Args.push_back("-Wmissing-prototypes");
+  Args.push_back("-Wshadow");
+  // Both warnings are about the definition, which was checked when its body
+  // was skipped.
+  std::vector<std::string> BodiesToParse(1, "f");
+  ASSERT_TRUE(runToolOnCodeWithArgs(
+      new LazyBodyAction(BodiesToParse, Results),
+      "int x; int f(int x) { return x; }", Args));
+  ASSERT_EQ(1u, Results.Parsed.size());
+  EXPECT_EQ(0u, Results.WarningsWhileParsing);
+}
+
+FunctionDecl *findFunction(ASTContext &Context, StringRef Name) {
+  DeclContext::lookup_result R =
+      Context.getTranslationUnitDecl()->lookup(&Context.Idents.get(Name));
+  return R.empty() ? nullptr : dyn_cast<FunctionDecl>(R.front());
+}
+
+TEST(LazyFunctionBodies, BodiesParsedAfterParsing) {
+  std::vector<std::string> Args;
+  Args.push_back("-std=c++11");
+  Args.push_back("-Wunused-function");
+  Args.push_back("-Xclang");
+  Args.push_back("-lazy-function-bodies");
+  // 'used' is only called from the body of 'f', which is not parsed yet, so
+  // no function can be diagnosed as unused yet.
+  std::unique_ptr<ASTUnit> AST(buildASTFromCodeWithArgs(
+      "static int used() { return 0; }\n"
+      "static int unused() { return 1; }\n"
+      "int f() { return used(); }\n",
+      Args));
+  ASSERT_TRUE(AST.get());
+  EXPECT_EQ(0u, AST->getDiagnostics().getNumWarnings());
+
+  FunctionDecl *FD = findFunction(AST->getASTContext(), "f");
+  ASSERT_TRUE(FD != nullptr);
+  EXPECT_TRUE(FD->hasLazyBody());
+  EXPECT_TRUE(FD->hasBody());
+
+  // The parser is still around to parse the body when it is asked for, and
+  // the body is parsed only once.
+  Stmt *Body = FD->getBody();
+  ASSERT_TRUE(Body != nullptr);
+  EXPECT_TRUE(isa<CompoundStmt>(Body));
+  EXPECT_FALSE(FD->hasLazyBody());
+  EXPECT_EQ(Body, FD->getBody());
+
+  FunctionDecl *Used = findFunction(AST->getASTContext(), "used");
+  ASSERT_TRUE(Used != nullptr);
+  EXPECT_TRUE(Used->isUsed());
+  EXPECT_EQ(0u, AST->getDiagnostics().getNumWarnings());
+
+  // Once the last body is parsed, only 'unused' is diagnosed.
+  FunctionDecl *Unused = findFunction(AST->getASTContext(), "unused");
+  ASSERT_TRUE(Unused != nullptr);
+  EXPECT_TRUE(Used->getBody() != nullptr);
+  EXPECT_TRUE(Unused->getBody() != nullptr);
+  EXPECT_EQ(1u, AST->getDiagnostics().getNumWarnings());
+}
+
+} // anonymous namespace